@@ -0,0 +1,430 @@
+// BridgeIntegrity.cpp
+// XXH64 and the exchange-file footer. See BridgeIntegrity.h for the format.
+
+#include "BridgeIntegrity.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+    constexpr uint64 Prime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64 Prime3 = 0x165667B19E3779F9ULL;
+    constexpr uint64 Prime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64 Prime5 = 0x27D4EB2F165667C5ULL;
+
+    constexpr ANSICHAR FooterPrefix[] = "#bridge_integrity ";
+    constexpr int32 FooterPrefixLen = UE_ARRAY_COUNT(FooterPrefix) - 1;
+
+    /** Footer lines are short; don't scan further back than this for the start of one */
+    constexpr int32 MaxFooterLen = 96;
+
+    FORCEINLINE uint64 Rotl64(uint64 X, int32 R)
+    {
+        return (X << R) | (X >> (64 - R));
+    }
+
+    FORCEINLINE uint64 Read64(const uint8* P)
+    {
+        uint64 Value;
+        FMemory::Memcpy(&Value, P, sizeof(Value));
+        return INTEL_ORDER64(Value);
+    }
+
+    FORCEINLINE uint32 Read32(const uint8* P)
+    {
+        uint32 Value;
+        FMemory::Memcpy(&Value, P, sizeof(Value));
+        return INTEL_ORDER32(Value);
+    }
+
+    FORCEINLINE uint64 Round(uint64 Acc, uint64 Input)
+    {
+        Acc += Input * Prime2;
+        Acc = Rotl64(Acc, 31);
+        return Acc * Prime1;
+    }
+
+    FORCEINLINE uint64 MergeRound(uint64 Acc, uint64 Value)
+    {
+        Acc ^= Round(0, Value);
+        return Acc * Prime1 + Prime4;
+    }
+
+    bool ParseHex64(const uint8* Begin, const uint8* End, uint64& OutValue)
+    {
+        if (End - Begin != 16)
+        {
+            return false;
+        }
+        uint64 Value = 0;
+        for (const uint8* P = Begin; P < End; ++P)
+        {
+            const uint8 C = *P;
+            uint64 Digit;
+            if (C >= '0' && C <= '9')      { Digit = C - '0'; }
+            else if (C >= 'a' && C <= 'f') { Digit = C - 'a' + 10; }
+            else if (C >= 'A' && C <= 'F') { Digit = C - 'A' + 10; }
+            else { return false; }
+            Value = (Value << 4) | Digit;
+        }
+        OutValue = Value;
+        return true;
+    }
+
+    bool ParseDecimal(const uint8* Begin, const uint8* End, uint64& OutValue)
+    {
+        if (Begin == End || End - Begin > 19)
+        {
+            return false;
+        }
+        uint64 Value = 0;
+        for (const uint8* P = Begin; P < End; ++P)
+        {
+            if (*P < '0' || *P > '9')
+            {
+                return false;
+            }
+            Value = Value * 10 + (*P - '0');
+        }
+        OutValue = Value;
+        return true;
+    }
+
+    /** Footer fields parsed from the last line of a file */
+    struct FFooter
+    {
+        int32 Start = INDEX_NONE;   // Byte offset of the footer line (= payload size)
+        uint64 Hash = 0;
+        uint64 Size = 0;
+        bool bWellFormed = false;   // Prefix found and both fields parsed
+    };
+
+    /** Locate the footer line at the end of Data. Start stays INDEX_NONE if the last line isn't one. */
+    FFooter FindFooter(const uint8* Data, int32 Num)
+    {
+        FFooter Footer;
+
+        // Ignore trailing line endings, then walk back to the start of the last line
+        int32 LineEnd = Num;
+        while (LineEnd > 0 && (Data[LineEnd - 1] == '\n' || Data[LineEnd - 1] == '\r'))
+        {
+            --LineEnd;
+        }
+        int32 LineStart = LineEnd;
+        while (LineStart > 0 && Data[LineStart - 1] != '\n' && LineEnd - LineStart < MaxFooterLen)
+        {
+            --LineStart;
+        }
+        if (LineStart > 0 && Data[LineStart - 1] != '\n')
+        {
+            return Footer;
+        }
+        if (LineEnd - LineStart < FooterPrefixLen
+            || FMemory::Memcmp(Data + LineStart, FooterPrefix, FooterPrefixLen) != 0)
+        {
+            return Footer;
+        }
+
+        Footer.Start = LineStart;
+
+        // "xxh64=<hex> size=<dec>"
+        const uint8* P = Data + LineStart + FooterPrefixLen;
+        const uint8* End = Data + LineEnd;
+        bool bHaveHash = false;
+        bool bHaveSize = false;
+        while (P < End)
+        {
+            while (P < End && *P == ' ')
+            {
+                ++P;
+            }
+            const uint8* TokenEnd = P;
+            while (TokenEnd < End && *TokenEnd != ' ')
+            {
+                ++TokenEnd;
+            }
+            const uint8* Eq = P;
+            while (Eq < TokenEnd && *Eq != '=')
+            {
+                ++Eq;
+            }
+            if (Eq < TokenEnd)
+            {
+                const int32 KeyLen = static_cast<int32>(Eq - P);
+                if (KeyLen == 5 && FMemory::Memcmp(P, "xxh64", 5) == 0)
+                {
+                    bHaveHash = ParseHex64(Eq + 1, TokenEnd, Footer.Hash);
+                }
+                else if (KeyLen == 4 && FMemory::Memcmp(P, "size", 4) == 0)
+                {
+                    bHaveSize = ParseDecimal(Eq + 1, TokenEnd, Footer.Size);
+                }
+            }
+            P = TokenEnd;
+        }
+
+        Footer.bWellFormed = bHaveHash && bHaveSize;
+        return Footer;
+    }
+
+    FString BytesToString(const uint8* Data, int32 Num)
+    {
+        FString Result;
+        FFileHelper::BufferToString(Result, Data, Num);
+        return Result;
+    }
+}
+
+
+// === XXH64 ===
+
+FBridgeXxHash64::FBridgeXxHash64(uint64 InSeed)
+    : Seed(InSeed)
+{
+    Reset();
+}
+
+
+void FBridgeXxHash64::Reset()
+{
+    Lanes[0] = Seed + Prime1 + Prime2;
+    Lanes[1] = Seed + Prime2;
+    Lanes[2] = Seed;
+    Lanes[3] = Seed - Prime1;
+    BufferSize = 0;
+    TotalLength = 0;
+}
+
+
+void FBridgeXxHash64::ConsumeStripe(const uint8* Stripe)
+{
+    Lanes[0] = Round(Lanes[0], Read64(Stripe));
+    Lanes[1] = Round(Lanes[1], Read64(Stripe + 8));
+    Lanes[2] = Round(Lanes[2], Read64(Stripe + 16));
+    Lanes[3] = Round(Lanes[3], Read64(Stripe + 24));
+}
+
+
+void FBridgeXxHash64::Update(const void* Data, uint64 Size)
+{
+    const uint8* P = static_cast<const uint8*>(Data);
+    const uint8* const End = P + Size;
+    TotalLength += Size;
+
+    if (BufferSize + Size < sizeof(Buffer))
+    {
+        FMemory::Memcpy(Buffer + BufferSize, P, Size);
+        BufferSize += static_cast<uint32>(Size);
+        return;
+    }
+
+    // Complete a stripe left over from the previous call
+    if (BufferSize > 0)
+    {
+        const uint32 Fill = sizeof(Buffer) - BufferSize;
+        FMemory::Memcpy(Buffer + BufferSize, P, Fill);
+        ConsumeStripe(Buffer);
+        P += Fill;
+        BufferSize = 0;
+    }
+
+    while (End - P >= static_cast<int64>(sizeof(Buffer)))
+    {
+        ConsumeStripe(P);
+        P += sizeof(Buffer);
+    }
+
+    if (P < End)
+    {
+        BufferSize = static_cast<uint32>(End - P);
+        FMemory::Memcpy(Buffer, P, BufferSize);
+    }
+}
+
+
+uint64 FBridgeXxHash64::Finalize() const
+{
+    uint64 Hash;
+    if (TotalLength >= sizeof(Buffer))
+    {
+        Hash = Rotl64(Lanes[0], 1) + Rotl64(Lanes[1], 7) + Rotl64(Lanes[2], 12) + Rotl64(Lanes[3], 18);
+        Hash = MergeRound(Hash, Lanes[0]);
+        Hash = MergeRound(Hash, Lanes[1]);
+        Hash = MergeRound(Hash, Lanes[2]);
+        Hash = MergeRound(Hash, Lanes[3]);
+    }
+    else
+    {
+        Hash = Seed + Prime5;
+    }
+
+    Hash += TotalLength;
+
+    const uint8* P = Buffer;
+    const uint8* const End = Buffer + BufferSize;
+    while (End - P >= 8)
+    {
+        Hash ^= Round(0, Read64(P));
+        Hash = Rotl64(Hash, 27) * Prime1 + Prime4;
+        P += 8;
+    }
+    if (End - P >= 4)
+    {
+        Hash ^= static_cast<uint64>(Read32(P)) * Prime1;
+        Hash = Rotl64(Hash, 23) * Prime2 + Prime3;
+        P += 4;
+    }
+    while (P < End)
+    {
+        Hash ^= static_cast<uint64>(*P) * Prime5;
+        Hash = Rotl64(Hash, 11) * Prime1;
+        ++P;
+    }
+
+    // Avalanche
+    Hash ^= Hash >> 33;
+    Hash *= Prime2;
+    Hash ^= Hash >> 29;
+    Hash *= Prime3;
+    Hash ^= Hash >> 32;
+    return Hash;
+}
+
+
+uint64 FBridgeXxHash64::HashBuffer(const void* Data, uint64 Size, uint64 Seed)
+{
+    FBridgeXxHash64 Hasher(Seed);
+    Hasher.Update(Data, Size);
+    return Hasher.Finalize();
+}
+
+
+// === FOOTER ===
+
+EBridgeReadResult FBridgeIntegrity::ReadVerified(const FString& Path, FBridgeVerifiedFile& OutFile, bool bRequireFooter)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return EBridgeReadResult::Missing;
+    }
+
+    const FFooter Footer = FindFooter(Bytes.GetData(), Bytes.Num());
+    if (Footer.Start == INDEX_NONE)
+    {
+        // No footer: either a legacy writer, or the tail hasn't landed yet
+        if (bRequireFooter)
+        {
+            return EBridgeReadResult::Torn;
+        }
+        OutFile.Hash = FBridgeXxHash64::HashBuffer(Bytes.GetData(), Bytes.Num());
+        OutFile.Content = BytesToString(Bytes.GetData(), Bytes.Num());
+        OutFile.bHadFooter = false;
+        return EBridgeReadResult::Ok;
+    }
+
+    // Size check first: a torn file almost always fails it without hashing anything
+    if (!Footer.bWellFormed || Footer.Size != static_cast<uint64>(Footer.Start))
+    {
+        return EBridgeReadResult::Torn;
+    }
+
+    const uint64 Hash = FBridgeXxHash64::HashBuffer(Bytes.GetData(), Footer.Start);
+    if (Hash != Footer.Hash)
+    {
+        return EBridgeReadResult::Torn;
+    }
+
+    OutFile.Hash = Hash;
+    OutFile.Content = BytesToString(Bytes.GetData(), Footer.Start);
+    OutFile.bHadFooter = true;
+    return EBridgeReadResult::Ok;
+}
+
+
+EBridgeReadResult FBridgeIntegrity::ReadUnverified(const FString& Path, FBridgeVerifiedFile& OutFile)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return EBridgeReadResult::Missing;
+    }
+
+    const FFooter Footer = FindFooter(Bytes.GetData(), Bytes.Num());
+    const int32 PayloadSize = Footer.Start != INDEX_NONE ? Footer.Start : Bytes.Num();
+
+    OutFile.Hash = FBridgeXxHash64::HashBuffer(Bytes.GetData(), PayloadSize);
+    OutFile.Content = BytesToString(Bytes.GetData(), PayloadSize);
+    OutFile.bHadFooter = Footer.Start != INDEX_NONE;
+    return EBridgeReadResult::Ok;
+}
+
+
+FString FBridgeIntegrity::Seal(const FString& Content, uint64* OutHash)
+{
+    FTCHARToUTF8 Utf8(*Content);
+    const uint8* Data = reinterpret_cast<const uint8*>(Utf8.Get());
+    int32 PayloadSize = Utf8.Length();
+
+    const FFooter Existing = FindFooter(Data, PayloadSize);
+    if (Existing.Start != INDEX_NONE)
+    {
+        PayloadSize = Existing.Start;
+    }
+
+    // The footer must start its own line; hash exactly what will be on disk
+    TArray<uint8> Payload;
+    Payload.Reserve(PayloadSize + 1);
+    Payload.Append(Data, PayloadSize);
+    if (PayloadSize > 0 && Data[PayloadSize - 1] != '\n')
+    {
+        Payload.Add('\n');
+    }
+
+    const uint64 Hash = FBridgeXxHash64::HashBuffer(Payload.GetData(), Payload.Num());
+    if (OutHash)
+    {
+        *OutHash = Hash;
+    }
+
+    FString Sealed = BytesToString(Payload.GetData(), Payload.Num());
+    Sealed += FString::Printf(TEXT("%hsxxh64=%016llx size=%d\n"), FooterPrefix, Hash, Payload.Num());
+    return Sealed;
+}
+
+
+bool FBridgeIntegrity::SaveSealed(const FString& Content, const FString& Path, uint64* OutHash)
+{
+    return FFileHelper::SaveStringToFile(Seal(Content, OutHash), *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+
+// === PROFILE CHECKSUM ===
+
+FString FBridgeIntegrity::ComputeProfileChecksum(const TMap<FString, FString>& RawDimensionValues)
+{
+    TArray<FString> Keys;
+    RawDimensionValues.GetKeys(Keys);
+    // Python sorts by code point, so compare case-sensitively (FString's operator< ignores case)
+    Keys.Sort([](const FString& A, const FString& B)
+    {
+        return A.Compare(B, ESearchCase::CaseSensitive) < 0;
+    });
+
+    FString Data = TEXT("TRL_v1");
+    for (const FString& Key : Keys)
+    {
+        Data += TEXT("|");
+        Data += Key;
+        Data += TEXT(":");
+        Data += RawDimensionValues[Key];
+    }
+
+    // DJB2 over code points, wrapped to 32 bits
+    uint32 Hash = 5381;
+    for (const TCHAR Char : Data)
+    {
+        Hash = (Hash << 5) + Hash + static_cast<uint32>(Char);
+    }
+    return FString::Printf(TEXT("%08x"), Hash);
+}
@@ -0,0 +1,89 @@
+// BridgeIntegrity.h
+// Integrity stage for bridge exchange files.
+//
+// Every USDA written by either side ends with one footer line:
+//   #bridge_integrity xxh64=<16 hex digits> size=<payload bytes>
+// The payload is every byte before that line. A reader that finds a missing
+// or mismatched footer knows it caught a partial write and can wait for the
+// next change instead of parsing garbage. The payload hash doubles as the
+// cache key for the state parse and the profile caches.
+//
+// Hashing is XXH64 (seed 0), implemented here and in bridge_integrity.py so both
+// sides agree without an extra dependency.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Streaming XXH64. Feed any number of Update() calls, then Finalize(). */
+class FBridgeXxHash64
+{
+public:
+    explicit FBridgeXxHash64(uint64 InSeed = 0);
+
+    void Reset();
+    void Update(const void* Data, uint64 Size);
+    uint64 Finalize() const;
+
+    /** One-shot convenience wrapper */
+    static uint64 HashBuffer(const void* Data, uint64 Size, uint64 Seed = 0);
+
+private:
+    void ConsumeStripe(const uint8* Stripe);
+
+    uint64 Seed = 0;
+    uint64 Lanes[4];
+    uint8 Buffer[32];
+    uint32 BufferSize = 0;
+    uint64 TotalLength = 0;
+};
+
+
+/** Outcome of reading an exchange file through the integrity stage */
+enum class EBridgeReadResult : uint8
+{
+    /** File read; footer verified, or absent and not required */
+    Ok,
+
+    /** File missing or unreadable */
+    Missing,
+
+    /** Footer mismatched, or required but missing: the writer was mid-write */
+    Torn
+};
+
+
+/** Payload of a verified exchange file */
+struct FBridgeVerifiedFile
+{
+    /** File text without the footer line */
+    FString Content;
+
+    /** XXH64 of the payload bytes (the whole file when there is no footer) */
+    uint64 Hash = 0;
+
+    /** True if the file carried a footer; verified unless it came from ReadUnverified */
+    bool bHadFooter = false;
+};
+
+
+class FBridgeIntegrity
+{
+public:
+    /** Read, verify and decode a file in one pass. With bRequireFooter a footer-less file counts as torn. */
+    static EBridgeReadResult ReadVerified(const FString& Path, FBridgeVerifiedFile& OutFile, bool bRequireFooter);
+
+    /** Read a file that keeps failing verification: strip any footer line and take the rest as is.
+     *  Returns Ok or Missing, never Torn. */
+    static EBridgeReadResult ReadUnverified(const FString& Path, FBridgeVerifiedFile& OutFile);
+
+    /** Replace any existing footer on Content with one matching its current payload */
+    static FString Seal(const FString& Content, uint64* OutHash = nullptr);
+
+    /** Seal and write as UTF-8 (no BOM) so the footer matches the bytes on disk */
+    static bool SaveSealed(const FString& Content, const FString& Path, uint64* OutHash = nullptr);
+
+    /** DJB2 profile checksum as computed by usd_bridge.compute_checksum():
+     *  "TRL_v1|key:value|..." with keys sorted and values as written in the USDA. */
+    static FString ComputeProfileChecksum(const TMap<FString, FString>& RawDimensionValues);
+};
@@ -0,0 +1,159 @@
+// BridgeLog.cpp
+// Secondary log sinks: on-screen echo and the recent-event ring.
+
+#include "BridgeLog.h"
+#include "Engine/Engine.h"
+#include "HAL/PlatformTime.h"
+
+TAtomic<uint32> FBridgeLog::SinkFlags(0);
+
+namespace
+{
+    static_assert((FBridgeLog::RingCapacity & (FBridgeLog::RingCapacity - 1)) == 0, "RingCapacity must be a power of two");
+
+    /**
+     * One ring slot, guarded by a sequence lock. Writers claim an index with a
+     * single atomic add and never wait; readers retry nothing and simply drop
+     * slots that were overwritten while they copied them.
+     *   Sequence == 0            never written
+     *   Sequence == 2*Index + 1  being written
+     *   Sequence == 2*Index + 2  holds event Index
+     */
+    struct FRingSlot
+    {
+        TAtomic<uint64> Sequence;
+        double TimeSeconds = 0.0;
+        uint8 Verbosity = 0;
+        int32 Length = 0;
+        TCHAR Text[FBridgeLog::MaxMessageLength];
+
+        FRingSlot() : Sequence(0) {}
+    };
+
+    FRingSlot GRing[FBridgeLog::RingCapacity];
+    TAtomic<uint64> GRingHead(0);
+}
+
+
+void FBridgeLog::SetSinkFlag(uint32 Flag, bool bEnabled)
+{
+    uint32 Current = SinkFlags.Load(EMemoryOrder::Relaxed);
+    const uint32 Desired = bEnabled ? (Current | Flag) : (Current & ~Flag);
+    if (Current != Desired)
+    {
+        SinkFlags.Store(Desired);
+    }
+}
+
+
+void FBridgeLog::SetOnScreenEcho(bool bEnabled)
+{
+#if !UE_BUILD_SHIPPING
+    SetSinkFlag(SINK_OnScreen, bEnabled);
+#endif
+}
+
+
+void FBridgeLog::SetCaptureEnabled(bool bEnabled)
+{
+    SetSinkFlag(SINK_Capture, bEnabled);
+}
+
+
+bool FBridgeLog::IsCaptureEnabled()
+{
+    return (SinkFlags.Load(EMemoryOrder::Relaxed) & SINK_Capture) != 0;
+}
+
+
+void FBridgeLog::Dispatch(ELogVerbosity::Type Verbosity, const FString& Message)
+{
+    const uint32 Flags = SinkFlags.Load(EMemoryOrder::Relaxed);
+
+    if (Flags & SINK_Capture)
+    {
+        Capture(Verbosity, Message);
+    }
+
+#if !UE_BUILD_SHIPPING
+    if ((Flags & SINK_OnScreen) && GEngine && IsInGameThread())
+    {
+        const FColor Color = (Verbosity <= ELogVerbosity::Warning) ? FColor::Yellow : FColor::Cyan;
+        GEngine->AddOnScreenDebugMessage(-1, 5.0f, Color, FString::Printf(TEXT("[Bridge] %s"), *Message));
+    }
+#endif
+}
+
+
+void FBridgeLog::Capture(ELogVerbosity::Type Verbosity, const FString& Message)
+{
+    const uint64 Index = GRingHead.IncrementExchange();
+    FRingSlot& Slot = GRing[Index & (RingCapacity - 1)];
+
+    Slot.Sequence.Store(2 * Index + 1);
+    FPlatformMisc::MemoryBarrier();
+
+    Slot.TimeSeconds = FPlatformTime::Seconds();
+    Slot.Verbosity = static_cast<uint8>(Verbosity);
+    Slot.Length = FMath::Min(Message.Len(), MaxMessageLength);
+    FMemory::Memcpy(Slot.Text, *Message, Slot.Length * sizeof(TCHAR));
+
+    FPlatformMisc::MemoryBarrier();
+    Slot.Sequence.Store(2 * Index + 2);
+}
+
+
+TArray<FBridgeLogEvent> FBridgeLog::GetRecentEvents()
+{
+    TArray<FBridgeLogEvent> Events;
+
+    const uint64 Head = GRingHead.Load();
+    const uint64 First = (Head > RingCapacity) ? Head - RingCapacity : 0;
+    Events.Reserve(static_cast<int32>(Head - First));
+
+    for (uint64 Index = First; Index < Head; ++Index)
+    {
+        const FRingSlot& Slot = GRing[Index & (RingCapacity - 1)];
+        const uint64 Expected = 2 * Index + 2;
+
+        if (Slot.Sequence.Load() != Expected)
+        {
+            continue;  // Still being written, or already overwritten
+        }
+
+        FBridgeLogEvent Event;
+        Event.Sequence = Index;
+        Event.TimeSeconds = Slot.TimeSeconds;
+        Event.Verbosity = static_cast<ELogVerbosity::Type>(Slot.Verbosity);
+        const int32 Length = FMath::Clamp(Slot.Length, 0, MaxMessageLength);
+        Event.Message = FString(Length, Slot.Text);
+
+        // Discard the copy if a writer reused the slot while we read it
+        FPlatformMisc::MemoryBarrier();
+        if (Slot.Sequence.Load() == Expected)
+        {
+            Events.Add(MoveTemp(Event));
+        }
+    }
+
+    return Events;
+}
+
+
+void FBridgeLog::DumpRecent(const FString& Reason)
+{
+    const TArray<FBridgeLogEvent> Events = GetRecentEvents();
+    if (Events.Num() == 0)
+    {
+        return;
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    UE_LOG(LogUEBridge, Warning, TEXT("[Bridge] === Recent log (%d events) before: %s ==="), Events.Num(), *Reason);
+    for (const FBridgeLogEvent& Event : Events)
+    {
+        UE_LOG(LogUEBridge, Warning, TEXT("[Bridge]   #%llu %+8.3fs %-7s %s"),
+            Event.Sequence, Event.TimeSeconds - Now, ToString(Event.Verbosity), *Event.Message);
+    }
+    UE_LOG(LogUEBridge, Warning, TEXT("[Bridge] === End of recent log ==="));
+}
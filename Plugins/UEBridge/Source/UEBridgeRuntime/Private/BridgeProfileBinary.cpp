@@ -0,0 +1,216 @@
+// BridgeProfileBinary.cpp
+// Binary profile cache writer/reader. See BridgeProfileBinary.h for the layout.
+
+#include "BridgeProfileBinary.h"
+#include "BridgeLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+namespace
+{
+    /** Appends strings to a UTF-8 pool while building the binary file */
+    struct FStringPoolBuilder
+    {
+        TArray<uint8> Bytes;
+
+        template <typename RefType>
+        RefType Add(const FString& Value)
+        {
+            FTCHARToUTF8 Utf8(*Value);
+            RefType Ref;
+            Ref.Offset = static_cast<uint32>(Bytes.Num());
+            Ref.Length = static_cast<uint32>(Utf8.Length());
+            Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+            return Ref;
+        }
+    };
+
+    template <typename T>
+    void AppendPod(TArray<uint8>& Out, const T& Value)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+}
+
+
+FString FBridgeProfileBinary::GetBinaryPath(const FString& UsdPath)
+{
+    return FPaths::ChangeExtension(UsdPath, TEXT("tpb"));
+}
+
+
+bool FBridgeProfileBinary::Save(const FUEBridgeProfile& Profile, const FString& BinaryPath, uint64 SourceHash)
+{
+#if !PLATFORM_LITTLE_ENDIAN
+    return false;  // Layout is defined little-endian; don't write a cache we can't share
+#else
+    FStringPoolBuilder Pool;
+    FHeader Header;
+
+    TArray<FDimensionEntry> Dimensions;
+    Dimensions.Reserve(Profile.Dimensions.Num());
+    for (const auto& Pair : Profile.Dimensions)
+    {
+        FDimensionEntry& Entry = Dimensions.AddDefaulted_GetRef();
+        Entry.Name = Pool.Add<FStringRef>(Pair.Key);
+        Entry.Score = Pair.Value;
+    }
+
+    TArray<FTraitEntry> Traits;
+    Traits.Reserve(Profile.Traits.Num());
+    for (const FTranslatorsTrait& Trait : Profile.Traits)
+    {
+        FTraitEntry& Entry = Traits.AddDefaulted_GetRef();
+        Entry.Dimension = Pool.Add<FStringRef>(Trait.Dimension);
+        Entry.Label = Pool.Add<FStringRef>(Trait.Label);
+        Entry.Behavior = Pool.Add<FStringRef>(Trait.Behavior);
+        Entry.Score = Trait.Score;
+    }
+
+    TArray<FStringRef> Insights;
+    Insights.Reserve(Profile.Insights.Num());
+    for (const FString& Insight : Profile.Insights)
+    {
+        Insights.Add(Pool.Add<FStringRef>(Insight));
+    }
+
+    Header.Checksum = Pool.Add<FStringRef>(Profile.Checksum);
+    Header.Anchor = Pool.Add<FStringRef>(Profile.Anchor);
+    Header.GeneratorVersion = Pool.Add<FStringRef>(Profile.GeneratorVersion);
+    Header.SourceHash = SourceHash;
+    Header.Flags = Profile.bChecksumVerified ? FLAG_ChecksumVerified : 0;
+
+    Header.NumDimensions = Dimensions.Num();
+    Header.NumTraits = Traits.Num();
+    Header.NumInsights = Insights.Num();
+    Header.DimensionTableOffset = sizeof(FHeader);
+    Header.TraitTableOffset = Header.DimensionTableOffset + Dimensions.Num() * sizeof(FDimensionEntry);
+    Header.InsightTableOffset = Header.TraitTableOffset + Traits.Num() * sizeof(FTraitEntry);
+    Header.StringPoolOffset = Header.InsightTableOffset + Insights.Num() * sizeof(FStringRef);
+    Header.StringPoolSize = Pool.Bytes.Num();
+    Header.FileSize = Header.StringPoolOffset + Header.StringPoolSize;
+
+    TArray<uint8> Out;
+    Out.Reserve(Header.FileSize);
+    AppendPod(Out, Header);
+    Out.Append(reinterpret_cast<const uint8*>(Dimensions.GetData()), Dimensions.Num() * sizeof(FDimensionEntry));
+    Out.Append(reinterpret_cast<const uint8*>(Traits.GetData()), Traits.Num() * sizeof(FTraitEntry));
+    Out.Append(reinterpret_cast<const uint8*>(Insights.GetData()), Insights.Num() * sizeof(FStringRef));
+    Out.Append(Pool.Bytes);
+    check(Out.Num() == static_cast<int32>(Header.FileSize));
+
+    // Write to a temp file and move into place so a reader never sees a partial cache
+    const FString TempPath = BinaryPath + TEXT(".tmp");
+    if (!FFileHelper::SaveArrayToFile(Out, *TempPath))
+    {
+        return false;
+    }
+    return IFileManager::Get().Move(*BinaryPath, *TempPath, /*bReplace*/ true);
+#endif
+}
+
+
+bool FBridgeProfileBinary::Load(const FString& BinaryPath, uint64 SourceHash, FUEBridgeProfile& OutProfile)
+{
+#if !PLATFORM_LITTLE_ENDIAN
+    return false;
+#else
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *BinaryPath, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    if (Bytes.Num() < static_cast<int32>(sizeof(FHeader)))
+    {
+        return false;
+    }
+
+    FHeader Header;
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(FHeader));
+
+    if (Header.Magic != MAGIC || Header.Version != VERSION || Header.HeaderSize != sizeof(FHeader)
+        || Header.FileSize != static_cast<uint32>(Bytes.Num()))
+    {
+        BRIDGE_LOG(Verbose, TEXT("Binary profile %s has wrong magic/version/size, ignoring"), *BinaryPath);
+        return false;
+    }
+
+    // Bounds-check every table before fixing up pointers into the buffer
+    const uint64 FileSize = Header.FileSize;
+    auto TableFits = [FileSize](uint32 Offset, uint32 Count, uint32 Stride)
+    {
+        return (Offset % 4) == 0 && static_cast<uint64>(Offset) + static_cast<uint64>(Count) * Stride <= FileSize;
+    };
+
+    if (!TableFits(Header.DimensionTableOffset, Header.NumDimensions, sizeof(FDimensionEntry))
+        || !TableFits(Header.TraitTableOffset, Header.NumTraits, sizeof(FTraitEntry))
+        || !TableFits(Header.InsightTableOffset, Header.NumInsights, sizeof(FStringRef))
+        || static_cast<uint64>(Header.StringPoolOffset) + Header.StringPoolSize > FileSize)
+    {
+        return false;
+    }
+
+    // Verify the cache was built from the USDA payload currently on disk
+    if (SourceHash != Header.SourceHash)
+    {
+        return false;
+    }
+
+    const uint8* Base = Bytes.GetData();
+    const FDimensionEntry* DimensionTable = reinterpret_cast<const FDimensionEntry*>(Base + Header.DimensionTableOffset);
+    const FTraitEntry* TraitTable = reinterpret_cast<const FTraitEntry*>(Base + Header.TraitTableOffset);
+    const FStringRef* InsightTable = reinterpret_cast<const FStringRef*>(Base + Header.InsightTableOffset);
+    const uint8* StringPool = Base + Header.StringPoolOffset;
+    const uint32 PoolSize = Header.StringPoolSize;
+
+    bool bStringsValid = true;
+    auto ResolveString = [StringPool, PoolSize, &bStringsValid](const FStringRef& Ref) -> FString
+    {
+        if (static_cast<uint64>(Ref.Offset) + Ref.Length > PoolSize)
+        {
+            bStringsValid = false;
+            return FString();
+        }
+        FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StringPool + Ref.Offset), Ref.Length);
+        return FString(Converted.Length(), Converted.Get());
+    };
+
+    FUEBridgeProfile Profile;
+    Profile.Checksum = ResolveString(Header.Checksum);
+    Profile.Anchor = ResolveString(Header.Anchor);
+    Profile.GeneratorVersion = ResolveString(Header.GeneratorVersion);
+    Profile.bChecksumVerified = (Header.Flags & FLAG_ChecksumVerified) != 0;
+
+    Profile.Dimensions.Reserve(Header.NumDimensions);
+    for (uint32 i = 0; i < Header.NumDimensions; ++i)
+    {
+        Profile.Dimensions.Add(ResolveString(DimensionTable[i].Name), DimensionTable[i].Score);
+    }
+
+    Profile.Traits.Reserve(Header.NumTraits);
+    for (uint32 i = 0; i < Header.NumTraits; ++i)
+    {
+        FTranslatorsTrait& Trait = Profile.Traits.AddDefaulted_GetRef();
+        Trait.Dimension = ResolveString(TraitTable[i].Dimension);
+        Trait.Label = ResolveString(TraitTable[i].Label);
+        Trait.Behavior = ResolveString(TraitTable[i].Behavior);
+        Trait.Score = TraitTable[i].Score;
+    }
+
+    Profile.Insights.Reserve(Header.NumInsights);
+    for (uint32 i = 0; i < Header.NumInsights; ++i)
+    {
+        Profile.Insights.Add(ResolveString(InsightTable[i]));
+    }
+
+    if (!bStringsValid)
+    {
+        return false;
+    }
+
+    OutProfile = MoveTemp(Profile);
+    return true;
+#endif
+}
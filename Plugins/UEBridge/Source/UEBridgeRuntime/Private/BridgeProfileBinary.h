@@ -0,0 +1,90 @@
+// BridgeProfileBinary.h
+// Compact fixed-layout binary cache for cognitive profiles.
+//
+// cognitive_profile.usda stays the interchange format written by Python.
+// After a successful text parse the subsystem writes cognitive_profile.tpb
+// next to it; later loads are one file read plus offset fix-ups instead of
+// a full regex pass over the USDA. The cache is keyed by the XXH64 of the
+// USDA payload (see BridgeIntegrity.h), so touching the file without
+// changing it keeps the cache valid and any edit invalidates it.
+//
+// File layout (little-endian, 4-byte aligned):
+//   FHeader
+//   FDimensionEntry[NumDimensions]
+//   FTraitEntry[NumTraits]
+//   FStringRef[NumInsights]
+//   String pool (UTF-8, not null-terminated)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BridgeTypes.h"
+
+class FBridgeProfileBinary
+{
+public:
+    static constexpr uint32 MAGIC = 0x46504254; // "TBPF"
+    static constexpr uint16 VERSION = 2;
+
+    /** Binary cache path for a given USDA profile (same directory, .tpb extension) */
+    static FString GetBinaryPath(const FString& UsdPath);
+
+    /** Serialize a parsed profile. SourceHash is the payload hash of the USDA it was parsed from. */
+    static bool Save(const FUEBridgeProfile& Profile, const FString& BinaryPath, uint64 SourceHash);
+
+    /** Load a profile with a single read. Returns false if the file is missing, on any
+     *  layout/version mismatch, or if it was built from a different payload than SourceHash. */
+    static bool Load(const FString& BinaryPath, uint64 SourceHash, FUEBridgeProfile& OutProfile);
+
+private:
+    enum EFlags : uint32
+    {
+        FLAG_ChecksumVerified = 1 << 0
+    };
+
+    struct FStringRef
+    {
+        uint32 Offset = 0;  // Byte offset into the string pool
+        uint32 Length = 0;  // Byte length (UTF-8)
+    };
+
+    struct FHeader
+    {
+        uint32 Magic = MAGIC;
+        uint16 Version = VERSION;
+        uint16 HeaderSize = sizeof(FHeader);
+        uint32 FileSize = 0;
+        uint32 NumDimensions = 0;
+        uint32 NumTraits = 0;
+        uint32 NumInsights = 0;
+        uint32 DimensionTableOffset = 0;
+        uint32 TraitTableOffset = 0;
+        uint32 InsightTableOffset = 0;
+        uint32 StringPoolOffset = 0;
+        uint32 StringPoolSize = 0;
+        FStringRef Checksum;
+        FStringRef Anchor;
+        FStringRef GeneratorVersion;
+        uint32 Flags = 0;       // EFlags
+        uint64 SourceHash = 0;  // XXH64 of the USDA payload this was built from
+    };
+
+    struct FDimensionEntry
+    {
+        FStringRef Name;
+        float Score = 0.0f;
+    };
+
+    struct FTraitEntry
+    {
+        FStringRef Dimension;
+        FStringRef Label;
+        FStringRef Behavior;
+        float Score = 0.0f;
+    };
+
+    static_assert(sizeof(FStringRef) == 8, "FStringRef layout changed");
+    static_assert(sizeof(FHeader) == 80, "FHeader layout changed -- bump VERSION");
+    static_assert(sizeof(FDimensionEntry) == 12, "FDimensionEntry layout changed -- bump VERSION");
+    static_assert(sizeof(FTraitEntry) == 28, "FTraitEntry layout changed -- bump VERSION");
+};
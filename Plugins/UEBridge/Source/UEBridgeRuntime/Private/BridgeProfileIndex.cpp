@@ -0,0 +1,219 @@
+// BridgeProfileIndex.cpp
+// Struct-of-arrays profile store with vectorized range filters and KNN.
+
+#include "BridgeProfileIndex.h"
+#include "UEBridgeRuntime.h"
+#include "Math/VectorRegister.h"
+#include <limits>
+
+
+// === STORAGE ===
+
+int32 UBridgeProfileIndex::AddProfile(const FUEBridgeProfile& Profile)
+{
+    const int32 Row = NumRows;
+    ReserveRows(Row + 1);
+
+    // New dimensions get a column backfilled with the default score for earlier rows
+    for (const auto& Pair : Profile.Dimensions)
+    {
+        FindOrAddColumn(Pair.Key);
+    }
+
+    for (int32 Col = 0; Col < Columns.Num(); ++Col)
+    {
+        const float* Score = Profile.Dimensions.Find(ColumnNames[Col]);
+        Columns[Col][Row] = Score ? *Score : DefaultScore;
+    }
+
+    Profiles.Add(Profile);
+    ++NumRows;
+    return Row;
+}
+
+
+void UBridgeProfileIndex::Clear()
+{
+    Profiles.Reset();
+    ColumnNames.Reset();
+    ColumnLookup.Reset();
+    Columns.Reset();
+    NumRows = 0;
+}
+
+
+FUEBridgeProfile UBridgeProfileIndex::GetProfile(int32 Index) const
+{
+    return Profiles.IsValidIndex(Index) ? Profiles[Index] : FUEBridgeProfile();
+}
+
+
+int32 UBridgeProfileIndex::FindOrAddColumn(const FString& Dimension)
+{
+    if (const int32* Existing = ColumnLookup.Find(Dimension))
+    {
+        return *Existing;
+    }
+
+    // Match the padded length of existing columns (AddProfile has already reserved the new row)
+    const int32 PaddedRows = Columns.Num() > 0 ? Columns[0].Num() : Align(NumRows + 1, LaneCount);
+    const float Pad = std::numeric_limits<float>::quiet_NaN();
+
+    TArray<float>& Column = Columns.AddDefaulted_GetRef();
+    Column.SetNumUninitialized(PaddedRows);
+    for (int32 Row = 0; Row < PaddedRows; ++Row)
+    {
+        // Padding lanes are NaN so every comparison against them fails
+        Column[Row] = (Row < NumRows) ? DefaultScore : Pad;
+    }
+
+    const int32 Index = ColumnNames.Add(Dimension);
+    ColumnLookup.Add(Dimension, Index);
+    return Index;
+}
+
+
+void UBridgeProfileIndex::ReserveRows(int32 RowCapacity)
+{
+    const int32 PaddedRows = Align(RowCapacity, LaneCount);
+    for (TArray<float>& Column : Columns)
+    {
+        while (Column.Num() < PaddedRows)
+        {
+            Column.Add(std::numeric_limits<float>::quiet_NaN());
+        }
+    }
+}
+
+
+// === QUERIES ===
+
+TArray<int32> UBridgeProfileIndex::Filter(const TArray<FBridgeDimensionRange>& Ranges) const
+{
+    TArray<int32> Result;
+    if (NumRows == 0)
+    {
+        return Result;
+    }
+
+    TArray<const float*> FilterColumns;
+    TArray<VectorRegister4Float> FilterMins;
+    TArray<VectorRegister4Float> FilterMaxs;
+
+    for (const FBridgeDimensionRange& Range : Ranges)
+    {
+        const int32* Col = ColumnLookup.Find(Range.Dimension);
+        if (!Col)
+        {
+            // Unknown dimension: every row reads the default score
+            if (DefaultScore < Range.Min || DefaultScore > Range.Max)
+            {
+                return Result;
+            }
+            continue;
+        }
+
+        FilterColumns.Add(Columns[*Col].GetData());
+        FilterMins.Add(VectorSetFloat1(Range.Min));
+        FilterMaxs.Add(VectorSetFloat1(Range.Max));
+    }
+
+    for (int32 Base = 0; Base < NumRows; Base += LaneCount)
+    {
+        int32 Bits = (1 << LaneCount) - 1;
+        for (int32 F = 0; F < FilterColumns.Num() && Bits != 0; ++F)
+        {
+            const VectorRegister4Float Values = VectorLoad(FilterColumns[F] + Base);
+            const VectorRegister4Float InRange = VectorBitwiseAnd(
+                VectorCompareGE(Values, FilterMins[F]),
+                VectorCompareLE(Values, FilterMaxs[F]));
+            Bits &= VectorMaskBits(InRange);
+        }
+
+        while (Bits != 0)
+        {
+            const int32 Row = Base + FMath::CountTrailingZeros(static_cast<uint32>(Bits));
+            if (Row < NumRows)
+            {
+                Result.Add(Row);
+            }
+            Bits &= Bits - 1;
+        }
+    }
+
+    return Result;
+}
+
+
+TArray<FBridgeProfileMatch> UBridgeProfileIndex::FindNearest(const TMap<FString, float>& Query, int32 K) const
+{
+    TArray<FBridgeProfileMatch> Matches;
+    if (NumRows == 0 || Query.Num() == 0 || K <= 0)
+    {
+        return Matches;
+    }
+
+    const int32 PaddedRows = Align(NumRows, LaneCount);
+    TArray<float> Distances;
+    Distances.SetNumZeroed(PaddedRows);
+
+    // Dimensions unknown to the index contribute the same term to every row
+    float ConstantTerm = 0.0f;
+
+    for (const auto& Pair : Query)
+    {
+        const int32* Col = ColumnLookup.Find(Pair.Key);
+        if (!Col)
+        {
+            ConstantTerm += FMath::Square(DefaultScore - Pair.Value);
+            continue;
+        }
+
+        const float* Column = Columns[*Col].GetData();
+        float* Dist = Distances.GetData();
+        const VectorRegister4Float Target = VectorSetFloat1(Pair.Value);
+
+        for (int32 Base = 0; Base < PaddedRows; Base += LaneCount)
+        {
+            const VectorRegister4Float Diff = VectorSubtract(VectorLoad(Column + Base), Target);
+            VectorStore(VectorMultiplyAdd(Diff, Diff, VectorLoad(Dist + Base)), Dist + Base);
+        }
+    }
+
+    // Bounded insertion keeps the K best without sorting every row (K is small)
+    K = FMath::Min(K, NumRows);
+    TArray<TPair<float, int32>, TInlineAllocator<16>> Best;
+    for (int32 Row = 0; Row < NumRows; ++Row)
+    {
+        const float SquaredDistance = Distances[Row] + ConstantTerm;
+        if (Best.Num() == K && SquaredDistance >= Best.Last().Key)
+        {
+            continue;
+        }
+
+        int32 Insert = Best.Num();
+        while (Insert > 0 && Best[Insert - 1].Key > SquaredDistance)
+        {
+            --Insert;
+        }
+        Best.Insert(TPair<float, int32>(SquaredDistance, Row), Insert);
+        if (Best.Num() > K)
+        {
+            Best.Pop(EAllowShrinking::No);
+        }
+    }
+
+    // Scores are 0-1, so the largest possible distance is sqrt(number of dimensions)
+    const float MaxDistance = FMath::Sqrt(static_cast<float>(Query.Num()));
+    Matches.Reserve(Best.Num());
+    for (const TPair<float, int32>& Entry : Best)
+    {
+        FBridgeProfileMatch& Match = Matches.AddDefaulted_GetRef();
+        Match.Index = Entry.Value;
+        Match.Checksum = Profiles[Entry.Value].Checksum;
+        Match.Distance = FMath::Sqrt(Entry.Key);
+        Match.Similarity = FMath::Clamp(1.0f - Match.Distance / MaxDistance, 0.0f, 1.0f);
+    }
+
+    return Matches;
+}
@@ -4,6 +4,10 @@
 
 #include "UEBridgeSubsystem.h"
 #include "UEBridgeRuntime.h"
+#include "BridgeIntegrity.h"
+#include "BridgeLog.h"
+#include "BridgeProfileBinary.h"
+#include "BridgeProfileIndex.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformProcess.h"
@@ -22,6 +26,8 @@ void UUEBridgeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
     BridgePath = ResolveBridgePath();
+    ProfileIndex = NewObject<UBridgeProfileIndex>(this);
+    SyncLogSinks();
     UE_LOG(LogUEBridge, Log, TEXT("UEBridgeSubsystem initialized (path: %s)"), *BridgePath);
 }
 
@@ -42,6 +48,8 @@ TStatId UUEBridgeSubsystem::GetStatId() const
 
 void UUEBridgeSubsystem::Tick(float DeltaTime)
 {
+    SyncLogSinks();
+
     // Polling for state file changes
     PollTimer += DeltaTime;
     if (PollTimer >= PollInterval)
@@ -114,18 +122,25 @@ void UUEBridgeSubsystem::Tick(float DeltaTime)
         if (TimeSinceLastUsdChange >= DebounceTime)
         {
             bUsdChangePending = false;
-            BridgeLog(TEXT("USD profile file changed"));
+            BRIDGE_LOG(Log, TEXT("USD profile file changed"));
             // Find which file changed and broadcast
             FString ProfilePath = GetBridgeFilePath(TEXT("cognitive_profile.usda"));
             FString SubstratePath = GetBridgeFilePath(TEXT("cognitive_substrate.usda"));
             IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+            FString ChangedPath;
             if (PlatformFile.FileExists(*ProfilePath))
             {
-                OnUsdProfileUpdated.Broadcast(ProfilePath);
+                ChangedPath = ProfilePath;
             }
             else if (PlatformFile.FileExists(*SubstratePath))
             {
-                OnUsdProfileUpdated.Broadcast(SubstratePath);
+                ChangedPath = SubstratePath;
+            }
+
+            if (!ChangedPath.IsEmpty())
+            {
+                OnUsdProfileUpdated.Broadcast(ChangedPath);
+                UpdateProfileDelta(ChangedPath);
             }
         }
     }
@@ -138,22 +153,22 @@ void UUEBridgeSubsystem::StartGame()
 {
     if (bIsActive)
     {
-        BridgeLog(TEXT("Bridge already active"));
+        BRIDGE_LOG(Log, TEXT("Bridge already active"));
         return;
     }
 
-    BridgeLog(TEXT("========================================"));
-    BridgeLog(TEXT("TRANSLATORS BRIDGE SUBSYSTEM v2.1.0"));
-    BridgeLog(TEXT("USD-native communication with JSON fallback"));
-    BridgeLog(FString::Printf(TEXT("Bridge Path: %s"), *BridgePath));
-    BridgeLog(TEXT("========================================"));
+    BRIDGE_LOG(Log, TEXT("========================================"));
+    BRIDGE_LOG(Log, TEXT("TRANSLATORS BRIDGE SUBSYSTEM v2.1.0"));
+    BRIDGE_LOG(Log, TEXT("USD-native communication with JSON fallback"));
+    BRIDGE_LOG(Log, TEXT("Bridge Path: %s"), *BridgePath);
+    BRIDGE_LOG(Log, TEXT("========================================"));
 
     // Ensure bridge directory exists
     IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     if (!PlatformFile.DirectoryExists(*BridgePath))
     {
         PlatformFile.CreateDirectory(*BridgePath);
-        BridgeLog(FString::Printf(TEXT("Created bridge directory: %s"), *BridgePath));
+        BRIDGE_LOG(Log, TEXT("Created bridge directory: %s"), *BridgePath);
     }
 
     bIsActive = true;
@@ -165,12 +180,12 @@ void UUEBridgeSubsystem::StartGame()
 
     if (PlatformFile.FileExists(*UsdFilePath))
     {
-        BridgeLog(TEXT("Found existing bridge_state.usda - processing..."));
+        BRIDGE_LOG(Log, TEXT("Found existing bridge_state.usda - processing..."));
         ProcessStateFile();
     }
     else if (PlatformFile.FileExists(*JsonFilePath))
     {
-        BridgeLog(TEXT("Found existing state.json - processing..."));
+        BRIDGE_LOG(Log, TEXT("Found existing state.json - processing..."));
         ProcessStateFile();
     }
 }
@@ -185,9 +200,11 @@ void UUEBridgeSubsystem::StopGame()
     bIsActive = false;
     bStateChangePending = false;
     bUsdChangePending = false;
+    LastProfile = FUEBridgeProfile();
+    LastStateHash = 0;
     SetState(EUEBridgeState::Idle);
 
-    BridgeLog(TEXT("Bridge stopped"));
+    BRIDGE_LOG(Log, TEXT("Bridge stopped"));
 }
 
 
@@ -195,10 +212,11 @@ void UUEBridgeSubsystem::SubmitAnswer(const FString& QuestionId, int32 OptionInd
 {
     // Try USD mode first
     FString FilePath = GetBridgeFilePath(TEXT("bridge_state.usda"));
-    FString Content;
+    FBridgeVerifiedFile File;
 
-    if (bUsingUsdMode && FFileHelper::LoadFileToString(Content, *FilePath))
+    if (bUsingUsdMode && ReadBridgeFile(FilePath, File) == EBridgeReadResult::Ok)
     {
+        FString Content = MoveTemp(File.Content);
         FString Timestamp = FDateTime::UtcNow().ToIso8601();
         FString SelectedLabel = (OptionIndex >= 0 && OptionIndex < CurrentQuestion.OptionLabels.Num())
             ? CurrentQuestion.OptionLabels[OptionIndex] : TEXT("");
@@ -220,17 +238,18 @@ void UUEBridgeSubsystem::SubmitAnswer(const FString& QuestionId, int32 OptionInd
         int32 MaxRetries = 3;
         for (int32 Retry = 0; Retry < MaxRetries; ++Retry)
         {
-            if (FFileHelper::SaveStringToFile(Content, *FilePath))
+            // Record our own write's hash so the poll doesn't reprocess it
+            if (FBridgeIntegrity::SaveSealed(Content, FilePath, &LastStateHash))
             {
-                BridgeLog(FString::Printf(TEXT("USD answer sent: %s = option %d (%.0fms)"),
-                    *QuestionId, OptionIndex, ResponseTimeMs));
+                BRIDGE_LOG(Log, TEXT("USD answer sent: %s = option %d (%.0fms)"),
+                    *QuestionId, OptionIndex, ResponseTimeMs);
                 SetState(EUEBridgeState::AnswerPending);
                 return;
             }
             FPlatformProcess::Sleep(0.1f);
         }
 
-        BridgeLog(TEXT("USD answer write failed, falling back to JSON"));
+        BRIDGE_LOG(Warning, TEXT("USD answer write failed, falling back to JSON"));
     }
 
     // JSON fallback
@@ -248,8 +267,8 @@ void UUEBridgeSubsystem::SubmitAnswer(const FString& QuestionId, int32 OptionInd
     WriteJsonToFile(TEXT("answer.json"), JsonObj);
     SetState(EUEBridgeState::AnswerPending);
 
-    BridgeLog(FString::Printf(TEXT("JSON answer sent: %s = option %d (%.0fms)"),
-        *QuestionId, OptionIndex, ResponseTimeMs));
+    BRIDGE_LOG(Log, TEXT("JSON answer sent: %s = option %d (%.0fms)"),
+        *QuestionId, OptionIndex, ResponseTimeMs);
 }
 
 
@@ -257,10 +276,11 @@ void UUEBridgeSubsystem::SendAcknowledge()
 {
     // Try USD mode first
     FString FilePath = GetBridgeFilePath(TEXT("bridge_state.usda"));
-    FString Content;
+    FBridgeVerifiedFile File;
 
-    if (FFileHelper::LoadFileToString(Content, *FilePath))
+    if (ReadBridgeFile(FilePath, File) == EBridgeReadResult::Ok)
     {
+        FString Content = MoveTemp(File.Content);
         FString Timestamp = FDateTime::UtcNow().ToIso8601();
 
         Content = UpdateUsdaVariant(Content, TEXT("message_type"), TEXT("ack"));
@@ -269,9 +289,9 @@ void UUEBridgeSubsystem::SendAcknowledge()
         Content = UpdateUsdaAttribute(Content, TEXT("Ack"), TEXT("project"), TEXT("UnrealEngineBridge"), true);
         Content = UpdateUsdaAttribute(Content, TEXT("Ack"), TEXT("timestamp"), Timestamp, true);
 
-        if (FFileHelper::SaveStringToFile(Content, *FilePath))
+        if (FBridgeIntegrity::SaveSealed(Content, FilePath, &LastStateHash))
         {
-            BridgeLog(TEXT("USD acknowledgment sent"));
+            BRIDGE_LOG(Log, TEXT("USD acknowledgment sent"));
             bUsingUsdMode = true;
             return;
         }
@@ -290,13 +310,13 @@ void UUEBridgeSubsystem::SendAcknowledge()
     JsonObj->SetObjectField(TEXT("ack"), AckObj);
 
     WriteJsonToFile(TEXT("answer.json"), JsonObj);
-    BridgeLog(TEXT("JSON acknowledgment sent"));
+    BRIDGE_LOG(Log, TEXT("JSON acknowledgment sent"));
 }
 
 
 void UUEBridgeSubsystem::ForceReloadUsdStage()
 {
-    BridgeLog(TEXT("Force USD reload requested — broadcasting OnUsdProfileUpdated"));
+    BRIDGE_LOG(Log, TEXT("Force USD reload requested — broadcasting OnUsdProfileUpdated"));
     FString ProfilePath = GetBridgeFilePath(TEXT("cognitive_profile.usda"));
     OnUsdProfileUpdated.Broadcast(ProfilePath);
 }
@@ -325,7 +345,7 @@ void UUEBridgeSubsystem::SetState(EUEBridgeState NewState)
     {
         if (bVerboseLogging)
         {
-            BridgeLog(FString::Printf(TEXT("State: %d -> %d"), (int32)CurrentState, (int32)NewState));
+            BRIDGE_LOG(Log, TEXT("State: %d -> %d"), (int32)CurrentState, (int32)NewState);
         }
         CurrentState = NewState;
     }
@@ -361,17 +381,28 @@ FString UUEBridgeSubsystem::GetBridgeFilePath(const FString& Filename) const
 }
 
 
-void UUEBridgeSubsystem::BridgeLog(const FString& Message) const
+void UUEBridgeSubsystem::SyncLogSinks() const
 {
-    UE_LOG(LogUEBridge, Log, TEXT("[Bridge] %s"), *Message);
+    // Config properties can change at any time from Blueprint or the details panel
+    FBridgeLog::SetOnScreenEcho(bVerboseLogging);
+    FBridgeLog::SetCaptureEnabled(bCaptureRecentLog);
+}
+
 
-#if !UE_BUILD_SHIPPING
-    if (bVerboseLogging && GEngine)
+void UUEBridgeSubsystem::RaiseBridgeError(EBridgeErrorCode Code, const FString& Message)
+{
+    BRIDGE_LOG(Error, TEXT("%s"), *Message);
+    if (FBridgeLog::IsCaptureEnabled())
     {
-        GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan,
-            FString::Printf(TEXT("[Bridge] %s"), *Message));
+        FBridgeLog::DumpRecent(Message);
     }
-#endif
+    OnBridgeError.Broadcast(Code, Message);
+}
+
+
+void UUEBridgeSubsystem::DumpRecentLog() const
+{
+    FBridgeLog::DumpRecent(TEXT("requested"));
 }
 
 
@@ -405,7 +436,7 @@ void UUEBridgeSubsystem::ProcessStateFile()
 
     if (!FJsonSerializer::Deserialize(Reader, JsonObj) || !JsonObj.IsValid())
     {
-        OnBridgeError.Broadcast(EBridgeErrorCode::JsonParseFailure, TEXT("Invalid JSON in state.json"));
+        RaiseBridgeError(EBridgeErrorCode::JsonParseFailure, TEXT("Invalid JSON in state.json"));
         return;
     }
 
@@ -453,12 +484,12 @@ void UUEBridgeSubsystem::WriteJsonToFile(const FString& Filename, const TSharedP
 
         if (Retry < MaxRetries - 1)
         {
-            BridgeLog(FString::Printf(TEXT("Write failed, retry %d/%d..."), Retry + 1, MaxRetries));
+            BRIDGE_LOG(Warning, TEXT("Write failed, retry %d/%d..."), Retry + 1, MaxRetries);
             FPlatformProcess::Sleep(0.1f);
         }
     }
 
-    OnBridgeError.Broadcast(EBridgeErrorCode::FileWriteFailure,
+    RaiseBridgeError(EBridgeErrorCode::FileWriteFailure,
         FString::Printf(TEXT("Failed to write %s after %d retries"), *Filename, MaxRetries));
 }
 
@@ -473,7 +504,7 @@ void UUEBridgeSubsystem::HandleReadyState(const TSharedPtr<FJsonObject>& JsonObj
 
     int32 TotalQuestions = ReadyData->GetIntegerField(TEXT("total_questions"));
 
-    BridgeLog(FString::Printf(TEXT("Bridge ready! Total questions: %d"), TotalQuestions));
+    BRIDGE_LOG(Log, TEXT("Bridge ready! Total questions: %d"), TotalQuestions);
 
     SetState(EUEBridgeState::Connected);
     OnBridgeReady.Broadcast(TotalQuestions);
@@ -509,9 +540,9 @@ void UUEBridgeSubsystem::HandleQuestionState(const TSharedPtr<FJsonObject>& Json
 
     CurrentQuestion.DepthLabel = GetDepthLabelForIndex(CurrentQuestion.Index);
 
-    BridgeLog(FString::Printf(TEXT("Question %d/%d [%s]: %s"),
+    BRIDGE_LOG(Log, TEXT("Question %d/%d [%s]: %s"),
         CurrentQuestion.Index + 1, CurrentQuestion.Total,
-        *CurrentQuestion.DepthLabel, *CurrentQuestion.QuestionId));
+        *CurrentQuestion.DepthLabel, *CurrentQuestion.QuestionId);
 
     SetState(EUEBridgeState::QuestionActive);
     OnQuestionReady.Broadcast(CurrentQuestion);
@@ -528,8 +559,8 @@ void UUEBridgeSubsystem::HandleTransitionState(const TSharedPtr<FJsonObject>& Js
     FString NextScene = TransData->GetStringField(TEXT("next_scene"));
     float Progress = TransData->GetNumberField(TEXT("progress"));
 
-    BridgeLog(FString::Printf(TEXT("Transition: %s -> %s (%.0f%%)"),
-        *Direction, *NextScene, Progress * 100.0f));
+    BRIDGE_LOG(Log, TEXT("Transition: %s -> %s (%.0f%%)"),
+        *Direction, *NextScene, Progress * 100.0f);
 
     SetState(EUEBridgeState::Transitioning);
     OnTransitionReady.Broadcast(Direction, NextScene, Progress);
@@ -545,10 +576,15 @@ void UUEBridgeSubsystem::HandleFinaleState(const TSharedPtr<FJsonObject>& JsonOb
     FString UsdPath = FinaleData->GetStringField(TEXT("usd_path"));
     FString Message = FinaleData->GetStringField(TEXT("message"));
 
-    BridgeLog(FString::Printf(TEXT("FINALE: %s"), *Message));
+    BRIDGE_LOG(Log, TEXT("FINALE: %s"), *Message);
 
-    // Auto-parse the profile
+    // Auto-parse the profile (also becomes the baseline for later deltas)
     FUEBridgeProfile Profile = ParseCognitiveProfile(UsdPath);
+    LastProfile = Profile;
+    if (Profile.IsValid())
+    {
+        ProfileIndex->AddProfile(Profile);
+    }
 
     SetState(EUEBridgeState::Complete);
     OnProfileComplete.Broadcast(Profile, UsdPath);
@@ -557,22 +593,79 @@ void UUEBridgeSubsystem::HandleFinaleState(const TSharedPtr<FJsonObject>& JsonOb
 
 // === USD NATIVE COMMUNICATION ===
 
+EBridgeReadResult UUEBridgeSubsystem::ReadBridgeFile(const FString& Path, FBridgeVerifiedFile& OutFile)
+{
+    // Once Python is known to seal a file, a missing footer on it means a torn write
+    const EBridgeReadResult Result = FBridgeIntegrity::ReadVerified(Path, OutFile, SealedPaths.Contains(Path));
+    if (Result == EBridgeReadResult::Ok)
+    {
+        TornReads.Remove(Path);
+        if (OutFile.bHadFooter)
+        {
+            SealedPaths.Add(Path);
+        }
+        return Result;
+    }
+    if (Result == EBridgeReadResult::Missing)
+    {
+        return Result;
+    }
+
+    int32& Count = TornReads.FindOrAdd(Path);
+    if (++Count < MaxTornReads)
+    {
+        return Result;
+    }
+
+    // A writer that never settles (or stopped sealing) must not stall the bridge forever
+    TornReads.Remove(Path);
+    BRIDGE_LOG(Warning, TEXT("%s failed integrity check %d times in a row, reading it unverified"), *Path, MaxTornReads);
+    const EBridgeReadResult Fallback = FBridgeIntegrity::ReadUnverified(Path, OutFile);
+    if (Fallback == EBridgeReadResult::Ok && !OutFile.bHadFooter)
+    {
+        SealedPaths.Remove(Path);
+    }
+    OutFile.bHadFooter = false;
+    return Fallback;
+}
+
+
 bool UUEBridgeSubsystem::ProcessBridgeStateUsda()
 {
     FString FilePath = GetBridgeFilePath(TEXT("bridge_state.usda"));
-    FString Content;
+    FBridgeVerifiedFile File;
 
-    if (!FFileHelper::LoadFileToString(Content, *FilePath))
+    switch (ReadBridgeFile(FilePath, File))
     {
+    case EBridgeReadResult::Missing:
         return false;
+
+    case EBridgeReadResult::Torn:
+        // Caught Python mid-write: re-arm the debounce and read again once it settles
+        BRIDGE_LOG(Log, TEXT("bridge_state.usda failed integrity check, retrying once the writer settles"));
+        bStateChangePending = true;
+        TimeSinceLastStateChange = 0.0f;
+        return true;
+
+    case EBridgeReadResult::Ok:
+        break;
     }
 
+    // Unchanged payload (timestamp-only touch, or our own answer/ack write): nothing to do
+    if (File.Hash == LastStateHash)
+    {
+        return true;
+    }
+    LastStateHash = File.Hash;
+
+    const FString Content = MoveTemp(File.Content);
+
     FString SyncStatus = ParseUsdaVariant(Content, TEXT("sync_status"));
     FString MessageType = ParseUsdaVariant(Content, TEXT("message_type"));
 
     if (bVerboseLogging)
     {
-        BridgeLog(FString::Printf(TEXT("USD sync_status=%s, message_type=%s"), *SyncStatus, *MessageType));
+        BRIDGE_LOG(Log, TEXT("USD sync_status=%s, message_type=%s"), *SyncStatus, *MessageType);
     }
 
     if (MessageType == TEXT("ready"))
@@ -662,7 +755,7 @@ void UUEBridgeSubsystem::HandleUsdaReadyState(const FString& Content)
     int32 TotalQuestions = FCString::Atoi(*ParseUsdaAttribute(Content, TEXT("Ready"), TEXT("total_questions")));
     if (TotalQuestions <= 0) TotalQuestions = 8;
 
-    BridgeLog(FString::Printf(TEXT("USD Ready: %d questions"), TotalQuestions));
+    BRIDGE_LOG(Log, TEXT("USD Ready: %d questions"), TotalQuestions);
 
     bUsingUsdMode = true;
     SetState(EUEBridgeState::Connected);
@@ -694,9 +787,9 @@ void UUEBridgeSubsystem::HandleUsdaQuestionState(const FString& Content)
 
     CurrentQuestion.DepthLabel = GetDepthLabelForIndex(CurrentQuestion.Index);
 
-    BridgeLog(FString::Printf(TEXT("USD Question %d/%d [%s]: %s"),
+    BRIDGE_LOG(Log, TEXT("USD Question %d/%d [%s]: %s"),
         CurrentQuestion.Index + 1, CurrentQuestion.Total,
-        *CurrentQuestion.DepthLabel, *CurrentQuestion.QuestionId));
+        *CurrentQuestion.DepthLabel, *CurrentQuestion.QuestionId);
 
     CurrentStateJson = BuildQuestionJson();
     SetState(EUEBridgeState::QuestionActive);
@@ -710,8 +803,8 @@ void UUEBridgeSubsystem::HandleUsdaTransitionState(const FString& Content)
     FString NextScene = ParseUsdaAttribute(Content, TEXT("Transition"), TEXT("next_scene"));
     float Progress = FCString::Atof(*ParseUsdaAttribute(Content, TEXT("Transition"), TEXT("progress")));
 
-    BridgeLog(FString::Printf(TEXT("USD Transition: %s -> %s (%.0f%%)"),
-        *Direction, *NextScene, Progress * 100.0f));
+    BRIDGE_LOG(Log, TEXT("USD Transition: %s -> %s (%.0f%%)"),
+        *Direction, *NextScene, Progress * 100.0f);
 
     SetState(EUEBridgeState::Transitioning);
     OnTransitionReady.Broadcast(Direction, NextScene, Progress);
@@ -723,9 +816,14 @@ void UUEBridgeSubsystem::HandleUsdaFinaleState(const FString& Content)
     FString UsdPath = ParseUsdaAttribute(Content, TEXT("Finale"), TEXT("usd_path"));
     FString Message = ParseUsdaAttribute(Content, TEXT("Finale"), TEXT("message"));
 
-    BridgeLog(FString::Printf(TEXT("USD FINALE: %s"), *Message));
+    BRIDGE_LOG(Log, TEXT("USD FINALE: %s"), *Message);
 
     FUEBridgeProfile Profile = ParseCognitiveProfile(UsdPath);
+    LastProfile = Profile;
+    if (Profile.IsValid())
+    {
+        ProfileIndex->AddProfile(Profile);
+    }
 
     SetState(EUEBridgeState::Complete);
     OnProfileComplete.Broadcast(Profile, UsdPath);
@@ -943,12 +1041,118 @@ void UUEBridgeSubsystem::UpdateBehavioralSignals(FString& Content, float Respons
 
     if (bVerboseLogging)
     {
-        BridgeLog(FString::Printf(TEXT("[MoE] State=%s Expert=%s Burnout=%s Momentum=%s"),
-            *DetectedState, *RecommendedExpert, *BurnoutLevel, *MomentumPhase));
+        BRIDGE_LOG(Log, TEXT("[MoE] State=%s Expert=%s Burnout=%s Momentum=%s"),
+            *DetectedState, *RecommendedExpert, *BurnoutLevel, *MomentumPhase);
     }
 }
 
 
+// === PROFILE DELTAS ===
+
+void UUEBridgeSubsystem::UpdateProfileDelta(const FString& UsdPath)
+{
+    // Parsed on every change, listeners or not, so the baseline is always the last
+    // profile on disk and a listener's first delta is only the latest change
+    FUEBridgeProfile NewProfile = ParseCognitiveProfile(UsdPath);
+    if (NewProfile.Dimensions.Num() == 0 && NewProfile.Traits.Num() == 0)
+    {
+        // Unreadable or mid-write; keep the old baseline and wait for the next change
+        return;
+    }
+
+    FUEBridgeProfileDelta Delta = DiffProfiles(LastProfile, NewProfile);
+    Delta.SourcePath = UsdPath;
+    LastProfile = MoveTemp(NewProfile);
+
+    if (!OnUsdProfileDelta.IsBound())
+    {
+        return;
+    }
+
+    if (Delta.IsEmpty())
+    {
+        if (bVerboseLogging)
+        {
+            BRIDGE_LOG(Log, TEXT("Profile changed on disk but no dimension/trait changes"));
+        }
+        return;
+    }
+
+    BRIDGE_LOG(Log, TEXT("Profile delta: %d dimensions, +%d/-%d traits"),
+        Delta.ChangedDimensions.Num(), Delta.AddedTraits.Num(), Delta.RemovedTraits.Num());
+
+    OnUsdProfileDelta.Broadcast(Delta);
+}
+
+
+FUEBridgeProfileDelta UUEBridgeSubsystem::DiffProfiles(const FUEBridgeProfile& OldProfile, const FUEBridgeProfile& NewProfile)
+{
+    FUEBridgeProfileDelta Delta;
+    Delta.OldChecksum = OldProfile.Checksum;
+    Delta.NewChecksum = NewProfile.Checksum;
+
+    // Dimensions: changed or added
+    for (const auto& Pair : NewProfile.Dimensions)
+    {
+        const float* OldScore = OldProfile.Dimensions.Find(Pair.Key);
+        if (!OldScore)
+        {
+            FBridgeDimensionDelta& Entry = Delta.ChangedDimensions.AddDefaulted_GetRef();
+            Entry.Dimension = Pair.Key;
+            Entry.NewScore = Pair.Value;
+            Entry.bAdded = true;
+        }
+        else if (!FMath::IsNearlyEqual(*OldScore, Pair.Value))
+        {
+            FBridgeDimensionDelta& Entry = Delta.ChangedDimensions.AddDefaulted_GetRef();
+            Entry.Dimension = Pair.Key;
+            Entry.OldScore = *OldScore;
+            Entry.NewScore = Pair.Value;
+        }
+    }
+
+    // Dimensions: removed
+    for (const auto& Pair : OldProfile.Dimensions)
+    {
+        if (!NewProfile.Dimensions.Contains(Pair.Key))
+        {
+            FBridgeDimensionDelta& Entry = Delta.ChangedDimensions.AddDefaulted_GetRef();
+            Entry.Dimension = Pair.Key;
+            Entry.OldScore = Pair.Value;
+            Entry.bRemoved = true;
+        }
+    }
+
+    // Traits are identified by (dimension, label); a relabel is a remove + add.
+    // Score-only changes are already reported through the dimension list.
+    auto ContainsTrait = [](const TArray<FTranslatorsTrait>& Traits, const FTranslatorsTrait& Trait)
+    {
+        return Traits.ContainsByPredicate([&Trait](const FTranslatorsTrait& Other)
+        {
+            return Other.Dimension == Trait.Dimension && Other.Label == Trait.Label;
+        });
+    };
+
+    for (const FTranslatorsTrait& Trait : NewProfile.Traits)
+    {
+        if (!ContainsTrait(OldProfile.Traits, Trait))
+        {
+            Delta.AddedTraits.Add(Trait);
+        }
+    }
+
+    for (const FTranslatorsTrait& Trait : OldProfile.Traits)
+    {
+        if (!ContainsTrait(NewProfile.Traits, Trait))
+        {
+            Delta.RemovedTraits.Add(Trait);
+        }
+    }
+
+    return Delta;
+}
+
+
 // === DEPTH LABELS ===
 
 FString UUEBridgeSubsystem::GetDepthLabelForIndex(int32 Index)
@@ -970,16 +1174,49 @@ FUEBridgeProfile UUEBridgeSubsystem::ParseCognitiveProfile(const FString& UsdPat
 {
     FUEBridgeProfile Profile;
 
-    FString Content;
-    if (!FFileHelper::LoadFileToString(Content, *UsdPath))
+    // One read feeds both the integrity check and the cache key
+    FBridgeVerifiedFile File;
+    switch (ReadBridgeFile(UsdPath, File))
+    {
+    case EBridgeReadResult::Missing:
+        RaiseBridgeError(EBridgeErrorCode::ProfileParseFailure,
+            FString::Printf(TEXT("Cannot read %s (unreadable)"), *UsdPath));
+        return Profile;
+
+    case EBridgeReadResult::Torn:
+        // Caught Python mid-write: not an error, re-arm the profile debounce and parse again
+        BRIDGE_LOG(Log, TEXT("%s failed integrity check, retrying once the writer settles"), *UsdPath);
+        bUsdChangePending = true;
+        TimeSinceLastUsdChange = 0.0f;
+        return Profile;
+
+    case EBridgeReadResult::Ok:
+        break;
+    }
+
+    // Same payload as the last parse: reuse it outright
+    if (File.Hash == CachedProfileHash && CachedProfile.IsValid())
     {
-        BridgeLog(FString::Printf(TEXT("Could not read profile: %s"), *UsdPath));
-        OnBridgeError.Broadcast(EBridgeErrorCode::ProfileParseFailure,
-            FString::Printf(TEXT("Cannot read %s"), *UsdPath));
+        Profile = CachedProfile;
+        Profile.UsdExportPath = UsdPath;
         return Profile;
     }
 
-    BridgeLog(FString::Printf(TEXT("Parsing cognitive profile from: %s"), *UsdPath));
+    // Then the binary cache written by a previous parse of this same payload
+    const FString BinaryPath = FBridgeProfileBinary::GetBinaryPath(UsdPath);
+    if (FBridgeProfileBinary::Load(BinaryPath, File.Hash, Profile))
+    {
+        Profile.UsdExportPath = UsdPath;
+        BRIDGE_LOG(Log, TEXT("Loaded binary profile: %d traits, checksum=%s"),
+            Profile.Traits.Num(), *Profile.Checksum);
+        CachedProfile = Profile;
+        CachedProfileHash = File.Hash;
+        return Profile;
+    }
+
+    const FString Content = MoveTemp(File.Content);
+
+    BRIDGE_LOG(Log, TEXT("Parsing cognitive profile from: %s"), *UsdPath);
     Profile.UsdExportPath = UsdPath;
     Profile.GeneratorVersion = TEXT("2.1.0");
 
@@ -1013,8 +1250,9 @@ FUEBridgeProfile UUEBridgeSubsystem::ParseCognitiveProfile(const FString& UsdPat
         }
     }
 
-    // Parse Profile dimensions
+    // Parse Profile dimensions (raw text kept for checksum verification)
     TMap<FString, float> DimensionScores;
+    TMap<FString, FString> RawDimensionValues;
     TMap<FString, FString> TraitLabels;
 
     {
@@ -1039,7 +1277,9 @@ FUEBridgeProfile UUEBridgeSubsystem::ParseCognitiveProfile(const FString& UsdPat
                 while (Matcher.FindNext())
                 {
                     FString Name = Matcher.GetCaptureGroup(1);
-                    float Value = FCString::Atof(*Matcher.GetCaptureGroup(2));
+                    FString RawValue = Matcher.GetCaptureGroup(2);
+                    float Value = FCString::Atof(*RawValue);
+                    RawDimensionValues.Add(Name, RawValue);
                     DimensionScores.Add(Name, Value);
                     Profile.Dimensions.Add(Name, Value);
                 }
@@ -1136,8 +1376,32 @@ FUEBridgeProfile UUEBridgeSubsystem::ParseCognitiveProfile(const FString& UsdPat
         }
     }
 
-    BridgeLog(FString::Printf(TEXT("Parsed profile: %d traits, %d insights, checksum=%s"),
-        Profile.Traits.Num(), Profile.Insights.Num(), *Profile.Checksum));
+    // The exporter hashes the dimensions it was given; defaults it filled in for
+    // unanswered questions legitimately differ, so a mismatch is reported, not fatal
+    if (!Profile.Checksum.IsEmpty())
+    {
+        const FString Computed = FBridgeIntegrity::ComputeProfileChecksum(RawDimensionValues);
+        Profile.bChecksumVerified = Computed.Equals(Profile.Checksum, ESearchCase::IgnoreCase);
+        if (!Profile.bChecksumVerified)
+        {
+            BRIDGE_LOG(Warning, TEXT("Profile checksum mismatch: file=%s computed=%s"),
+                *Profile.Checksum, *Computed);
+        }
+    }
+
+    BRIDGE_LOG(Log, TEXT("Parsed profile: %d traits, %d insights, checksum=%s"),
+        Profile.Traits.Num(), Profile.Insights.Num(), *Profile.Checksum);
+
+    // Cache the parse so the next load of this payload skips text parsing
+    if (Profile.IsValid())
+    {
+        CachedProfile = Profile;
+        CachedProfileHash = File.Hash;
+        if (!FBridgeProfileBinary::Save(Profile, BinaryPath, File.Hash))
+        {
+            BRIDGE_LOG(Warning, TEXT("Could not write binary profile cache: %s"), *BinaryPath);
+        }
+    }
 
     return Profile;
 }
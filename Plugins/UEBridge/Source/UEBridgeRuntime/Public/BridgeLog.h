@@ -0,0 +1,87 @@
+// BridgeLog.h
+// Deferred-format logging for the bridge.
+//
+// BRIDGE_LOG(Verbosity, TEXT("fmt"), Args...) does nothing, arguments included,
+// unless LogUEBridge has the verbosity enabled. When it has, the message is
+// formatted once and that text goes to UE_LOG and to whichever of the two
+// optional sinks is switched on:
+//   - on-screen echo (UUEBridgeSubsystem::bVerboseLogging, non-shipping)
+//   - a lock-free ring of recent events, dumped when the bridge raises an error
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UEBridgeRuntime.h"
+
+/** One captured log event */
+struct FBridgeLogEvent
+{
+    /** Monotonic index of the event since startup */
+    uint64 Sequence = 0;
+
+    /** FPlatformTime::Seconds() when the event was logged */
+    double TimeSeconds = 0.0;
+
+    ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+
+    /** Message text, truncated to FBridgeLog::MaxMessageLength characters */
+    FString Message;
+};
+
+
+class UEBRIDGERUNTIME_API FBridgeLog
+{
+public:
+    /** Events kept by the ring (power of two) */
+    static constexpr int32 RingCapacity = 128;
+
+    /** Longer messages are truncated in the ring; UE_LOG still gets the full text */
+    static constexpr int32 MaxMessageLength = 200;
+
+    static void SetOnScreenEcho(bool bEnabled);
+    static void SetCaptureEnabled(bool bEnabled);
+    static bool IsCaptureEnabled();
+
+    /** Cheap check used by BRIDGE_LOG before handing its message to the secondary sinks */
+    static FORCEINLINE bool WantsSecondarySinks()
+    {
+        return SinkFlags.Load(EMemoryOrder::Relaxed) != 0;
+    }
+
+    /** Hand an already formatted message to whichever secondary sinks are enabled */
+    static void Dispatch(ELogVerbosity::Type Verbosity, const FString& Message);
+
+    /** Snapshot of the captured events, oldest first. Safe to call from any thread. */
+    static TArray<FBridgeLogEvent> GetRecentEvents();
+
+    /** Write the captured events to the log under a header naming Reason */
+    static void DumpRecent(const FString& Reason);
+
+private:
+    enum ESinkFlags : uint32
+    {
+        SINK_OnScreen = 1 << 0,
+        SINK_Capture = 1 << 1
+    };
+
+    static void SetSinkFlag(uint32 Flag, bool bEnabled);
+    static void Capture(ELogVerbosity::Type Verbosity, const FString& Message);
+
+    static TAtomic<uint32> SinkFlags;
+};
+
+
+/** Log through LogUEBridge. Format must be a TEXT() literal; arguments are evaluated once, and only if the verbosity is enabled. */
+#define BRIDGE_LOG(Verbosity, Format, ...) \
+    do \
+    { \
+        if (UE_LOG_ACTIVE(LogUEBridge, Verbosity)) \
+        { \
+            const FString BridgeLogMessage = FString::Printf(Format, ##__VA_ARGS__); \
+            UE_LOG(LogUEBridge, Verbosity, TEXT("[Bridge] %s"), *BridgeLogMessage); \
+            if (FBridgeLog::WantsSecondarySinks()) \
+            { \
+                FBridgeLog::Dispatch(ELogVerbosity::Verbosity, BridgeLogMessage); \
+            } \
+        } \
+    } while (0)
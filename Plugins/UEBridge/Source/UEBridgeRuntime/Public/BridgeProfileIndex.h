@@ -0,0 +1,120 @@
+// BridgeProfileIndex.h
+// In-memory store of many cognitive profiles for kiosk-style local history.
+//
+// Profiles are kept row-wise for retrieval and column-wise (one float column
+// per dimension, e.g. cognitive_density, processing_pace) for queries, so
+// range filters and nearest-neighbour scans run 4 rows per SIMD register
+// through UE's VectorRegister layer (SSE/NEON/scalar fallback).
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BridgeTypes.h"
+#include "BridgeProfileIndex.generated.h"
+
+/** Inclusive score range on one dimension. Multiple ranges in a query are AND-ed. */
+USTRUCT(BlueprintType, meta = (ToolTip = "Inclusive score range on one cognitive dimension"))
+struct UEBRIDGERUNTIME_API FBridgeDimensionRange
+{
+    GENERATED_BODY()
+
+    /** Dimension identifier (e.g. "processing_pace") */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Translators", meta = (ToolTip = "Cognitive dimension identifier"))
+    FString Dimension;
+
+    /** Lowest accepted score */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Translators", meta = (ToolTip = "Lowest accepted score (inclusive)"))
+    float Min = 0.0f;
+
+    /** Highest accepted score */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Translators", meta = (ToolTip = "Highest accepted score (inclusive)"))
+    float Max = 1.0f;
+};
+
+
+/** One result of a nearest-neighbour query */
+USTRUCT(BlueprintType, meta = (ToolTip = "Nearest-neighbour match in the profile index"))
+struct UEBRIDGERUNTIME_API FBridgeProfileMatch
+{
+    GENERATED_BODY()
+
+    /** Row index in the profile index (use GetProfile to fetch it) */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Row index in the profile index"))
+    int32 Index = INDEX_NONE;
+
+    /** Checksum of the matched profile */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Checksum of the matched profile"))
+    FString Checksum;
+
+    /** Euclidean distance over the queried dimensions */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Euclidean distance over the queried dimensions"))
+    float Distance = 0.0f;
+
+    /** 1 = identical, 0 = maximally distant (scores are normalized 0-1) */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Similarity from 0 (far) to 1 (identical)"))
+    float Similarity = 0.0f;
+};
+
+
+UCLASS(BlueprintType)
+class UEBRIDGERUNTIME_API UBridgeProfileIndex : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // === STORAGE ===
+
+    /** Add a profile; returns its row index. Dimensions missing from the profile read as 0.5 (neutral). */
+    UFUNCTION(BlueprintCallable, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Add a profile to the index"))
+    int32 AddProfile(const FUEBridgeProfile& Profile);
+
+    /** Remove every profile and column */
+    UFUNCTION(BlueprintCallable, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Remove all profiles from the index"))
+    void Clear();
+
+    /** Number of stored profiles */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Number of stored profiles"))
+    int32 Num() const { return NumRows; }
+
+    /** Get a stored profile by row index */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Get a stored profile by row index"))
+    FUEBridgeProfile GetProfile(int32 Index) const;
+
+    /** Dimension names, one per column */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Dimension names indexed as columns"))
+    TArray<FString> GetDimensionNames() const { return ColumnNames; }
+
+    // === QUERIES ===
+
+    /** Row indices of profiles matching all ranges (e.g. processing_pace 0.7-1.0 AND feedback_style 0.0-0.3) */
+    UFUNCTION(BlueprintCallable, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Find profiles whose dimensions fall inside all given ranges"))
+    TArray<int32> Filter(const TArray<FBridgeDimensionRange>& Ranges) const;
+
+    /** K nearest profiles to a dimension vector. Only dimensions present in Query are compared. */
+    UFUNCTION(BlueprintCallable, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Find the K most similar profiles to a set of dimension scores"))
+    TArray<FBridgeProfileMatch> FindNearest(const TMap<FString, float>& Query, int32 K = 5) const;
+
+    /** K nearest profiles to another profile's dimension vector */
+    UFUNCTION(BlueprintCallable, Category = "UE Bridge|Profile Index", meta = (ToolTip = "Find the K most similar stored profiles to a profile"))
+    TArray<FBridgeProfileMatch> FindNearestToProfile(const FUEBridgeProfile& Profile, int32 K = 5) const
+    {
+        return FindNearest(Profile.Dimensions, K);
+    }
+
+private:
+    int32 FindOrAddColumn(const FString& Dimension);
+    void ReserveRows(int32 RowCapacity);
+
+    /** Score used for dimensions a profile does not define (matches the Python exporter default) */
+    static constexpr float DefaultScore = 0.5f;
+
+    /** Rows per SIMD register; columns are padded to a multiple of this with NaN */
+    static constexpr int32 LaneCount = 4;
+
+    TArray<FUEBridgeProfile> Profiles;
+    TArray<FString> ColumnNames;
+    TMap<FString, int32> ColumnLookup;
+    TArray<TArray<float>> Columns;
+    int32 NumRows = 0;
+};
@@ -213,11 +213,78 @@ struct UEBRIDGERUNTIME_API FUEBridgeProfile
     UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Bridge version that generated this profile"))
     FString GeneratorVersion;
 
+    /** True if Checksum matches the DJB2 of the dimension values in the file */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "True if the checksum matches the parsed dimension values"))
+    bool bChecksumVerified = false;
+
     /** Returns true if profile has been populated */
     bool IsValid() const { return Traits.Num() > 0 && !Checksum.IsEmpty(); }
 };
 
 
+/** Score change for a single cognitive dimension between two parsed profiles */
+USTRUCT(BlueprintType, meta = (ToolTip = "Score change for a single cognitive dimension"))
+struct UEBRIDGERUNTIME_API FBridgeDimensionDelta
+{
+    GENERATED_BODY()
+
+    /** Dimension identifier (e.g. "processing_pace") */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Cognitive dimension identifier"))
+    FString Dimension;
+
+    /** Score before the change (0 if the dimension was added) */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Score before the change"))
+    float OldScore = 0.0f;
+
+    /** Score after the change (0 if the dimension was removed) */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Score after the change"))
+    float NewScore = 0.0f;
+
+    /** Dimension did not exist in the previous profile */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "True if the dimension is new"))
+    bool bAdded = false;
+
+    /** Dimension no longer exists in the current profile */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "True if the dimension was removed"))
+    bool bRemoved = false;
+};
+
+
+/** Dimension/trait-level difference between the last parsed profile and the current one */
+USTRUCT(BlueprintType, meta = (ToolTip = "Dimension and trait level changes between two profile revisions"))
+struct UEBRIDGERUNTIME_API FUEBridgeProfileDelta
+{
+    GENERATED_BODY()
+
+    /** Disk path of the profile file that changed */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Profile file that changed"))
+    FString SourcePath;
+
+    /** Dimensions whose score was added, removed, or changed */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Dimensions with a changed score"))
+    TArray<FBridgeDimensionDelta> ChangedDimensions;
+
+    /** Traits present now but not in the previous profile (a relabelled trait appears here and in RemovedTraits) */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Traits added since the last revision"))
+    TArray<FTranslatorsTrait> AddedTraits;
+
+    /** Traits present in the previous profile but not now */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Traits removed since the last revision"))
+    TArray<FTranslatorsTrait> RemovedTraits;
+
+    /** Checksum of the previous profile (empty on first parse) */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Checksum of the previous profile"))
+    FString OldChecksum;
+
+    /** Checksum of the current profile */
+    UPROPERTY(BlueprintReadOnly, Category = "Translators", meta = (ToolTip = "Checksum of the current profile"))
+    FString NewChecksum;
+
+    /** Returns true if nothing changed at the dimension or trait level */
+    bool IsEmpty() const { return ChangedDimensions.Num() == 0 && AddedTraits.Num() == 0 && RemovedTraits.Num() == 0; }
+};
+
+
 /** Accumulated behavioral signals for ADHD_MoE expert routing */
 USTRUCT(BlueprintType, meta = (ToolTip = "Accumulated behavioral signals for MoE expert routing"))
 struct UEBRIDGERUNTIME_API FBehavioralSignals
@@ -291,3 +358,6 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBridgeError, EBridgeErrorCode, E
 
 /** Fired when a USD profile file changes on disk */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUsdProfileUpdated, const FString&, UpdatedFilePath);
+
+/** Fired after a USD profile change with only the dimensions and traits that changed */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUsdProfileDelta, const FUEBridgeProfileDelta&, Delta);
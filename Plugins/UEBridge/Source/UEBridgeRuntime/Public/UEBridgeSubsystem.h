@@ -13,6 +13,10 @@
 #include "BridgeTypes.h"
 #include "UEBridgeSubsystem.generated.h"
 
+class UBridgeProfileIndex;
+struct FBridgeVerifiedFile;
+enum class EBridgeReadResult : uint8;
+
 UCLASS()
 class UEBRIDGERUNTIME_API UUEBridgeSubsystem
     : public UGameInstanceSubsystem
@@ -80,6 +84,14 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge", meta = (ToolTip = "True if using USD-native transport mode"))
     bool IsUsingUsdMode() const { return bUsingUsdMode; }
 
+    /** Get the last parsed cognitive profile (baseline for OnUsdProfileDelta) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge", meta = (ToolTip = "Get the most recently parsed cognitive profile"))
+    FUEBridgeProfile GetLastParsedProfile() const { return LastProfile; }
+
+    /** Get the in-memory index of profiles completed this session (kiosk history) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge", meta = (ToolTip = "Get the in-memory profile index for range and similarity queries"))
+    UBridgeProfileIndex* GetProfileIndex() const { return ProfileIndex; }
+
     /** Get the bridge exchange directory path */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UE Bridge", meta = (ToolTip = "Get the bridge exchange directory path"))
     FString GetBridgePath() const { return BridgePath; }
@@ -110,6 +122,10 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "UE Bridge|Events")
     FOnUsdProfileUpdated OnUsdProfileUpdated;
 
+    /** Fired after a USD profile change with only the changed dimensions and traits */
+    UPROPERTY(BlueprintAssignable, Category = "UE Bridge|Events")
+    FOnUsdProfileDelta OnUsdProfileDelta;
+
     // === CONFIGURATION ===
 
     /** Debounce time in seconds for file change detection */
@@ -124,6 +140,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UE Bridge|Config")
     bool bVerboseLogging = false;
 
+    /** Keep recent bridge log events in memory and dump them to the log when an error is raised */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UE Bridge|Config")
+    bool bCaptureRecentLog = false;
+
+    /** Write the captured recent log events to the output log */
+    UFUNCTION(BlueprintCallable, Category = "UE Bridge", meta = (ToolTip = "Dump recently captured bridge log events to the output log"))
+    void DumpRecentLog() const;
+
     /** Notify the subsystem that a file in the bridge directory changed.
      *  Called by BridgeEditorSubsystem in editor builds or by external code. */
     void NotifyFileChanged(const FString& Filename, bool bIsUsdProfile);
@@ -134,11 +158,16 @@ private:
     void SetState(EUEBridgeState NewState);
     FString ResolveBridgePath() const;
     FString GetBridgeFilePath(const FString& Filename) const;
-    void BridgeLog(const FString& Message) const;
+    void SyncLogSinks() const;
+    void RaiseBridgeError(EBridgeErrorCode Code, const FString& Message);
 
     // === FILE I/O ===
 
     void ProcessStateFile();
+
+    /** Read an exchange file through the integrity stage. A path that has carried a footer must
+     *  keep carrying one; after MaxTornReads torn reads in a row it is read unverified instead. */
+    EBridgeReadResult ReadBridgeFile(const FString& Path, FBridgeVerifiedFile& OutFile);
     void WriteJsonToFile(const FString& Filename, const TSharedPtr<FJsonObject>& JsonObj);
 
     // === JSON STATE HANDLERS ===
@@ -165,6 +194,11 @@ private:
 
     void UpdateBehavioralSignals(FString& Content, float ResponseTimeMs);
 
+    // === PROFILE DELTAS ===
+
+    void UpdateProfileDelta(const FString& UsdPath);
+    static FUEBridgeProfileDelta DiffProfiles(const FUEBridgeProfile& OldProfile, const FUEBridgeProfile& NewProfile);
+
     // === DEPTH LABELS ===
 
     static FString GetDepthLabelForIndex(int32 Index);
@@ -179,6 +213,22 @@ private:
     bool bIsActive = false;
     bool bUsingUsdMode = false;
 
+    // Last parsed profile, diffed against on every profile change
+    FUEBridgeProfile LastProfile;
+
+    // Integrity stage (see BridgeIntegrity.h). Payload hashes double as cache keys.
+    // Paths Python has been seen sealing, and consecutive torn reads per path
+    TSet<FString> SealedPaths;
+    TMap<FString, int32> TornReads;
+    static constexpr int32 MaxTornReads = 5;
+    uint64 LastStateHash = 0;
+    uint64 CachedProfileHash = 0;
+    FUEBridgeProfile CachedProfile;
+
+    // Completed profiles, kept for range/similarity queries within this editor session
+    UPROPERTY()
+    TObjectPtr<UBridgeProfileIndex> ProfileIndex;
+
     // Response time history for behavioral signal computation
     TArray<float> ResponseTimes;
 
@@ -9,13 +9,24 @@
 #include "RHISurfaceDataConversion.h"
 
 FFrameProducer::FFrameProducer()
-	: FrameCounter(0)
+	: NumTickets(0)
+	, FrameCounter(0)
 {
 }
 
 FFrameProducer::~FFrameProducer()
 {
 	Stop();
+	Unhook();
+
+	// Nobody will capture for these any more
+	FScopeLock Lock(&TicketLock);
+	for (FCaptureTicket& Ticket : Tickets)
+	{
+		Ticket.Promise.SetValue(0);
+	}
+	Tickets.Empty();
+	NumTickets = 0;
 }
 
 void FFrameProducer::Start(FPixelBus* InPixelBus)
@@ -28,18 +39,11 @@ void FFrameProducer::Start(FPixelBus* InPixelBus)
 	check(InPixelBus);
 	PixelBus = InPixelBus;
 
-	if (FSlateApplication::IsInitialized())
+	if (Hook())
 	{
-		DelegateHandle = FSlateApplication::Get().GetRenderer()->OnBackBufferReadyToPresent().AddRaw(
-			this, &FFrameProducer::OnFrameBufferReady);
-
 		bActive = true;
 		UE_LOG(LogViewportPerception, Log, TEXT("FrameProducer started (interval=%.2fs)"), MinCaptureInterval);
 	}
-	else
-	{
-		UE_LOG(LogViewportPerception, Warning, TEXT("Slate not initialized, cannot hook backbuffer"));
-	}
 }
 
 void FFrameProducer::Stop()
@@ -49,15 +53,76 @@ void FFrameProducer::Stop()
 		return;
 	}
 
+	bActive = false;
+
+	// Stay hooked for outstanding tickets; ReleaseIdleHook unhooks once they resolve
+	if (NumTickets.Load() == 0)
+	{
+		Unhook();
+	}
+	UE_LOG(LogViewportPerception, Log, TEXT("FrameProducer stopped"));
+}
+
+TFuture<int64> FFrameProducer::RequestCapture(FPixelBus* InPixelBus)
+{
+	check(InPixelBus);
+
+	FCaptureTicket Ticket;
+	TFuture<int64> Future = Ticket.Promise.GetFuture();
+
+	if (!PixelBus)
+	{
+		PixelBus = InPixelBus;
+	}
+
+	if (!Hook())
+	{
+		Ticket.Promise.SetValue(0);
+		return Future;
+	}
+
+	Ticket.RequestFrame = GFrameNumber;
+	{
+		FScopeLock Lock(&TicketLock);
+		Tickets.Add(MoveTemp(Ticket));
+		NumTickets = Tickets.Num();
+	}
+	return Future;
+}
+
+void FFrameProducer::ReleaseIdleHook()
+{
+	if (!bActive && NumTickets.Load() == 0)
+	{
+		Unhook();
+	}
+}
+
+bool FFrameProducer::Hook()
+{
+	if (DelegateHandle.IsValid())
+	{
+		return true;
+	}
+
+	if (!FSlateApplication::IsInitialized())
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Slate not initialized, cannot hook backbuffer"));
+		return false;
+	}
+
+	DelegateHandle = FSlateApplication::Get().GetRenderer()->OnBackBufferReadyToPresent().AddRaw(
+		this, &FFrameProducer::OnFrameBufferReady);
+	return true;
+}
+
+void FFrameProducer::Unhook()
+{
 	if (FSlateApplication::IsInitialized() && DelegateHandle.IsValid())
 	{
 		FSlateApplication::Get().GetRenderer()->OnBackBufferReadyToPresent().Remove(DelegateHandle);
-		DelegateHandle.Reset();
 	}
-
-	bActive = false;
-	PixelBus = nullptr;
-	UE_LOG(LogViewportPerception, Log, TEXT("FrameProducer stopped"));
+	DelegateHandle.Reset();
 }
 
 void FFrameProducer::SetThrottleInterval(double Seconds)
@@ -69,9 +134,20 @@ void FFrameProducer::OnFrameBufferReady(SWindow& SlateWindow, const FTextureRHIR
 {
 	// This runs on the render thread -- must be fast when skipping
 
-	// Throttle gate: skip if too soon since last capture
+	// A ticket is due once a frame that started after it reaches the backbuffer
+	bool bTicketDue = false;
+	if (NumTickets.Load() > 0)
+	{
+		FScopeLock Lock(&TicketLock);
+		bTicketDue = Tickets.ContainsByPredicate([](const FCaptureTicket& Ticket)
+		{
+			return GFrameNumberRenderThread > Ticket.RequestFrame;
+		});
+	}
+
+	// Throttle gate: skip if too soon since last capture (tickets go straight through)
 	const double Now = FPlatformTime::Seconds();
-	if ((Now - LastCaptureTime) < MinCaptureInterval)
+	if (!bTicketDue && (!bActive || (Now - LastCaptureTime) < MinCaptureInterval))
 	{
 		return;
 	}
@@ -82,13 +158,22 @@ void FFrameProducer::OnFrameBufferReady(SWindow& SlateWindow, const FTextureRHIR
 	}
 
 	LastCaptureTime = Now;
+
+	// Recycled buffer from the bus pool; no heap allocation once the pool is warm
+	const FIntPoint Size = FrameBuffer->GetSizeXY();
+	FPerceptionFrameRef Frame = PixelBus->AcquireFrame(Size);
+	if (!Frame.IsValid())
+	{
+		// Every pooled frame is still held by readers, or the memory budget is spent
+		return;
+	}
+
 	const int64 PrevFrame = FrameCounter.Load();
 	const int64 CurrentFrame = PrevFrame + 1;
 	FrameCounter.Store(CurrentFrame);
 
 	// Read the backbuffer pixels
-	const FIntPoint Size = FrameBuffer->GetSizeXY();
-	TArray<FColor> Pixels;
+	FPerceptionFrame& Target = Frame.Edit();
 
 	FReadSurfaceDataFlags ReadFlags(RCM_UNorm);
 	ReadFlags.SetLinearToGamma(false);
@@ -98,12 +183,30 @@ void FFrameProducer::OnFrameBufferReady(SWindow& SlateWindow, const FTextureRHIR
 	RHICmdList.ReadSurfaceData(
 		FrameBuffer,
 		FIntRect(0, 0, Size.X, Size.Y),
-		Pixels,
+		Target.Pixels,
 		ReadFlags
 	);
 
-	if (Pixels.Num() > 0)
+	if (Target.Pixels.Num() > 0)
 	{
-		PixelBus->WriteFrame(MoveTemp(Pixels), Size, CurrentFrame, Now);
+		Target.Size = Size;
+		Target.FrameNumber = CurrentFrame;
+		Target.Timestamp = Now;
+		PixelBus->WriteFrame(MoveTemp(Frame));
+
+		// Every due ticket shares this capture; tickets taken since wait for the next frame
+		if (bTicketDue)
+		{
+			FScopeLock Lock(&TicketLock);
+			for (int32 i = Tickets.Num() - 1; i >= 0; --i)
+			{
+				if (GFrameNumberRenderThread > Tickets[i].RequestFrame)
+				{
+					Tickets[i].Promise.SetValue(CurrentFrame);
+					Tickets.RemoveAtSwap(i);
+				}
+			}
+			NumTickets = Tickets.Num();
+		}
 	}
 }
@@ -1,11 +1,13 @@
 // FrameProducer.h
 // Hooks the backbuffer presentation and performs GPU->CPU readback.
 // Runs the readback on the render thread with a throttle gate.
+// One-shot capture tickets bypass the gate and work while capture is stopped.
 
 #pragma once
 
 #include "CoreMinimal.h"
 #include "RHI.h"
+#include "Async/Future.h"
 
 class FPixelBus;
 
@@ -27,13 +29,36 @@ public:
 	/** True if currently hooked and capturing. */
 	bool IsActive() const { return bActive; }
 
+	/** Capture one backbuffer from a frame that starts rendering after this call, whether
+	 *  or not capture is started and regardless of the throttle. Tickets taken before that
+	 *  capture share it. Resolves on the render thread with the frame number written to the
+	 *  bus, or 0 if the producer is destroyed first. Game thread. */
+	TFuture<int64> RequestCapture(FPixelBus* InPixelBus);
+
+	/** Unhook the backbuffer delegate if it is only still installed for resolved tickets. Game thread. */
+	void ReleaseIdleHook();
+
 private:
 	/** Called on the render thread when the backbuffer is ready. */
 	void OnFrameBufferReady(SWindow& SlateWindow, const FTextureRHIRef& FrameBuffer);
 
+	bool Hook();
+	void Unhook();
+
+	struct FCaptureTicket
+	{
+		/** Game frame the ticket was taken in; satisfied by any later frame */
+		uint32 RequestFrame = 0;
+		TPromise<int64> Promise;
+	};
+
 	FDelegateHandle DelegateHandle;
 	FPixelBus* PixelBus = nullptr;
 
+	FCriticalSection TicketLock;
+	TArray<FCaptureTicket> Tickets;
+	TAtomic<int32> NumTickets;
+
 	double MinCaptureInterval = 0.2;  // 5 fps default
 	double LastCaptureTime = 0.0;
 	TAtomic<int64> FrameCounter;
@@ -11,6 +11,66 @@
 #include "LevelEditor.h"
 #include "SLevelViewport.h"
 #include "ILevelEditor.h"
+#include "SceneView.h"
+#include "UnrealClient.h"
+
+namespace
+{
+	/** Screen bounds of Actors' bounding boxes in ViewportClient's view, as fractions of the viewport
+	 *  clipped to [0, 1]. Corners behind the camera are left out, so an actor the camera is inside
+	 *  only contributes what is in front of it. Invalid if nothing lands on screen. */
+	FBox2D ProjectSelectionBounds(FEditorViewportClient& ViewportClient, const TArray<AActor*>& Actors)
+	{
+		FBox2D Bounds(ForceInit);
+		FViewport* Viewport = ViewportClient.Viewport;
+		if (Actors.Num() == 0 || !Viewport || !ViewportClient.GetScene())
+		{
+			return Bounds;
+		}
+
+		const FIntPoint ViewSize = Viewport->GetSizeXY();
+		if (ViewSize.X <= 0 || ViewSize.Y <= 0)
+		{
+			return Bounds;
+		}
+
+		FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
+			Viewport, ViewportClient.GetScene(), ViewportClient.EngineShowFlags));
+		const FSceneView* View = ViewportClient.CalcSceneView(&ViewFamily);
+		if (!View)
+		{
+			return Bounds;
+		}
+
+		const FMatrix ViewProjection = View->ViewMatrices.GetViewProjectionMatrix();
+		const FVector2D Scale(1.0 / ViewSize.X, 1.0 / ViewSize.Y);
+		for (const AActor* Actor : Actors)
+		{
+			FVector Origin, Extent;
+			Actor->GetActorBounds(false, Origin, Extent);
+			for (int32 Corner = 0; Corner < 8; ++Corner)
+			{
+				const FVector Point = Origin + Extent * FVector((Corner & 1) ? 1.0 : -1.0,
+				                                                (Corner & 2) ? 1.0 : -1.0,
+				                                                (Corner & 4) ? 1.0 : -1.0);
+				FVector2D ScreenPos;
+				if (FSceneView::ProjectWorldToScreen(Point, View->UnscaledViewRect, ViewProjection, ScreenPos))
+				{
+					Bounds += ScreenPos * Scale;
+				}
+			}
+		}
+
+		if (!Bounds.bIsValid || Bounds.Max.X < 0.0 || Bounds.Max.Y < 0.0 || Bounds.Min.X > 1.0 || Bounds.Min.Y > 1.0)
+		{
+			return FBox2D(ForceInit);
+		}
+
+		Bounds.Min = FVector2D(FMath::Clamp(Bounds.Min.X, 0.0, 1.0), FMath::Clamp(Bounds.Min.Y, 0.0, 1.0));
+		Bounds.Max = FVector2D(FMath::Clamp(Bounds.Max.X, 0.0, 1.0), FMath::Clamp(Bounds.Max.Y, 0.0, 1.0));
+		return Bounds;
+	}
+}
 
 FPerceptionMetadata FMetadataCollector::Collect()
 {
@@ -62,6 +122,7 @@ FPerceptionMetadata FMetadataCollector::Collect()
 		}
 
 		// Selected actors
+		TArray<AActor*> SelectedActors;
 		USelection* Selection = GEditor->GetSelectedActors();
 		if (Selection)
 		{
@@ -71,10 +132,17 @@ FPerceptionMetadata FMetadataCollector::Collect()
 				if (Actor)
 				{
 					Meta.SelectedActors.Add(Actor->GetActorLabel());
+					SelectedActors.Add(Actor);
 				}
 			}
 		}
 
+		// Where the selection is on screen, for region requests around it
+		if (ViewportClient)
+		{
+			Meta.SelectionBounds = ProjectSelectionBounds(*ViewportClient, SelectedActors);
+		}
+
 		// Map name and actor count
 		UWorld* World = GEditor->GetEditorWorldContext().World();
 		if (World)
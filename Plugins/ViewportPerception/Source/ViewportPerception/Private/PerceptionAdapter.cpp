@@ -1,13 +1,318 @@
 // PerceptionAdapter.cpp
 
 #include "PerceptionAdapter.h"
+#include "PerceptionResampler.h"
 #include "ViewportPerceptionModule.h"
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
 #include "Modules/ModuleManager.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	#define PERCEPTION_STATS_NEON 1
+	#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#define PERCEPTION_STATS_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#ifndef PERCEPTION_STATS_NEON
+	#define PERCEPTION_STATS_NEON 0
+#endif
+#ifndef PERCEPTION_STATS_SSE2
+	#define PERCEPTION_STATS_SSE2 0
+#endif
+
+namespace
+{
+	/** Bands shorter than this cost more to schedule than they save */
+	constexpr int32 MinRowsPerBand = 32;
+
+	/** Split rows [0, Rows) into at most MaxWorkers contiguous bands and run them on the task graph.
+	 *  The calling thread works one band itself; small images stay on the calling thread. */
+	void ForEachRowBand(int32 Rows, int32 MaxWorkers, TFunctionRef<void(int32 RowBegin, int32 RowEnd)> Body)
+	{
+		if (Rows <= 0)
+		{
+			return;
+		}
+
+		const int32 Bands = FMath::Clamp(FMath::Min(MaxWorkers, Rows / MinRowsPerBand), 1, Rows);
+		if (Bands == 1)
+		{
+			Body(0, Rows);
+			return;
+		}
+
+		ParallelFor(TEXT("PerceptionAdapter.RowBands"), Bands, 1, [Rows, Bands, &Body](int32 Band)
+		{
+			const int32 RowBegin = static_cast<int32>(static_cast<int64>(Rows) * Band / Bands);
+			const int32 RowEnd = static_cast<int32>(static_cast<int64>(Rows) * (Band + 1) / Bands);
+			Body(RowBegin, RowEnd);
+		});
+	}
+
+	/** Copy pixels with alpha forced opaque, optionally swapping BGRA to RGBA.
+	 *  Plain 32-bit masks and shifts, which compilers vectorize. */
+	void PreparePixels(const FColor* Source, FColor* Dest, int64 Count, bool bSwapRedBlue)
+	{
+		const uint32* In = reinterpret_cast<const uint32*>(Source);
+		uint32* Out = reinterpret_cast<uint32*>(Dest);
+		if (bSwapRedBlue)
+		{
+			for (int64 i = 0; i < Count; ++i)
+			{
+				const uint32 V = In[i];
+				Out[i] = (V & 0x0000FF00u) | ((V >> 16) & 0xFFu) | ((V & 0xFFu) << 16) | 0xFF000000u;
+			}
+		}
+		else
+		{
+			for (int64 i = 0; i < Count; ++i)
+			{
+				Out[i] = In[i] | 0xFF000000u;
+			}
+		}
+	}
+}
+
+namespace
+{
+	constexpr int32 LumaHistogramBins = 32;
+	constexpr int32 EdgeThreshold = 24;
+	constexpr int32 OverexposedLuma = 250;
+	constexpr int32 UnderexposedLuma = 5;
+
+	/** Partial sums of one row band for ComputeImageStats. Channels are in memory order (B, G, R). */
+	struct FImageStatsAccumulator
+	{
+		uint64 Sum[3] = {};
+		uint64 SumSq[3] = {};
+		uint64 LumaSum = 0;
+		uint64 Histogram[LumaHistogramBins] = {};
+		int64 Edges = 0;
+		int64 Overexposed = 0;
+		int64 Underexposed = 0;
+
+		void Merge(const FImageStatsAccumulator& Other)
+		{
+			for (int32 c = 0; c < 3; ++c)
+			{
+				Sum[c] += Other.Sum[c];
+				SumSq[c] += Other.SumSq[c];
+			}
+			LumaSum += Other.LumaSum;
+			for (int32 Bin = 0; Bin < LumaHistogramBins; ++Bin)
+			{
+				Histogram[Bin] += Other.Histogram[Bin];
+			}
+			Edges += Other.Edges;
+			Overexposed += Other.Overexposed;
+			Underexposed += Other.Underexposed;
+		}
+	};
+
+	/** 8-bit Rec. 601 luma of a row into Luma, plus per-channel sums and sums of squares.
+	 *  32-bit row totals hold rows up to 66k pixels wide. */
+	void RowLuma(const FColor* Row, int32 Width, uint8* Luma, uint32 OutSum[3], uint32 OutSumSq[3])
+	{
+		const uint32* In = reinterpret_cast<const uint32*>(Row);
+		uint32 Sum[3] = {}, SumSq[3] = {};
+		int32 x = 0;
+
+#if PERCEPTION_STATS_SSE2
+		{
+			const __m128i Mask = _mm_set1_epi32(0xFF);
+			const __m128i WeightB = _mm_set1_epi32(29);
+			const __m128i WeightG = _mm_set1_epi32(150);
+			const __m128i WeightR = _mm_set1_epi32(77);
+			__m128i SumB = _mm_setzero_si128(), SumG = _mm_setzero_si128(), SumR = _mm_setzero_si128();
+			__m128i SqB = _mm_setzero_si128(), SqG = _mm_setzero_si128(), SqR = _mm_setzero_si128();
+			for (; x + 4 <= Width; x += 4)
+			{
+				const __m128i P = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + x));
+				const __m128i B = _mm_and_si128(P, Mask);
+				const __m128i G = _mm_and_si128(_mm_srli_epi32(P, 8), Mask);
+				const __m128i R = _mm_and_si128(_mm_srli_epi32(P, 16), Mask);
+
+				SumB = _mm_add_epi32(SumB, B);
+				SumG = _mm_add_epi32(SumG, G);
+				SumR = _mm_add_epi32(SumR, R);
+
+				// Upper 16 bits of every lane are zero, so madd is a plain square
+				SqB = _mm_add_epi32(SqB, _mm_madd_epi16(B, B));
+				SqG = _mm_add_epi32(SqG, _mm_madd_epi16(G, G));
+				SqR = _mm_add_epi32(SqR, _mm_madd_epi16(R, R));
+
+				// Each product and their sum fit in 16 bits, so mullo is exact
+				const __m128i L = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(
+					_mm_mullo_epi16(R, WeightR), _mm_mullo_epi16(G, WeightG)), _mm_mullo_epi16(B, WeightB)), 8);
+				const __m128i Packed = _mm_packus_epi16(_mm_packs_epi32(L, L), _mm_setzero_si128());
+				const int32 Four = _mm_cvtsi128_si32(Packed);
+				FMemory::Memcpy(Luma + x, &Four, 4);
+			}
+
+			auto AddLanes = [](__m128i V)
+			{
+				alignas(16) uint32 Lanes[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(Lanes), V);
+				return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+			};
+			Sum[0] = AddLanes(SumB);
+			Sum[1] = AddLanes(SumG);
+			Sum[2] = AddLanes(SumR);
+			SumSq[0] = AddLanes(SqB);
+			SumSq[1] = AddLanes(SqG);
+			SumSq[2] = AddLanes(SqR);
+		}
+#elif PERCEPTION_STATS_NEON
+		{
+			const uint32x4_t Mask = vdupq_n_u32(0xFF);
+			uint32x4_t SumB = vdupq_n_u32(0), SumG = vdupq_n_u32(0), SumR = vdupq_n_u32(0);
+			uint32x4_t SqB = vdupq_n_u32(0), SqG = vdupq_n_u32(0), SqR = vdupq_n_u32(0);
+			uint32 L[4];
+			for (; x + 4 <= Width; x += 4)
+			{
+				const uint32x4_t P = vld1q_u32(In + x);
+				const uint32x4_t B = vandq_u32(P, Mask);
+				const uint32x4_t G = vandq_u32(vshrq_n_u32(P, 8), Mask);
+				const uint32x4_t R = vandq_u32(vshrq_n_u32(P, 16), Mask);
+
+				SumB = vaddq_u32(SumB, B);
+				SumG = vaddq_u32(SumG, G);
+				SumR = vaddq_u32(SumR, R);
+				SqB = vmlaq_u32(SqB, B, B);
+				SqG = vmlaq_u32(SqG, G, G);
+				SqR = vmlaq_u32(SqR, R, R);
+
+				vst1q_u32(L, vshrq_n_u32(vmlaq_n_u32(vmlaq_n_u32(vmulq_n_u32(R, 77), G, 150), B, 29), 8));
+				Luma[x] = static_cast<uint8>(L[0]);
+				Luma[x + 1] = static_cast<uint8>(L[1]);
+				Luma[x + 2] = static_cast<uint8>(L[2]);
+				Luma[x + 3] = static_cast<uint8>(L[3]);
+			}
+
+			auto AddLanes = [](uint32x4_t V)
+			{
+				uint32 Lanes[4];
+				vst1q_u32(Lanes, V);
+				return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+			};
+			Sum[0] = AddLanes(SumB);
+			Sum[1] = AddLanes(SumG);
+			Sum[2] = AddLanes(SumR);
+			SumSq[0] = AddLanes(SqB);
+			SumSq[1] = AddLanes(SqG);
+			SumSq[2] = AddLanes(SqR);
+		}
+#endif
+
+		for (; x < Width; ++x)
+		{
+			const uint32 B = In[x] & 0xFF;
+			const uint32 G = (In[x] >> 8) & 0xFF;
+			const uint32 R = (In[x] >> 16) & 0xFF;
+			Sum[0] += B;
+			Sum[1] += G;
+			Sum[2] += R;
+			SumSq[0] += B * B;
+			SumSq[1] += G * G;
+			SumSq[2] += R * R;
+			Luma[x] = static_cast<uint8>((R * 77 + G * 150 + B * 29) >> 8);
+		}
+
+		for (int32 c = 0; c < 3; ++c)
+		{
+			OutSum[c] = Sum[c];
+			OutSumSq[c] = SumSq[c];
+		}
+	}
+}
 
 TArray<FColor> FPerceptionAdapter::Resize(const TArray<FColor>& Source,
-                                           FIntPoint SourceSize, FIntPoint TargetSize)
+                                           FIntPoint SourceSize, FIntPoint TargetSize,
+                                           int32 MaxWorkers)
+{
+	if (SourceSize == TargetSize || Source.Num() == 0)
+	{
+		return Source;  // No resize needed
+	}
+
+	if (TargetSize.X <= 0 || TargetSize.Y <= 0 || Source.Num() < SourceSize.X * SourceSize.Y)
+	{
+		return TArray<FColor>();
+	}
+
+	// 2x or more: box-average down to within 2x of the target first
+	TArray<FColor> Reduced;
+	FIntPoint ReducedSize = SourceSize;
+	const int32 HalvingSteps = FPerceptionResampler::GetHalvingSteps(SourceSize, TargetSize);
+	for (int32 Step = 0; Step < HalvingSteps; ++Step)
+	{
+		FIntPoint HalfSize;
+		Reduced = Halve((Step == 0) ? Source : Reduced, ReducedSize, HalfSize, MaxWorkers);
+		ReducedSize = HalfSize;
+	}
+
+	if (HalvingSteps > 0 && ReducedSize == TargetSize)
+	{
+		return Reduced;
+	}
+
+	TArray<FColor> Result;
+	Result.SetNumUninitialized(TargetSize.X * TargetSize.Y);
+
+	const FPerceptionResampler Resampler(ReducedSize, TargetSize);
+	const FColor* ResampleSource = (HalvingSteps > 0) ? Reduced.GetData() : Source.GetData();
+	ForEachRowBand(TargetSize.Y, MaxWorkers, [&](int32 RowBegin, int32 RowEnd)
+	{
+		Resampler.ResampleRows(ResampleSource, Result.GetData(), RowBegin, RowEnd);
+	});
+
+	return Result;
+}
+
+TArray<FColor> FPerceptionAdapter::Halve(const TArray<FColor>& Source, FIntPoint SourceSize,
+                                          FIntPoint& OutSize, int32 MaxWorkers)
+{
+	OutSize = FPerceptionResampler::GetHalvedSize(SourceSize);
+	if (OutSize.X <= 0 || OutSize.Y <= 0 || Source.Num() < SourceSize.X * SourceSize.Y)
+	{
+		OutSize = FIntPoint::ZeroValue;
+		return TArray<FColor>();
+	}
+
+	TArray<FColor> Half;
+	Half.SetNumUninitialized(OutSize.X * OutSize.Y);
+	const FIntPoint HalfSize = OutSize;
+	ForEachRowBand(HalfSize.Y, MaxWorkers, [&](int32 RowBegin, int32 RowEnd)
+	{
+		FPerceptionResampler::HalveRows(Source.GetData(), SourceSize.X, Half.GetData(), HalfSize, RowBegin, RowEnd);
+	});
+	return Half;
+}
+
+TArray<FColor> FPerceptionAdapter::Crop(const TArray<FColor>& Source, FIntPoint SourceSize, const FIntRect& Region)
+{
+	if (Region.IsEmpty() || Region.Min.X < 0 || Region.Min.Y < 0 || Region.Max.X > SourceSize.X
+		|| Region.Max.Y > SourceSize.Y || Source.Num() < SourceSize.X * SourceSize.Y)
+	{
+		return TArray<FColor>();
+	}
+
+	const int32 Width = Region.Width();
+	TArray<FColor> Result;
+	Result.SetNumUninitialized(Width * Region.Height());
+	for (int32 Y = Region.Min.Y; Y < Region.Max.Y; ++Y)
+	{
+		FMemory::Memcpy(Result.GetData() + (Y - Region.Min.Y) * Width,
+		                Source.GetData() + Y * SourceSize.X + Region.Min.X, Width * sizeof(FColor));
+	}
+	return Result;
+}
+
+TArray<FColor> FPerceptionAdapter::ResizeReference(const TArray<FColor>& Source,
+                                                    FIntPoint SourceSize, FIntPoint TargetSize)
 {
 	if (SourceSize == TargetSize || Source.Num() == 0)
 	{
@@ -68,12 +373,207 @@ TArray<FColor> FPerceptionAdapter::Resize(const TArray<FColor>& Source,
 	return Result;
 }
 
+TArray<uint8> FPerceptionAdapter::DownsampleLuma(const TArray<FColor>& Pixels, FIntPoint Size, int32 Factor,
+                                                 FIntPoint& OutSize, int32 MaxWorkers)
+{
+	Factor = FMath::Max(Factor, 1);
+	OutSize = FIntPoint(Size.X / Factor, Size.Y / Factor);
+
+	TArray<uint8> Plane;
+	if (OutSize.X <= 0 || OutSize.Y <= 0 || Pixels.Num() < Size.X * Size.Y)
+	{
+		OutSize = FIntPoint::ZeroValue;
+		return Plane;
+	}
+
+	Plane.SetNumUninitialized(OutSize.X * OutSize.Y);
+	const int32 Area = Factor * Factor;
+
+	ForEachRowBand(OutSize.Y, MaxWorkers, [&](int32 RowBegin, int32 RowEnd)
+	{
+		TArray<uint8> Luma;
+		TArray<uint32> Sums;
+		Luma.SetNumUninitialized(Size.X);
+		Sums.SetNumUninitialized(OutSize.X);
+		uint32 RowSum[3], RowSumSq[3];
+
+		for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+		{
+			FMemory::Memzero(Sums.GetData(), Sums.Num() * sizeof(uint32));
+			for (int32 SourceRow = Row * Factor; SourceRow < (Row + 1) * Factor; ++SourceRow)
+			{
+				RowLuma(Pixels.GetData() + static_cast<int64>(SourceRow) * Size.X, Size.X, Luma.GetData(), RowSum, RowSumSq);
+				const uint8* L = Luma.GetData();
+				for (int32 x = 0; x < OutSize.X; ++x, L += Factor)
+				{
+					uint32 Sum = 0;
+					for (int32 i = 0; i < Factor; ++i)
+					{
+						Sum += L[i];
+					}
+					Sums[x] += Sum;
+				}
+			}
+
+			uint8* Out = Plane.GetData() + static_cast<int64>(Row) * OutSize.X;
+			for (int32 x = 0; x < OutSize.X; ++x)
+			{
+				Out[x] = static_cast<uint8>((Sums[x] + Area / 2) / Area);
+			}
+		}
+	});
+
+	return Plane;
+}
+
+FPerceptionImageStats FPerceptionAdapter::ComputeImageStats(const TArray<FColor>& Pixels, FIntPoint Size,
+                                                            int32 MaxWorkers)
+{
+	FPerceptionImageStats Stats;
+	if (Size.X <= 0 || Size.Y <= 0 || Pixels.Num() < Size.X * Size.Y)
+	{
+		return Stats;
+	}
+
+	FImageStatsAccumulator Total;
+	FCriticalSection MergeLock;
+
+	ForEachRowBand(Size.Y, MaxWorkers, [&](int32 RowBegin, int32 RowEnd)
+	{
+		FImageStatsAccumulator Band;
+		TArray<uint8> Above, Current;
+		Above.SetNumUninitialized(Size.X);
+		Current.SetNumUninitialized(Size.X);
+		uint32 RowSum[3], RowSumSq[3];
+
+		// Edges look one row up, across the band boundary too
+		if (RowBegin > 0)
+		{
+			RowLuma(Pixels.GetData() + static_cast<int64>(RowBegin - 1) * Size.X, Size.X, Above.GetData(), RowSum, RowSumSq);
+		}
+
+		for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+		{
+			RowLuma(Pixels.GetData() + static_cast<int64>(Row) * Size.X, Size.X, Current.GetData(), RowSum, RowSumSq);
+			for (int32 c = 0; c < 3; ++c)
+			{
+				Band.Sum[c] += RowSum[c];
+				Band.SumSq[c] += RowSumSq[c];
+			}
+
+			const uint8* L = Current.GetData();
+			const uint8* Up = Above.GetData();
+			for (int32 x = 0; x < Size.X; ++x)
+			{
+				const int32 Value = L[x];
+				Band.LumaSum += Value;
+				++Band.Histogram[Value >> 3];
+				Band.Overexposed += (Value >= OverexposedLuma) ? 1 : 0;
+				Band.Underexposed += (Value <= UnderexposedLuma) ? 1 : 0;
+
+				if (x > 0 && Row > 0)
+				{
+					const int32 Gradient = FMath::Abs(Value - L[x - 1]) + FMath::Abs(Value - Up[x]);
+					Band.Edges += (Gradient >= EdgeThreshold) ? 1 : 0;
+				}
+			}
+
+			Swap(Above, Current);
+		}
+
+		FScopeLock Lock(&MergeLock);
+		Total.Merge(Band);
+	});
+
+	const double Count = static_cast<double>(Size.X) * Size.Y;
+	const double EdgeCount = FMath::Max(static_cast<double>(Size.X - 1) * (Size.Y - 1), 1.0);
+
+	// Memory order is B, G, R; the results are R, G, B
+	for (int32 c = 0; c < 3; ++c)
+	{
+		const double Mean = Total.Sum[c] / Count / 255.0;
+		const double MeanSq = Total.SumSq[c] / Count / (255.0 * 255.0);
+		Stats.Mean[2 - c] = Mean;
+		Stats.Variance[2 - c] = FMath::Max(MeanSq - Mean * Mean, 0.0);
+	}
+
+	Stats.MeanLuma = static_cast<float>(Total.LumaSum / Count / 255.0);
+	Stats.LumaHistogram.SetNumUninitialized(LumaHistogramBins);
+	for (int32 Bin = 0; Bin < LumaHistogramBins; ++Bin)
+	{
+		Stats.LumaHistogram[Bin] = static_cast<float>(Total.Histogram[Bin] / Count);
+	}
+	Stats.EdgeDensity = static_cast<float>(Total.Edges / EdgeCount);
+	Stats.Overexposed = static_cast<float>(Total.Overexposed / Count);
+	Stats.Underexposed = static_cast<float>(Total.Underexposed / Count);
+	Stats.bValid = true;
+	return Stats;
+}
+
+uint64 FPerceptionAdapter::ComputePerceptualHash(const TArray<FColor>& Pixels, FIntPoint Size)
+{
+	constexpr int32 CellsX = 9;
+	constexpr int32 CellsY = 8;
+
+	if (Size.X < CellsX || Size.Y < CellsY || Pixels.Num() != Size.X * Size.Y)
+	{
+		return 0;
+	}
+
+	// Up to ~16x16 samples per cell is plenty for an average
+	const int32 Step = FMath::Max(1, FMath::Min(Size.X / CellsX, Size.Y / CellsY) / 16);
+
+	uint32 Luma[CellsY][CellsX];
+	for (int32 CellY = 0; CellY < CellsY; ++CellY)
+	{
+		const int32 Y0 = Size.Y * CellY / CellsY;
+		const int32 Y1 = Size.Y * (CellY + 1) / CellsY;
+		for (int32 CellX = 0; CellX < CellsX; ++CellX)
+		{
+			const int32 X0 = Size.X * CellX / CellsX;
+			const int32 X1 = Size.X * (CellX + 1) / CellsX;
+
+			uint64 Sum = 0;
+			uint32 Count = 0;
+			for (int32 Y = Y0; Y < Y1; Y += Step)
+			{
+				const FColor* Row = Pixels.GetData() + static_cast<int64>(Y) * Size.X;
+				for (int32 X = X0; X < X1; X += Step)
+				{
+					// Rec. 601 weights in 8.8 fixed point
+					Sum += (Row[X].R * 77u + Row[X].G * 150u + Row[X].B * 29u) >> 8;
+					++Count;
+				}
+			}
+			Luma[CellY][CellX] = static_cast<uint32>(Sum / FMath::Max(Count, 1u));
+		}
+	}
+
+	// Near-equal neighbours (flat areas) would flip on jitter alone; they read as "not brighter"
+	constexpr uint32 NoiseMargin = 2;
+
+	uint64 Hash = 0;
+	int32 Bit = 0;
+	for (int32 CellY = 0; CellY < CellsY; ++CellY)
+	{
+		for (int32 CellX = 0; CellX < CellsX - 1; ++CellX, ++Bit)
+		{
+			if (Luma[CellY][CellX] > Luma[CellY][CellX + 1] + NoiseMargin)
+			{
+				Hash |= 1ull << Bit;
+			}
+		}
+	}
+	return Hash;
+}
+
 TArray<uint8> FPerceptionAdapter::Encode(const TArray<FColor>& Pixels, FIntPoint Size,
-                                          EPerceptionImageFormat Format, int32 Quality)
+                                          EPerceptionImageFormat Format, int32 Quality,
+                                          int32 MaxWorkers)
 {
 	TArray<uint8> Result;
 
-	if (Pixels.Num() == 0 || Size.X <= 0 || Size.Y <= 0)
+	if (Pixels.Num() == 0 || Size.X <= 0 || Size.Y <= 0 || Pixels.Num() < Size.X * Size.Y)
 	{
 		return Result;
 	}
@@ -89,14 +589,25 @@ TArray<uint8> FPerceptionAdapter::Encode(const TArray<FColor>& Pixels, FIntPoint
 		return Result;
 	}
 
+	// Force alpha opaque (captures that skip the resampler can carry arbitrary alpha). JPEG gets
+	// RGBA so the wrapper doesn't swizzle on the calling thread; PNG takes BGRA natively.
+	const bool bSwapRedBlue = (Format == EPerceptionImageFormat::JPEG);
+	TArray<FColor> Prepared;
+	Prepared.SetNumUninitialized(Size.X * Size.Y);
+	ForEachRowBand(Size.Y, MaxWorkers, [&](int32 RowBegin, int32 RowEnd)
+	{
+		const int64 First = static_cast<int64>(RowBegin) * Size.X;
+		PreparePixels(Pixels.GetData() + First, Prepared.GetData() + First,
+		              static_cast<int64>(RowEnd - RowBegin) * Size.X, bSwapRedBlue);
+	});
+
 	// Set raw pixel data
-	const TArray<uint8>* RawData = reinterpret_cast<const TArray<uint8>*>(&Pixels);
 	if (ImageWrapper->SetRaw(
-		Pixels.GetData(),
-		Pixels.Num() * sizeof(FColor),
+		Prepared.GetData(),
+		Prepared.Num() * sizeof(FColor),
 		Size.X,
 		Size.Y,
-		ERGBFormat::BGRA,
+		bSwapRedBlue ? ERGBFormat::RGBA : ERGBFormat::BGRA,
 		8))
 	{
 		// Compress
@@ -1,6 +1,8 @@
 // PerceptionAdapter.h
 // Resize and encode pixel data to JPEG/PNG.
 // Designed to run on a worker thread to keep cost off render and game threads.
+// Pixel kernels are split into row bands on the task graph; MaxWorkers caps the
+// number of bands (1 = run everything on the calling thread).
 
 #pragma once
 
@@ -10,11 +12,50 @@
 class FPerceptionAdapter
 {
 public:
-	/** Resize RGBA pixel array from source size to target size using bilinear filtering. */
+	/** Resize RGBA pixel array from source size to target size.
+	 *  Reductions of 2x or more are box-averaged down to within 2x of the target first,
+	 *  then finished with the fixed-point bilinear resampler (see PerceptionResampler.h). */
 	static TArray<FColor> Resize(const TArray<FColor>& Source,
-	                              FIntPoint SourceSize, FIntPoint TargetSize);
+	                              FIntPoint SourceSize, FIntPoint TargetSize,
+	                              int32 MaxWorkers = 1);
 
-	/** Encode RGBA pixels to JPEG or PNG bytes. Quality is 1-100 (JPEG only). */
+	/** One 2x2 box-average halving. OutSize is Size / 2, rounded down (odd trailing columns/rows
+	 *  are dropped); empty if the source is smaller than 2x2. */
+	static TArray<FColor> Halve(const TArray<FColor>& Source, FIntPoint SourceSize,
+	                            FIntPoint& OutSize, int32 MaxWorkers = 1);
+
+	/** Copy of the Region part of Source, row by row. Region must lie inside SourceSize. */
+	static TArray<FColor> Crop(const TArray<FColor>& Source, FIntPoint SourceSize, const FIntRect& Region);
+
+	/** Original float bilinear resize. Kept as the quality/speed baseline for the resize benchmark. */
+	static TArray<FColor> ResizeReference(const TArray<FColor>& Source,
+	                                       FIntPoint SourceSize, FIntPoint TargetSize);
+
+	/** 8-bit luma plane of BGRA pixels, box-averaged over Factor x Factor blocks.
+	 *  OutSize is Size / Factor (rounded down; trailing pixels are dropped). */
+	static TArray<uint8> DownsampleLuma(const TArray<FColor>& Pixels, FIntPoint Size, int32 Factor,
+	                                    FIntPoint& OutSize, int32 MaxWorkers = 1);
+
+	/** Perceptual fingerprint: a 64-bit difference hash. Luma is averaged over a 9x8 grid of
+	 *  cells and each bit says whether a cell is clearly brighter than its right neighbour. Cells are
+	 *  sampled on a sparse lattice, so cost stays flat with resolution. Noise, jitter and
+	 *  compression rarely flip bits; real content changes do. */
+	static uint64 ComputePerceptualHash(const TArray<FColor>& Pixels, FIntPoint Size);
+
+	/** Scene-change score of two perceptual hashes: the fraction of bits that differ, 0 to 1. */
+	static float CompareHashes(uint64 A, uint64 B)
+	{
+		return FMath::CountBits(A ^ B) / 64.0f;
+	}
+
+	/** Channel means and variances, luma histogram, edge density and exposure fractions of
+	 *  BGRA pixels, in one pass over row bands (SSE2/NEON for the per-pixel math). */
+	static FPerceptionImageStats ComputeImageStats(const TArray<FColor>& Pixels, FIntPoint Size,
+	                                               int32 MaxWorkers = 1);
+
+	/** Encode BGRA pixels to JPEG or PNG bytes. Quality is 1-100 (JPEG only).
+	 *  Alpha is forced opaque and channel order converted in parallel before compression. */
 	static TArray<uint8> Encode(const TArray<FColor>& Pixels, FIntPoint Size,
-	                             EPerceptionImageFormat Format, int32 Quality = 85);
+	                             EPerceptionImageFormat Format, int32 Quality = 85,
+	                             int32 MaxWorkers = 1);
 };
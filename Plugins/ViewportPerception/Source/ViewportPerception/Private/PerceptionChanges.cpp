@@ -0,0 +1,321 @@
+// PerceptionChanges.cpp
+
+#include "PerceptionChanges.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	#define PERCEPTION_TILEHASH_NEON 1
+	#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#define PERCEPTION_TILEHASH_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#ifndef PERCEPTION_TILEHASH_NEON
+	#define PERCEPTION_TILEHASH_NEON 0
+#endif
+#ifndef PERCEPTION_TILEHASH_SSE2
+	#define PERCEPTION_TILEHASH_SSE2 0
+#endif
+
+namespace PerceptionTileHash
+{
+	static constexpr uint32 Seed = 0x9E3779B9u;
+
+	/** One pixel into one lane: add, then two xorshifts (bijective in State). */
+	static FORCEINLINE uint32 Step(uint32 State, uint32 Pixel)
+	{
+		State += Pixel;
+		State ^= State << 10;
+		State ^= State >> 6;
+		return State;
+	}
+
+	/** Pixel i of a tile row goes to lane i % 4. */
+	static void HashSpan(const uint32* Pixels, int32 Count, uint32* Lanes)
+	{
+		int32 i = 0;
+
+#if PERCEPTION_TILEHASH_SSE2
+		__m128i State = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Lanes));
+		for (; i + 4 <= Count; i += 4)
+		{
+			const __m128i Pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pixels + i));
+			State = _mm_add_epi32(State, Pixel);
+			State = _mm_xor_si128(State, _mm_slli_epi32(State, 10));
+			State = _mm_xor_si128(State, _mm_srli_epi32(State, 6));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes), State);
+#elif PERCEPTION_TILEHASH_NEON
+		uint32x4_t State = vld1q_u32(Lanes);
+		for (; i + 4 <= Count; i += 4)
+		{
+			State = vaddq_u32(State, vld1q_u32(Pixels + i));
+			State = veorq_u32(State, vshlq_n_u32(State, 10));
+			State = veorq_u32(State, vshrq_n_u32(State, 6));
+		}
+		vst1q_u32(Lanes, State);
+#endif
+
+		for (; i < Count; ++i)
+		{
+			Lanes[i & 3] = Step(Lanes[i & 3], Pixels[i]);
+		}
+	}
+
+	static FORCEINLINE uint64 Mix(uint64 Value)
+	{
+		Value ^= Value >> 30;
+		Value *= 0xBF58476D1CE4E5B9ull;
+		Value ^= Value >> 27;
+		Value *= 0x94D049BB133111EBull;
+		Value ^= Value >> 31;
+		return Value;
+	}
+
+	/** Fold a tile's four lanes into its hash. */
+	static uint64 Finalize(const uint32* Lanes)
+	{
+		const uint64 Low = (static_cast<uint64>(Lanes[0]) << 32) | Lanes[1];
+		const uint64 High = (static_cast<uint64>(Lanes[2]) << 32) | Lanes[3];
+		return Mix(Low ^ Mix(High));
+	}
+}
+
+const TCHAR* FPerceptionChangeTracker::GetKernelName()
+{
+#if PERCEPTION_TILEHASH_SSE2
+	return TEXT("SSE2");
+#elif PERCEPTION_TILEHASH_NEON
+	return TEXT("NEON");
+#else
+	return TEXT("Scalar");
+#endif
+}
+
+void FPerceptionChangeTracker::HashTiles(const FColor* Pixels, FIntPoint Size, uint64* OutHashes)
+{
+	using namespace PerceptionTileHash;
+
+	const FIntPoint Grid = GetGridSize(Size);
+	TArray<uint32> Lanes;
+	Lanes.SetNumUninitialized(Grid.X * 4);
+
+	// Row by row through memory, each row feeding every tile it crosses
+	for (int32 TileY = 0; TileY < Grid.Y; ++TileY)
+	{
+		for (uint32& Lane : Lanes)
+		{
+			Lane = Seed;
+		}
+
+		const int32 RowBegin = TileY * TileSize;
+		const int32 RowEnd = FMath::Min(RowBegin + TileSize, Size.Y);
+		for (int32 Row = RowBegin; Row < RowEnd; ++Row)
+		{
+			const uint32* RowPixels = reinterpret_cast<const uint32*>(Pixels + static_cast<int64>(Row) * Size.X);
+			for (int32 TileX = 0; TileX < Grid.X; ++TileX)
+			{
+				const int32 Begin = TileX * TileSize;
+				HashSpan(RowPixels + Begin, FMath::Min(TileSize, Size.X - Begin), &Lanes[TileX * 4]);
+			}
+		}
+
+		for (int32 TileX = 0; TileX < Grid.X; ++TileX)
+		{
+			OutHashes[TileY * Grid.X + TileX] = Finalize(&Lanes[TileX * 4]);
+		}
+	}
+}
+
+void FPerceptionChangeTracker::BuildRegions(FPerceptionChanges& Changes)
+{
+	const FIntPoint Grid = Changes.GridSize;
+	const int32 NumTiles = Grid.X * Grid.Y;
+
+	Changes.Regions.Reset();
+	Changes.ChangedTiles = 0;
+
+	auto ToPixels = [&Changes](const FIntRect& Tiles)
+	{
+		return FIntRect(
+			Tiles.Min.X * TileSize, Tiles.Min.Y * TileSize,
+			FMath::Min((Tiles.Max.X + 1) * TileSize, Changes.FrameSize.X),
+			FMath::Min((Tiles.Max.Y + 1) * TileSize, Changes.FrameSize.Y));
+	};
+
+	// Flood fill over 8-connected changed tiles; each component becomes its bounding rectangle
+	TBitArray<> Visited(false, NumTiles);
+	TArray<int32> Stack;
+	FIntRect AllTiles(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+
+	for (int32 Start = 0; Start < NumTiles; ++Start)
+	{
+		if (Visited[Start] || !Changes.IsTileChanged(Start % Grid.X, Start / Grid.X))
+		{
+			continue;
+		}
+
+		FIntRect Tiles(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+		Visited[Start] = true;
+		Stack.Add(Start);
+
+		while (Stack.Num() > 0)
+		{
+			const int32 Index = Stack.Pop(EAllowShrinking::No);
+			const int32 X = Index % Grid.X;
+			const int32 Y = Index / Grid.X;
+			Tiles.Include(FIntPoint(X, Y));
+			++Changes.ChangedTiles;
+
+			for (int32 NY = FMath::Max(Y - 1, 0); NY <= FMath::Min(Y + 1, Grid.Y - 1); ++NY)
+			{
+				for (int32 NX = FMath::Max(X - 1, 0); NX <= FMath::Min(X + 1, Grid.X - 1); ++NX)
+				{
+					const int32 Neighbour = NY * Grid.X + NX;
+					if (!Visited[Neighbour] && Changes.IsTileChanged(NX, NY))
+					{
+						Visited[Neighbour] = true;
+						Stack.Add(Neighbour);
+					}
+				}
+			}
+		}
+
+		AllTiles.Include(Tiles.Min);
+		AllTiles.Include(Tiles.Max);
+		Changes.Regions.Add(ToPixels(Tiles));
+	}
+
+	// Scattered changes: one rectangle is more useful than a long list
+	if (Changes.Regions.Num() > MaxRegions)
+	{
+		Changes.Regions.Reset();
+		Changes.Regions.Add(ToPixels(AllTiles));
+	}
+
+	Changes.bUnchanged = (Changes.ChangedTiles == 0);
+}
+
+TSharedPtr<const FPerceptionChanges, ESPMode::ThreadSafe> FPerceptionChangeTracker::Update(const FPerceptionFrame& Frame)
+{
+	if (Frame.Size.X <= 0 || Frame.Size.Y <= 0 || Frame.Pixels.Num() != Frame.Size.X * Frame.Size.Y)
+	{
+		return nullptr;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	if (Frame.FrameNumber <= PrevFrame)
+	{
+		const FHistoryEntry* Entry = History.FindByPredicate([&Frame](const FHistoryEntry& Candidate)
+		{
+			return Candidate.FrameNumber == Frame.FrameNumber;
+		});
+		return Entry ? Entry->Changes : nullptr;
+	}
+
+	const FIntPoint Grid = GetGridSize(Frame.Size);
+	const int32 NumTiles = Grid.X * Grid.Y;
+	Hashes.SetNumUninitialized(NumTiles);
+	HashTiles(Frame.Pixels.GetData(), Frame.Size, Hashes.GetData());
+
+	TSharedRef<FPerceptionChanges, ESPMode::ThreadSafe> Changes = MakeShared<FPerceptionChanges, ESPMode::ThreadSafe>();
+	Changes->TileSize = TileSize;
+	Changes->GridSize = Grid;
+	Changes->FrameSize = Frame.Size;
+	Changes->Bitmap.SetNumZeroed((NumTiles + 7) / 8);
+
+	// A resize changes the tiling, so there is nothing to compare against
+	const bool bComparable = (PrevFrame > 0 && PrevSize == Frame.Size);
+	Changes->BaseFrame = bComparable ? PrevFrame : 0;
+
+	for (int32 i = 0; i < NumTiles; ++i)
+	{
+		if (!bComparable || Hashes[i] != PrevHashes[i])
+		{
+			Changes->Bitmap[i >> 3] |= static_cast<uint8>(1 << (i & 7));
+		}
+	}
+	BuildRegions(*Changes);
+
+	Swap(PrevHashes, Hashes);
+	PrevSize = Frame.Size;
+	PrevFrame = Frame.FrameNumber;
+
+	if (History.Num() >= HistoryLength)
+	{
+		History.RemoveAt(0);
+	}
+	History.Add({ Frame.FrameNumber, Changes });
+
+	return Changes;
+}
+
+bool FPerceptionChangeTracker::GetChangesSince(int64 SinceFrame, FPerceptionChanges& OutChanges, int64& OutFrameNumber) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (History.Num() == 0)
+	{
+		return false;
+	}
+
+	const FPerceptionChanges& Latest = *History.Last().Changes;
+	OutFrameNumber = History.Last().FrameNumber;
+
+	if (SinceFrame < 0)
+	{
+		OutChanges = Latest;
+		return true;
+	}
+
+	OutChanges = FPerceptionChanges();
+	OutChanges.TileSize = Latest.TileSize;
+	OutChanges.GridSize = Latest.GridSize;
+	OutChanges.FrameSize = Latest.FrameSize;
+	OutChanges.Bitmap.SetNumZeroed(Latest.Bitmap.Num());
+
+	if (SinceFrame >= OutFrameNumber)
+	{
+		OutChanges.BaseFrame = SinceFrame;
+		OutChanges.bUnchanged = true;
+		return true;
+	}
+
+	// Newest first, until an entry's base reaches back to SinceFrame. Entries chain
+	// (each one's base is the frame before it), so the union covers every change since.
+	bool bComplete = false;
+	for (int32 i = History.Num() - 1; i >= 0; --i)
+	{
+		const FPerceptionChanges& Entry = *History[i].Changes;
+		if (Entry.FrameSize != OutChanges.FrameSize)
+		{
+			break;
+		}
+
+		for (int32 Byte = 0; Byte < OutChanges.Bitmap.Num(); ++Byte)
+		{
+			OutChanges.Bitmap[Byte] |= Entry.Bitmap[Byte];
+		}
+
+		if (Entry.BaseFrame <= SinceFrame)
+		{
+			OutChanges.BaseFrame = Entry.BaseFrame;
+			bComplete = true;
+			break;
+		}
+	}
+
+	if (!bComplete)
+	{
+		const int32 NumTiles = OutChanges.GridSize.X * OutChanges.GridSize.Y;
+		for (int32 i = 0; i < NumTiles; ++i)
+		{
+			OutChanges.Bitmap[i >> 3] |= static_cast<uint8>(1 << (i & 7));
+		}
+		OutChanges.BaseFrame = 0;
+	}
+
+	BuildRegions(OutChanges);
+	return true;
+}
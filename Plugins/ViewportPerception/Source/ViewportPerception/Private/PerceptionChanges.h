@@ -0,0 +1,69 @@
+// PerceptionChanges.h
+// Tile-hash change detection between captured frames.
+//
+// Each frame is cut into TileSize x TileSize tiles and every tile is hashed in
+// one pass over the pixels (SSE2/NEON, scalar fallback; same integer math on
+// every path). Comparing the hashes with those of the previous frame gives a
+// changed-tile bitmap and the bounding rectangles of connected changed tiles.
+// A frame with no changed tiles doesn't need to be re-encoded.
+//
+// The per-lane hash step is add, then two xorshifts. Each step is a bijection
+// of the lane state, so a single changed pixel always changes its tile's hash.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PerceptionTypes.h"
+#include "PerceptionFrame.h"
+
+class FPerceptionChangeTracker
+{
+public:
+	static constexpr int32 TileSize = 32;
+
+	/** Beyond this many regions the changes are reported as one bounding rectangle. */
+	static constexpr int32 MaxRegions = 32;
+
+	/** Frames whose changes are kept for GetChangesSince. */
+	static constexpr int32 HistoryLength = 64;
+
+	/** Changes of Frame against the last frame hashed before it, hashing Frame if it is new.
+	 *  Frames older than the last one hashed are only answered from history. Thread-safe. */
+	TSharedPtr<const FPerceptionChanges, ESPMode::ThreadSafe> Update(const FPerceptionFrame& Frame);
+
+	/** Union of the changes after SinceFrame up to the last frame hashed; a negative SinceFrame
+	 *  gives the last frame's own changes. If history doesn't reach back that far every tile is
+	 *  reported changed, with BaseFrame 0. False if nothing has been hashed yet. */
+	bool GetChangesSince(int64 SinceFrame, FPerceptionChanges& OutChanges, int64& OutFrameNumber) const;
+
+	/** Hash every tile of a Size image, row-major, into OutHashes (GetGridSize(Size) entries). */
+	static void HashTiles(const FColor* Pixels, FIntPoint Size, uint64* OutHashes);
+
+	static FIntPoint GetGridSize(FIntPoint Size)
+	{
+		return FIntPoint(FMath::DivideAndRoundUp(Size.X, TileSize), FMath::DivideAndRoundUp(Size.Y, TileSize));
+	}
+
+	/** Fill ChangedTiles and Regions from Bitmap. */
+	static void BuildRegions(FPerceptionChanges& Changes);
+
+	/** Name of the vector path compiled into this build ("SSE2", "NEON" or "Scalar"). */
+	static const TCHAR* GetKernelName();
+
+private:
+	struct FHistoryEntry
+	{
+		int64 FrameNumber = 0;
+		TSharedPtr<const FPerceptionChanges, ESPMode::ThreadSafe> Changes;
+	};
+
+	mutable FCriticalSection Lock;
+
+	/** Oldest first */
+	TArray<FHistoryEntry> History;
+
+	TArray<uint64> PrevHashes;
+	TArray<uint64> Hashes;
+	FIntPoint PrevSize = FIntPoint::ZeroValue;
+	int64 PrevFrame = 0;
+};
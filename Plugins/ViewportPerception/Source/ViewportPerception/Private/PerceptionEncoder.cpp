@@ -0,0 +1,305 @@
+// PerceptionEncoder.cpp
+
+#include "PerceptionEncoder.h"
+#include "PixelBus.h"
+#include "PerceptionAdapter.h"
+#include "ViewportPerceptionModule.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+
+FPerceptionEncoder::FPerceptionEncoder(FPixelBus* InPixelBus)
+	: PixelBus(InPixelBus)
+	, bStopRequested(false)
+{
+	check(PixelBus);
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FPerceptionEncoder::~FPerceptionEncoder()
+{
+	Shutdown();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FPerceptionEncoder::Start()
+{
+	if (Thread)
+	{
+		return;
+	}
+
+	bStopRequested = false;
+	PixelBus->SetFrameEvent(WakeEvent);
+	Thread = FRunnableThread::Create(this, TEXT("PerceptionEncoder"), 0, TPri_BelowNormal);
+
+	if (!Thread)
+	{
+		PixelBus->SetFrameEvent(nullptr);
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to create encoder thread, packets will be encoded on request"));
+	}
+}
+
+void FPerceptionEncoder::Shutdown()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	PixelBus->SetFrameEvent(nullptr);
+	Thread->Kill(true);  // Calls Stop() and waits for Run() to return
+	delete Thread;
+	Thread = nullptr;
+}
+
+void FPerceptionEncoder::Configure(const FPerceptionEncodeSettings& InSettings)
+{
+	{
+		FScopeLock Lock(&SettingsLock);
+		Settings = InSettings;
+		Settings.Quality = FPerceptionEncodeSettings::NormalizeQuality(InSettings.Format, InSettings.Quality);
+		++SettingsVersion;
+	}
+	WakeEvent->Trigger();
+}
+
+TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> FPerceptionEncoder::GetLatest() const
+{
+	FScopeLock Lock(&SlotLock);
+	return LatestFrame;
+}
+
+FPerceptionEncoderStats FPerceptionEncoder::GetStats() const
+{
+	FScopeLock Lock(&StatsLock);
+	return Stats;
+}
+
+void FPerceptionEncoder::SetPublishCallback(TFunction<void(int64)> InCallback)
+{
+	FScopeLock Lock(&PublishCallbackLock);
+	PublishCallback = MoveTemp(InCallback);
+}
+
+void FPerceptionEncoder::AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber)
+{
+	History.AttachMetadata(Metadata, FrameNumber);
+	Recorder.AttachMetadata(Metadata, FrameNumber);
+}
+
+uint32 FPerceptionEncoder::Run()
+{
+	while (!bStopRequested)
+	{
+		// The timeout only guards against a missed trigger; frames normally wake us
+		WakeEvent->Wait(100);
+
+		if (!bStopRequested)
+		{
+			EncodeLatest();
+		}
+	}
+	return 0;
+}
+
+void FPerceptionEncoder::Stop()
+{
+	bStopRequested = true;
+	WakeEvent->Trigger();
+}
+
+void FPerceptionEncoder::EncodeLatest()
+{
+	FPerceptionEncodeSettings Current;
+	int32 Version;
+	{
+		FScopeLock Lock(&SettingsLock);
+		Current = Settings;
+		Version = SettingsVersion;
+	}
+
+	const int64 Latest = PixelBus->GetLatestFrameNumber();
+	if (Latest <= 0 || (Latest == LastEncodedFrame && (Version == LastEncodedVersion || Version == LastFailedVersion)))
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FPerceptionFrameRef Source;
+	FPerceptionMetadata Meta;
+
+	if (!PixelBus->ReadLatestWithMetadata(Source, Meta))
+	{
+		return;
+	}
+
+	const int64 FrameNum = Source->FrameNumber;
+	const double Timestamp = Source->Timestamp;
+	const double ReadTime = FPlatformTime::Seconds();
+
+	TSharedPtr<const FPerceptionChanges, ESPMode::ThreadSafe> Changes = PixelBus->GetChangeTracker().Update(*Source);
+	const uint64 PerceptualHash = FPerceptionAdapter::ComputePerceptualHash(Source->Pixels, Source->Size);
+	const double HashTime = FPlatformTime::Seconds();
+
+	TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> Previous = GetLatest();
+	const bool bSameSettings = Previous.IsValid() && Version == LastEncodedVersion;
+	const float SceneChange = Previous.IsValid()
+		? FPerceptionAdapter::CompareHashes(PerceptualHash, static_cast<uint64>(Previous->Packet.PerceptualHash))
+		: 1.0f;
+
+	// Too close to what we last published: hold it back, the previous packet stands in for it
+	if (bSameSettings && Current.MinSceneChange > 0.0f && SceneChange <= Current.MinSceneChange)
+	{
+		{
+			FScopeLock Lock(&StatsLock);
+			if (LastEncodedFrame > 0 && FrameNum > LastEncodedFrame + 1)
+			{
+				Stats.FramesDropped += FrameNum - LastEncodedFrame - 1;
+			}
+			++Stats.FramesSuppressed;
+			Stats.SceneChange = SceneChange;
+		}
+
+		LastSuppressedFrame.Store(FrameNum);
+		LastEncodedFrame = FrameNum;
+		return;
+	}
+
+	// Camera and scene motion against the last frame analyzed; runs on unchanged frames too, so the chain stays unbroken
+	if (Current.bMotion)
+	{
+		Meta.Motion = PixelBus->GetMotionEstimator().Update(*Source, Current.MaxWorkers);
+	}
+	const double MotionTime = FPlatformTime::Seconds();
+
+	// Nothing changed since the frame we last published with these settings: reuse its image
+	const bool bUnchanged = bSameSettings && Changes.IsValid() && Changes->bUnchanged
+		&& Previous->Packet.FrameNumber == Changes->BaseFrame;
+
+	const int64 PreviousFrame = Previous.IsValid() ? Previous->Packet.FrameNumber : 0;
+
+	TArray<uint8> Encoded;
+	TSharedPtr<const TArray<FColor>, ESPMode::ThreadSafe> ResizedPixels;
+	double ResizeTime = MotionTime;
+	double AnalyzeTime = MotionTime;
+	if (bUnchanged)
+	{
+		Encoded = Previous->Packet.ImageData;
+		Meta.ImageStats = Previous->Packet.Metadata.ImageStats;
+		ResizedPixels = Previous->ResizedPixels;
+	}
+	else
+	{
+		TArray<FColor> Resized;
+		const bool bResize = (Source->Size != Current.Resolution);
+		if (bResize)
+		{
+			Resized = FPerceptionAdapter::Resize(Source->Pixels, Source->Size, Current.Resolution, Current.MaxWorkers);
+		}
+
+		ResizeTime = FPlatformTime::Seconds();
+
+		// Over the pixels actually served, while they are still in cache
+		if (Current.bImageStats)
+		{
+			Meta.ImageStats = FPerceptionAdapter::ComputeImageStats(bResize ? Resized : Source->Pixels,
+			                                                        Current.Resolution, Current.MaxWorkers);
+		}
+
+		AnalyzeTime = FPlatformTime::Seconds();
+
+		Encoded = FPerceptionAdapter::Encode(bResize ? Resized : Source->Pixels,
+		                                     Current.Resolution, Current.Format,
+		                                     Current.Quality, Current.MaxWorkers);
+		if (bResize)
+		{
+			ResizedPixels = MakeShared<TArray<FColor>, ESPMode::ThreadSafe>(MoveTemp(Resized));
+		}
+	}
+	Previous.Reset();
+
+	// Give the pooled buffer back before publishing
+	Source.Reset();
+
+	const double EncodeTime = FPlatformTime::Seconds();
+
+	if (Encoded.Num() == 0)
+	{
+		// Not retried until a new frame or new settings arrive; the last good packet stays up
+		if (LastFailedVersion == -1)
+		{
+			UE_LOG(LogViewportPerception, Warning, TEXT("Failed to encode frame %lld at %dx%d"),
+				FrameNum, Current.Resolution.X, Current.Resolution.Y);
+		}
+		LastEncodedFrame = FrameNum;
+		LastFailedVersion = Version;
+		return;
+	}
+
+	TSharedRef<FPerceptionEncodedFrame, ESPMode::ThreadSafe> Frame = MakeShared<FPerceptionEncodedFrame, ESPMode::ThreadSafe>();
+	Frame->Settings = Current;
+	Frame->ResizedPixels = MoveTemp(ResizedPixels);
+	Frame->Packet.ImageData = MoveTemp(Encoded);
+	Frame->Packet.Width = Current.Resolution.X;
+	Frame->Packet.Height = Current.Resolution.Y;
+	Frame->Packet.Format = Current.Format;
+	Frame->Packet.FrameNumber = FrameNum;
+	Frame->Packet.Timestamp = Timestamp;
+	Frame->Packet.Metadata = MoveTemp(Meta);
+	Frame->Packet.PerceptualHash = static_cast<int64>(PerceptualHash);
+	Frame->Packet.SceneChange = SceneChange;
+	if (Changes.IsValid())
+	{
+		Frame->Packet.Changes = *Changes;
+	}
+	Frame->Packet.bValid = true;
+
+	{
+		FScopeLock Lock(&SlotLock);
+		LatestFrame = Frame;
+	}
+
+	History.Add(Frame->Packet, bUnchanged ? PreviousFrame : 0);
+	Recorder.Enqueue(Frame);
+
+	{
+		FScopeLock Lock(&StatsLock);
+
+		// Frame numbers are consecutive, so any gap was overwritten on the bus before we got to it
+		if (LastEncodedFrame > 0 && FrameNum > LastEncodedFrame + 1)
+		{
+			Stats.FramesDropped += FrameNum - LastEncodedFrame - 1;
+		}
+
+		++Stats.FramesEncoded;
+		Stats.FramesUnchanged += bUnchanged ? 1 : 0;
+		Stats.SceneChange = SceneChange;
+		Stats.LastFrameNumber = FrameNum;
+		Stats.ReadMs = (ReadTime - StartTime) * 1000.0;
+		Stats.HashMs = (HashTime - ReadTime) * 1000.0;
+		Stats.MotionMs = (MotionTime - HashTime) * 1000.0;
+		Stats.ResizeMs = (ResizeTime - MotionTime) * 1000.0;
+		Stats.AnalyzeMs = (AnalyzeTime - ResizeTime) * 1000.0;
+		Stats.EncodeMs = (EncodeTime - AnalyzeTime) * 1000.0;
+		Stats.TotalMs = (EncodeTime - StartTime) * 1000.0;
+		Stats.AverageTotalMs = (Stats.FramesEncoded == 1)
+			? Stats.TotalMs
+			: FMath::Lerp(Stats.AverageTotalMs, Stats.TotalMs, 0.1);
+		Stats.LatencyMs = (EncodeTime - Timestamp) * 1000.0;
+	}
+
+	LastEncodedFrame = FrameNum;
+	LastEncodedVersion = Version;
+	LastFailedVersion = -1;
+
+	{
+		FScopeLock Lock(&PublishCallbackLock);
+		if (PublishCallback)
+		{
+			PublishCallback(FrameNum);
+		}
+	}
+}
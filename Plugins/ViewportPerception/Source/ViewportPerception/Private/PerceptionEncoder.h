@@ -0,0 +1,172 @@
+// PerceptionEncoder.h
+// Worker-thread stage between PixelBus and PerceptionEndpoint.
+// Picks up frames as they land, resizes and encodes them with the current
+// settings, and publishes the result to a latest-value slot that request
+// handlers read without touching pixels. Frames that land while an encode is
+// running are dropped in favour of the newest one, so the producer never waits.
+// Frames whose tiles all match the previous published frame reuse its encoded
+// image instead of being resized and encoded again. With MinSceneChange set,
+// frames that differ too little from the last published one (by perceptual
+// hash) are not published at all. Block motion, when enabled, is estimated on
+// every published frame, unchanged ones included. The resized pixels behind the
+// latest packet are kept with it, so the pyramid can start from them instead of
+// reading the full frame again. Published packets are also
+// kept in a bounded history ring (PerceptionHistory.h) for lookups by time,
+// and handed to the recorder (PerceptionRecorder.h) while one is running.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "PerceptionTypes.h"
+#include "PerceptionHistory.h"
+#include "PerceptionRecorder.h"
+
+class FPixelBus;
+class FRunnableThread;
+class FEvent;
+
+/** Settings the encoder applies to every frame. */
+struct FPerceptionEncodeSettings
+{
+	FIntPoint Resolution = FIntPoint(1280, 720);
+	EPerceptionImageFormat Format = EPerceptionImageFormat::JPEG;
+	int32 Quality = 85;
+	int32 MaxWorkers = 1;
+
+	/** Publish a frame only if its scene-change score against the last published frame
+	 *  exceeds this (0 publishes every frame). */
+	float MinSceneChange = 0.0f;
+
+	/** Compute FPerceptionImageStats over the resized image before encoding it. */
+	bool bImageStats = false;
+
+	/** Estimate block motion against the previous analyzed frame (FPerceptionMotion). */
+	bool bMotion = false;
+
+	/** Quality as it affects the output: clamped for JPEG, 0 for PNG. */
+	static int32 NormalizeQuality(EPerceptionImageFormat Format, int32 Quality)
+	{
+		return (Format == EPerceptionImageFormat::JPEG) ? FMath::Clamp(Quality, 1, 100) : 0;
+	}
+};
+
+/** A published packet and the settings it was encoded with. */
+struct FPerceptionEncodedFrame
+{
+	FPerceptionPacket Packet;
+	FPerceptionEncodeSettings Settings;
+
+	/** Pixels Packet was encoded from, at Settings.Resolution; null if the frame was already that size */
+	TSharedPtr<const TArray<FColor>, ESPMode::ThreadSafe> ResizedPixels;
+};
+
+/** Throughput counters and per-stage timing of the most recent frame, in milliseconds. */
+struct FPerceptionEncoderStats
+{
+	int64 FramesEncoded = 0;
+	int64 FramesDropped = 0;
+	int64 LastFrameNumber = 0;
+
+	/** Frames published with the previous frame's image because no tile changed */
+	int64 FramesUnchanged = 0;
+
+	/** Frames not published because they changed less than MinSceneChange */
+	int64 FramesSuppressed = 0;
+
+	/** Scene-change score of the most recent frame, published or not */
+	float SceneChange = 0.0f;
+
+	double ReadMs = 0.0;
+	double HashMs = 0.0;
+	double MotionMs = 0.0;
+	double ResizeMs = 0.0;
+	double AnalyzeMs = 0.0;
+	double EncodeMs = 0.0;
+	double TotalMs = 0.0;
+
+	/** Exponential moving average of TotalMs */
+	double AverageTotalMs = 0.0;
+
+	/** Capture timestamp to publish */
+	double LatencyMs = 0.0;
+};
+
+class FPerceptionEncoder : public FRunnable
+{
+public:
+	explicit FPerceptionEncoder(FPixelBus* InPixelBus);
+	virtual ~FPerceptionEncoder() override;
+
+	/** Spawn the worker thread and subscribe to frame writes on the bus. */
+	void Start();
+
+	/** Unsubscribe from the bus and join the worker thread. */
+	void Shutdown();
+
+	/** True while the worker thread is publishing packets. */
+	bool IsRunning() const { return Thread != nullptr; }
+
+	/** Replace the encode settings. The latest frame is re-encoded if they changed. */
+	void Configure(const FPerceptionEncodeSettings& InSettings);
+
+	/** Most recently published frame, or null. Only copies a shared pointer. */
+	TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> GetLatest() const;
+
+	FPerceptionEncoderStats GetStats() const;
+
+	/** Most recent frame held back by MinSceneChange; the latest packet stands in for it. */
+	int64 GetLastSuppressedFrame() const { return LastSuppressedFrame.Load(); }
+
+	/** Recently published packets. Thread-safe. */
+	FPerceptionHistory& GetHistory() { return History; }
+
+	/** Writes published packets to disk while started. Thread-safe. */
+	FPerceptionRecorder& GetRecorder() { return Recorder; }
+
+	/** Called on the worker thread after every publish, with the packet's frame number, so
+	 *  waiters can be woken instead of polling. Keep it short; null clears it. Thread-safe. */
+	void SetPublishCallback(TFunction<void(int64)> InCallback);
+
+	/** Pass metadata collected for FrameNumber on to the packet copies kept after publishing. */
+	void AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber);
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	/** Encode the bus's latest frame if it hasn't been published with the current settings yet. */
+	void EncodeLatest();
+
+	FPixelBus* PixelBus = nullptr;
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	TAtomic<bool> bStopRequested;
+
+	mutable FCriticalSection SettingsLock;
+	FPerceptionEncodeSettings Settings;
+	int32 SettingsVersion = 0;
+
+	mutable FCriticalSection SlotLock;
+	TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> LatestFrame;
+
+	mutable FCriticalSection StatsLock;
+	FPerceptionEncoderStats Stats;
+
+	TAtomic<int64> LastSuppressedFrame { 0 };
+
+	/** Held while the callback runs, so clearing it waits for a call in progress */
+	FCriticalSection PublishCallbackLock;
+	TFunction<void(int64)> PublishCallback;
+
+	FPerceptionHistory History;
+	FPerceptionRecorder Recorder;
+
+	// Worker thread only
+	int64 LastEncodedFrame = 0;
+	int32 LastEncodedVersion = -1;
+
+	/** Settings version LastEncodedFrame failed to encode with, -1 after a success */
+	int32 LastFailedVersion = -1;
+};
@@ -3,15 +3,221 @@
 #include "PerceptionEndpoint.h"
 #include "ViewportPerceptionSubsystem.h"
 #include "ViewportPerceptionModule.h"
+#include "PerceptionStream.h"
+#include "PerceptionMotion.h"
 #include "HttpServerModule.h"
 #include "IHttpRouter.h"
 #include "HttpServerRequest.h"
 #include "HttpServerResponse.h"
 #include "Misc/Base64.h"
+#include "Misc/Paths.h"
 #include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
 #include "Serialization/JsonReader.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+namespace
+{
+	/** Directory of the recording called Name under Saved/Perception/Recordings. False if Name
+	 *  is empty or would leave that directory. */
+	bool ResolveRecordingDirectory(const FString& Name, FString& OutDirectory)
+	{
+		const FString FileName = FPaths::MakeValidFileName(Name);
+		if (FileName.IsEmpty() || FileName.StartsWith(TEXT(".")))
+		{
+			return false;
+		}
+
+		OutDirectory = FPaths::Combine(FPerceptionRecorder::GetRecordingsRoot(), FileName);
+		return true;
+	}
+
+	/** Metadata members shared by the JSON body and the binary route's metadata header. */
+	template <class PrintPolicy>
+	void WriteMetadataFields(TJsonWriter<TCHAR, PrintPolicy>& Writer, const FPerceptionMetadata& Metadata,
+	                         bool bScalarsOnly = false)
+	{
+		// Camera
+		Writer.WriteObjectStart(TEXT("camera"));
+		Writer.WriteArrayStart(TEXT("location"));
+		Writer.WriteValue(Metadata.Camera.Location.X);
+		Writer.WriteValue(Metadata.Camera.Location.Y);
+		Writer.WriteValue(Metadata.Camera.Location.Z);
+		Writer.WriteArrayEnd();
+		Writer.WriteArrayStart(TEXT("rotation"));
+		Writer.WriteValue(Metadata.Camera.Rotation.Pitch);
+		Writer.WriteValue(Metadata.Camera.Rotation.Yaw);
+		Writer.WriteValue(Metadata.Camera.Rotation.Roll);
+		Writer.WriteArrayEnd();
+		Writer.WriteValue(TEXT("fov"), Metadata.Camera.FOV);
+		Writer.WriteObjectEnd();
+
+		// Viewport
+		Writer.WriteObjectStart(TEXT("viewport"));
+		Writer.WriteArrayStart(TEXT("size"));
+		Writer.WriteValue(Metadata.ViewportSize.X);
+		Writer.WriteValue(Metadata.ViewportSize.Y);
+		Writer.WriteArrayEnd();
+		Writer.WriteValue(TEXT("type"), Metadata.ViewportType);
+		Writer.WriteObjectEnd();
+
+		// Selection
+		if (bScalarsOnly)
+		{
+			Writer.WriteValue(TEXT("selection_count"), Metadata.SelectedActors.Num());
+		}
+		else
+		{
+			Writer.WriteArrayStart(TEXT("selection"));
+			for (const FString& Name : Metadata.SelectedActors)
+			{
+				Writer.WriteValue(Name);
+			}
+			Writer.WriteArrayEnd();
+		}
+
+		// [x, y, width, height] as fractions of the viewport
+		if (Metadata.SelectionBounds.bIsValid)
+		{
+			const FVector2D BoundsSize = Metadata.SelectionBounds.GetSize();
+			Writer.WriteArrayStart(TEXT("selection_bounds"));
+			Writer.WriteValue(Metadata.SelectionBounds.Min.X);
+			Writer.WriteValue(Metadata.SelectionBounds.Min.Y);
+			Writer.WriteValue(BoundsSize.X);
+			Writer.WriteValue(BoundsSize.Y);
+			Writer.WriteArrayEnd();
+		}
+
+		// Scene
+		Writer.WriteObjectStart(TEXT("scene"));
+		Writer.WriteValue(TEXT("map"), Metadata.MapName);
+		Writer.WriteValue(TEXT("actor_count"), Metadata.ActorCount);
+		Writer.WriteObjectEnd();
+
+		// Timing
+		Writer.WriteObjectStart(TEXT("timing"));
+		Writer.WriteValue(TEXT("delta_time"), Metadata.DeltaTime);
+		Writer.WriteValue(TEXT("fps"), Metadata.FPS);
+		Writer.WriteObjectEnd();
+
+		// Image statistics, when enabled
+		const FPerceptionImageStats& Stats = Metadata.ImageStats;
+		if (Stats.bValid)
+		{
+			Writer.WriteObjectStart(TEXT("image_stats"));
+			Writer.WriteArrayStart(TEXT("mean"));
+			Writer.WriteValue(Stats.Mean.X);
+			Writer.WriteValue(Stats.Mean.Y);
+			Writer.WriteValue(Stats.Mean.Z);
+			Writer.WriteArrayEnd();
+			Writer.WriteArrayStart(TEXT("variance"));
+			Writer.WriteValue(Stats.Variance.X);
+			Writer.WriteValue(Stats.Variance.Y);
+			Writer.WriteValue(Stats.Variance.Z);
+			Writer.WriteArrayEnd();
+			Writer.WriteValue(TEXT("mean_luma"), Stats.MeanLuma);
+			if (!bScalarsOnly)
+			{
+				Writer.WriteArrayStart(TEXT("luma_histogram"));
+				for (const float Bin : Stats.LumaHistogram)
+				{
+					Writer.WriteValue(Bin);
+				}
+				Writer.WriteArrayEnd();
+			}
+			Writer.WriteValue(TEXT("edge_density"), Stats.EdgeDensity);
+			Writer.WriteValue(TEXT("overexposed"), Stats.Overexposed);
+			Writer.WriteValue(TEXT("underexposed"), Stats.Underexposed);
+			Writer.WriteObjectEnd();
+		}
+
+		// Block motion, when enabled
+		const FPerceptionMotion& Motion = Metadata.Motion;
+		if (Motion.bValid)
+		{
+			const TCHAR* Kind = TEXT("static");
+			switch (Motion.Kind)
+			{
+			case EPerceptionMotionKind::Camera: Kind = TEXT("camera"); break;
+			case EPerceptionMotionKind::Scene:  Kind = TEXT("scene"); break;
+			case EPerceptionMotionKind::Mixed:  Kind = TEXT("mixed"); break;
+			default: break;
+			}
+
+			Writer.WriteObjectStart(TEXT("motion"));
+			Writer.WriteValue(TEXT("base_frame"), Motion.BaseFrame);
+			Writer.WriteValue(TEXT("kind"), Kind);
+			Writer.WriteArrayStart(TEXT("translation"));
+			Writer.WriteValue(Motion.CameraTranslation.X);
+			Writer.WriteValue(Motion.CameraTranslation.Y);
+			Writer.WriteArrayEnd();
+			Writer.WriteValue(TEXT("zoom"), Motion.CameraZoom);
+			Writer.WriteValue(TEXT("coherence"), Motion.Coherence);
+			Writer.WriteValue(TEXT("local_motion"), Motion.LocalMotion);
+			Writer.WriteValue(TEXT("block_size"), Motion.BlockSize);
+			Writer.WriteArrayStart(TEXT("grid"));
+			Writer.WriteValue(Motion.GridSize.X);
+			Writer.WriteValue(Motion.GridSize.Y);
+			Writer.WriteArrayEnd();
+
+			// Row-major x, y pairs in capture pixels
+			if (!bScalarsOnly)
+			{
+				Writer.WriteArrayStart(TEXT("vectors"));
+				for (const FIntPoint& Vector : Motion.Vectors)
+				{
+					Writer.WriteValue(Vector.X);
+					Writer.WriteValue(Vector.Y);
+				}
+				Writer.WriteArrayEnd();
+			}
+			Writer.WriteObjectEnd();
+		}
+	}
+
+	/** Changed-tile members shared by packets and /perception/changes. bScalarsOnly leaves out
+	 *  the bitmap and regions. */
+	template <class PrintPolicy>
+	void WriteChangesFields(TJsonWriter<TCHAR, PrintPolicy>& Writer, const FPerceptionChanges& Changes,
+	                        bool bScalarsOnly = false)
+	{
+		Writer.WriteValue(TEXT("base_frame"), Changes.BaseFrame);
+		Writer.WriteValue(TEXT("unchanged"), Changes.bUnchanged);
+		Writer.WriteValue(TEXT("changed_tiles"), Changes.ChangedTiles);
+		Writer.WriteValue(TEXT("tile_size"), Changes.TileSize);
+		Writer.WriteArrayStart(TEXT("grid"));
+		Writer.WriteValue(Changes.GridSize.X);
+		Writer.WriteValue(Changes.GridSize.Y);
+		Writer.WriteArrayEnd();
+		Writer.WriteArrayStart(TEXT("frame_size"));
+		Writer.WriteValue(Changes.FrameSize.X);
+		Writer.WriteValue(Changes.FrameSize.Y);
+		Writer.WriteArrayEnd();
+
+		if (bScalarsOnly)
+		{
+			return;
+		}
+
+		// One bit per tile, row-major, least significant bit first
+		Writer.WriteValue(TEXT("bitmap"), FBase64::Encode(Changes.Bitmap.GetData(), Changes.Bitmap.Num()));
+
+		// [x, y, width, height] in capture pixels
+		Writer.WriteArrayStart(TEXT("regions"));
+		for (const FIntRect& Region : Changes.Regions)
+		{
+			Writer.WriteArrayStart();
+			Writer.WriteValue(Region.Min.X);
+			Writer.WriteValue(Region.Min.Y);
+			Writer.WriteValue(Region.Width());
+			Writer.WriteValue(Region.Height());
+			Writer.WriteArrayEnd();
+		}
+		Writer.WriteArrayEnd();
+	}
+}
 
 FPerceptionEndpoint::FPerceptionEndpoint(UViewportPerceptionSubsystem* InSubsystem)
 	: Subsystem(InSubsystem)
@@ -46,6 +252,34 @@ void FPerceptionEndpoint::Start()
 		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleFrame)
 	));
 
+	// GET /perception/frame.bin
+	RouteHandles.Add(Router->BindRoute(
+		FHttpPath(TEXT("/perception/frame.bin")),
+		EHttpServerRequestVerbs::VERB_GET,
+		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleFrameBinary)
+	));
+
+	// GET /perception/changes
+	RouteHandles.Add(Router->BindRoute(
+		FHttpPath(TEXT("/perception/changes")),
+		EHttpServerRequestVerbs::VERB_GET,
+		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleChanges)
+	));
+
+	// GET /perception/history
+	RouteHandles.Add(Router->BindRoute(
+		FHttpPath(TEXT("/perception/history")),
+		EHttpServerRequestVerbs::VERB_GET,
+		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleHistory)
+	));
+
+	// GET /perception/stream (redirects to the stream listener)
+	RouteHandles.Add(Router->BindRoute(
+		FHttpPath(TEXT("/perception/stream")),
+		EHttpServerRequestVerbs::VERB_GET,
+		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleStream)
+	));
+
 	// GET /perception/status
 	RouteHandles.Add(Router->BindRoute(
 		FHttpPath(TEXT("/perception/status")),
@@ -74,6 +308,20 @@ void FPerceptionEndpoint::Start()
 		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleStop)
 	));
 
+	// PUT /perception/record
+	RouteHandles.Add(Router->BindRoute(
+		FHttpPath(TEXT("/perception/record")),
+		EHttpServerRequestVerbs::VERB_PUT,
+		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleRecord)
+	));
+
+	// PUT /perception/replay
+	RouteHandles.Add(Router->BindRoute(
+		FHttpPath(TEXT("/perception/replay")),
+		EHttpServerRequestVerbs::VERB_PUT,
+		FHttpRequestHandler::CreateRaw(this, &FPerceptionEndpoint::HandleReplay)
+	));
+
 	// GET /perception/single
 	RouteHandles.Add(Router->BindRoute(
 		FHttpPath(TEXT("/perception/single")),
@@ -113,6 +361,19 @@ void FPerceptionEndpoint::Stop()
 	}
 
 	RouteHandles.Empty();
+
+	// Answer parked long polls rather than leaving their connections hanging
+	if (WaiterTickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(WaiterTickHandle);
+		WaiterTickHandle.Reset();
+	}
+	for (FFrameWaiter& Waiter : Waiters)
+	{
+		SendJsonResponse(Waiter.OnComplete, TEXT("{\"error\":\"Endpoint stopped\"}"), 503);
+	}
+	Waiters.Empty();
+
 	bRunning = false;
 
 	UE_LOG(LogViewportPerception, Log, TEXT("HTTP endpoint stopped"));
@@ -120,6 +381,19 @@ void FPerceptionEndpoint::Stop()
 
 bool FPerceptionEndpoint::HandleFrame(const FHttpServerRequest& Request,
                                        const FHttpResultCallback& OnComplete)
+{
+	// Clients that ask for an image get the same body as /perception/frame.bin
+	return ServeFrame(Request, OnComplete, AcceptsBinary(Request));
+}
+
+bool FPerceptionEndpoint::HandleFrameBinary(const FHttpServerRequest& Request,
+                                             const FHttpResultCallback& OnComplete)
+{
+	return ServeFrame(Request, OnComplete, true);
+}
+
+bool FPerceptionEndpoint::ServeFrame(const FHttpServerRequest& Request,
+                                      const FHttpResultCallback& OnComplete, bool bBinary)
 {
 	if (!Subsystem)
 	{
@@ -127,7 +401,124 @@ bool FPerceptionEndpoint::HandleFrame(const FHttpServerRequest& Request,
 		return true;
 	}
 
-	FPerceptionPacket Packet = Subsystem->GetLatestPacket();
+	// History: ?at=<timestamp> (platform seconds as in "timestamp"; negative is seconds before now)
+	// or ?frame=<frame_number> answers with the packet that was on screen then
+	const FString* At = Request.QueryParams.Find(TEXT("at"));
+	const FString* FrameParam = Request.QueryParams.Find(TEXT("frame"));
+
+	// Region of interest: ?roi=x,y,w,h in capture pixels (as change regions are) or ?roi=selection,
+	// cut from the captured frame before any resize; ?width= then sets the output width
+	if (const FString* Roi = Request.QueryParams.Find(TEXT("roi")))
+	{
+		if (At || FrameParam || Request.QueryParams.Contains(TEXT("after")))
+		{
+			SendJsonResponse(OnComplete, TEXT("{\"error\":\"roi applies to the latest frame only\"}"), 400);
+			return true;
+		}
+
+		if (Subsystem->IsReplaying())
+		{
+			SendJsonResponse(OnComplete, TEXT("{\"error\":\"Region requests need the live viewport\"}"), 409);
+			return true;
+		}
+
+		FIntRect Region;
+		if (Roi->Equals(TEXT("selection"), ESearchCase::IgnoreCase))
+		{
+			if (!Subsystem->GetSelectionRegion(Region))
+			{
+				SendJsonResponse(OnComplete, TEXT("{\"error\":\"No selected actor on screen\"}"), 404);
+				return true;
+			}
+		}
+		else
+		{
+			TArray<FString> Parts;
+			Roi->ParseIntoArray(Parts, TEXT(","));
+			if (Parts.Num() != 4 || Parts.ContainsByPredicate([](const FString& Part) { return !Part.IsNumeric(); }))
+			{
+				SendJsonResponse(OnComplete, TEXT("{\"error\":\"roi must be x,y,w,h or selection\"}"), 400);
+				return true;
+			}
+
+			const FIntPoint Min(FCString::Atoi(*Parts[0]), FCString::Atoi(*Parts[1]));
+			Region = FIntRect(Min, Min + FIntPoint(FCString::Atoi(*Parts[2]), FCString::Atoi(*Parts[3])));
+		}
+
+		const FString* OutputWidth = Request.QueryParams.Find(TEXT("width"));
+		FPerceptionPacket Packet = Subsystem->GetRegionPacket(Region, OutputWidth ? FCString::Atoi(**OutputWidth) : 0);
+		if (!Packet.bValid)
+		{
+			SendJsonResponse(OnComplete, TEXT("{\"error\":\"Region is empty or no frame available\"}"), 404);
+			return true;
+		}
+
+		SendPacket(OnComplete, MoveTemp(Packet), bBinary);
+		return true;
+	}
+
+	// Pyramid: ?level=<n> or ?width=<px> (the smallest level at least that wide)
+	const FString* LevelParam = Request.QueryParams.Find(TEXT("level"));
+	const FString* WidthParam = Request.QueryParams.Find(TEXT("width"));
+	int32 Level = INDEX_NONE;
+	if (LevelParam)
+	{
+		Level = FMath::Max(FCString::Atoi(**LevelParam), 0);
+	}
+	else if (WidthParam)
+	{
+		Level = Subsystem->FindPyramidLevel(FCString::Atoi(**WidthParam));
+	}
+
+	if (At || FrameParam)
+	{
+		// History keeps the published packets only
+		if (Level != INDEX_NONE)
+		{
+			SendJsonResponse(OnComplete, TEXT("{\"error\":\"Level and width apply to the latest frame only\"}"), 400);
+			return true;
+		}
+
+		FPerceptionPacket Packet;
+		bool bFound = false;
+		if (At)
+		{
+			double Timestamp = FCString::Atod(**At);
+			if (Timestamp < 0.0)
+			{
+				Timestamp += Subsystem->GetPacketClock();
+			}
+			bFound = Subsystem->GetHistoryPacketAt(Timestamp, Packet);
+		}
+		else
+		{
+			bFound = Subsystem->GetHistoryPacket(FCString::Atoi64(**FrameParam), Packet);
+		}
+
+		if (!bFound)
+		{
+			SendJsonResponse(OnComplete, TEXT("{\"error\":\"Not in history\"}"), 404);
+			return true;
+		}
+
+		SendPacket(OnComplete, MoveTemp(Packet), bBinary);
+		return true;
+	}
+
+	// Long poll: ?after=<frame_number>&timeout=<ms> answers with the first frame newer than after
+	if (const FString* After = Request.QueryParams.Find(TEXT("after")))
+	{
+		FFrameWaiter Waiter;
+		Waiter.OnComplete = OnComplete;
+		Waiter.AfterFrame = FCString::Atoi64(**After);
+		Waiter.Deadline = FPlatformTime::Seconds() + GetTimeoutSeconds(Request, DefaultLongPollTimeoutMs);
+		Waiter.bBinary = bBinary;
+		Waiter.Level = Level;
+		ParkWaiter(MoveTemp(Waiter));
+		return true;
+	}
+
+	FPerceptionPacket Packet = (Level != INDEX_NONE) ? Subsystem->GetPyramidPacket(Level) : Subsystem->GetLatestPacket();
 
 	if (!Packet.bValid)
 	{
@@ -135,82 +526,300 @@ bool FPerceptionEndpoint::HandleFrame(const FHttpServerRequest& Request,
 		return true;
 	}
 
-	// Build JSON response
-	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	SendPacket(OnComplete, MoveTemp(Packet), bBinary);
+	return true;
+}
+
+bool FPerceptionEndpoint::HandleChanges(const FHttpServerRequest& Request,
+                                         const FHttpResultCallback& OnComplete)
+{
+	if (!Subsystem)
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Subsystem not available\"}"), 503);
+		return true;
+	}
+
+	// ?since=<frame_number>: everything that changed after that frame; default is the previous frame
+	int64 Since = -1;
+	if (const FString* SinceParam = Request.QueryParams.Find(TEXT("since")))
+	{
+		Since = FCString::Atoi64(**SinceParam);
+	}
+
+	FPerceptionChanges Changes;
+	int64 FrameNumber = 0;
+	if (!Subsystem->GetChangesSince(Since, Changes, FrameNumber))
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"No frame available\"}"), 404);
+		return true;
+	}
 
-	// Base64 encode the image
-	FString ImageBase64 = FBase64::Encode(Packet.ImageData.GetData(), Packet.ImageData.Num());
-	Root->SetStringField(TEXT("image"), ImageBase64);
-	Root->SetNumberField(TEXT("width"), Packet.Width);
-	Root->SetNumberField(TEXT("height"), Packet.Height);
-	Root->SetStringField(TEXT("format"),
-		Packet.Format == EPerceptionImageFormat::PNG ? TEXT("png") : TEXT("jpeg"));
-	Root->SetNumberField(TEXT("frame_number"), static_cast<double>(Packet.FrameNumber));
-	Root->SetNumberField(TEXT("timestamp"), Packet.Timestamp);
-
-	// Camera
-	TSharedRef<FJsonObject> CameraObj = MakeShared<FJsonObject>();
-	TArray<TSharedPtr<FJsonValue>> LocArr;
-	LocArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Location.X));
-	LocArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Location.Y));
-	LocArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Location.Z));
-	CameraObj->SetArrayField(TEXT("location"), LocArr);
-
-	TArray<TSharedPtr<FJsonValue>> RotArr;
-	RotArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Rotation.Pitch));
-	RotArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Rotation.Yaw));
-	RotArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Rotation.Roll));
-	CameraObj->SetArrayField(TEXT("rotation"), RotArr);
-	CameraObj->SetNumberField(TEXT("fov"), Packet.Metadata.Camera.FOV);
-	Root->SetObjectField(TEXT("camera"), CameraObj);
-
-	// Viewport
-	TSharedRef<FJsonObject> ViewportObj = MakeShared<FJsonObject>();
-	TArray<TSharedPtr<FJsonValue>> SizeArr;
-	SizeArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.ViewportSize.X));
-	SizeArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.ViewportSize.Y));
-	ViewportObj->SetArrayField(TEXT("size"), SizeArr);
-	ViewportObj->SetStringField(TEXT("type"), Packet.Metadata.ViewportType);
-	Root->SetObjectField(TEXT("viewport"), ViewportObj);
-
-	// Selection
-	TArray<TSharedPtr<FJsonValue>> SelArr;
-	for (const FString& Name : Packet.Metadata.SelectedActors)
-	{
-		SelArr.Add(MakeShared<FJsonValueString>(Name));
-	}
-	Root->SetArrayField(TEXT("selection"), SelArr);
-
-	// Scene
-	TSharedRef<FJsonObject> SceneObj = MakeShared<FJsonObject>();
-	SceneObj->SetStringField(TEXT("map"), Packet.Metadata.MapName);
-	SceneObj->SetNumberField(TEXT("actor_count"), Packet.Metadata.ActorCount);
-	Root->SetObjectField(TEXT("scene"), SceneObj);
-
-	// Timing
-	TSharedRef<FJsonObject> TimingObj = MakeShared<FJsonObject>();
-	TimingObj->SetNumberField(TEXT("delta_time"), Packet.Metadata.DeltaTime);
-	TimingObj->SetNumberField(TEXT("fps"), Packet.Metadata.FPS);
-	Root->SetObjectField(TEXT("timing"), TimingObj);
-
-	// Serialize
 	FString JsonBody;
 	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonBody);
-	FJsonSerializer::Serialize(Root, Writer);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("frame_number"), FrameNumber);
+	WriteChangesFields(*Writer, Changes);
+	Writer->WriteObjectEnd();
+	Writer->Close();
 
 	SendJsonResponse(OnComplete, JsonBody);
 	return true;
 }
 
+bool FPerceptionEndpoint::HandleHistory(const FHttpServerRequest& Request,
+                                         const FHttpResultCallback& OnComplete)
+{
+	FPerceptionHistoryStats Stats;
+	TArray<FPerceptionHistoryEntryInfo> Entries;
+	if (!Subsystem || !Subsystem->GetHistoryStats(Stats) || !Subsystem->GetHistoryEntries(Entries))
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Subsystem not available\"}"), 503);
+		return true;
+	}
+
+	// The ring holds live frames, which ?frame= and ?at= don't reach while a recording is served
+	if (Subsystem->IsReplaying())
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"History lists live frames; while replaying, the recording range is under replay in /perception/status\"}"), 409);
+		return true;
+	}
+
+	FString JsonBody;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonBody);
+	Writer->WriteObjectStart();
+
+	// Same clock as the entry timestamps, so clients can turn "3 s ago" into ?at=
+	Writer->WriteValue(TEXT("now"), FPlatformTime::Seconds());
+	Writer->WriteValue(TEXT("frames"), Stats.Frames);
+	Writer->WriteValue(TEXT("bytes"), Stats.Bytes);
+	Writer->WriteValue(TEXT("budget_bytes"), Stats.BudgetBytes);
+	Writer->WriteValue(TEXT("max_seconds"), Stats.MaxAgeSeconds);
+	Writer->WriteValue(TEXT("evicted"), Stats.Evicted);
+
+	Writer->WriteArrayStart(TEXT("entries"));
+	for (const FPerceptionHistoryEntryInfo& Entry : Entries)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("frame_number"), Entry.FrameNumber);
+		Writer->WriteValue(TEXT("timestamp"), Entry.Timestamp);
+		Writer->WriteValue(TEXT("width"), Entry.Width);
+		Writer->WriteValue(TEXT("height"), Entry.Height);
+		Writer->WriteValue(TEXT("format"), FString(Entry.Format == EPerceptionImageFormat::PNG ? TEXT("png") : TEXT("jpeg")));
+		Writer->WriteValue(TEXT("image_bytes"), Entry.ImageBytes);
+		Writer->WriteValue(TEXT("scene_change"), Entry.SceneChange);
+		Writer->WriteValue(TEXT("shared_image"), Entry.bSharedImage);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	SendJsonResponse(OnComplete, JsonBody);
+	return true;
+}
+
+bool FPerceptionEndpoint::HandleStream(const FHttpServerRequest& Request,
+                                        const FHttpResultCallback& OnComplete)
+{
+	if (!Subsystem || !Subsystem->IsStreamAvailable())
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Streaming not available\"}"), 503);
+		return true;
+	}
+
+	// The stream listens on IPv4 loopback only, so that is where clients go whatever name they
+	// reached us by. The query is rebuilt from the parameters the stream understands, as values
+	// it parses back unchanged, so nothing from the request is copied into the URL.
+	TArray<FString> Params;
+	if (const FString* FPSParam = Request.QueryParams.Find(TEXT("fps")))
+	{
+		const float FPS = FCString::Atof(**FPSParam);
+		if (FPS > 0.0f)
+		{
+			Params.Add(FString::Printf(TEXT("fps=%g"), FMath::Clamp(FPS, 0.1f, 60.0f)));
+		}
+	}
+	if (const FString* MetadataParam = Request.QueryParams.Find(TEXT("metadata")))
+	{
+		if (*MetadataParam == TEXT("part"))
+		{
+			Params.Add(TEXT("metadata=part"));
+		}
+	}
+	const FString Query = Params.Num() > 0 ? TEXT("?") + FString::Join(Params, TEXT("&")) : FString();
+
+	const FString Location = FString::Printf(TEXT("http://127.0.0.1:%d/perception/stream%s"),
+		FPerceptionStream::STREAM_PORT, *Query);
+
+	auto Response = FHttpServerResponse::Create(
+		FString::Printf(TEXT("{\"stream\":\"%s\"}"), *Location), TEXT("application/json"));
+	Response->Code = EHttpServerResponseCodes::Redirect;
+	Response->Headers.Add(TEXT("Location"), TArray<FString>{ Location });
+	OnComplete(MoveTemp(Response));
+	return true;
+}
+
 bool FPerceptionEndpoint::HandleStatus(const FHttpServerRequest& Request,
                                         const FHttpResultCallback& OnComplete)
 {
 	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
 
 	Root->SetBoolField(TEXT("capturing"), Subsystem ? Subsystem->IsCapturing() : false);
+	Root->SetBoolField(TEXT("recording"), Subsystem ? Subsystem->IsRecording() : false);
+	Root->SetBoolField(TEXT("replaying"), Subsystem ? Subsystem->IsReplaying() : false);
 	Root->SetBoolField(TEXT("has_new_frame"), Subsystem ? Subsystem->HasNewFrame() : false);
 	Root->SetNumberField(TEXT("port"), PERCEPTION_PORT);
 	Root->SetBoolField(TEXT("running"), bRunning);
+	Root->SetNumberField(TEXT("pixel_workers"), Subsystem ? Subsystem->GetMaxPixelWorkers() : 1);
+	Root->SetNumberField(TEXT("min_scene_change"), Subsystem ? Subsystem->GetMinSceneChange() : 0.0f);
+	Root->SetBoolField(TEXT("image_stats"), Subsystem ? Subsystem->IsImageStatsEnabled() : false);
+	Root->SetBoolField(TEXT("motion"), Subsystem ? Subsystem->IsMotionEnabled() : false);
+	Root->SetStringField(TEXT("motion_kernel"), FPerceptionMotionEstimator::GetKernelName());
+
+	if (Subsystem)
+	{
+		int64 Hits = 0, Misses = 0;
+		Subsystem->GetPacketCacheStats(Hits, Misses);
+		TSharedRef<FJsonObject> CacheObj = MakeShared<FJsonObject>();
+		CacheObj->SetNumberField(TEXT("hits"), static_cast<double>(Hits));
+		CacheObj->SetNumberField(TEXT("misses"), static_cast<double>(Misses));
+		Root->SetObjectField(TEXT("packet_cache"), CacheObj);
+
+		FPerceptionFramePoolStats PoolStats;
+		if (Subsystem->GetFramePoolStats(PoolStats))
+		{
+			TSharedRef<FJsonObject> PoolObj = MakeShared<FJsonObject>();
+			PoolObj->SetNumberField(TEXT("frames"), PoolStats.Frames);
+			PoolObj->SetNumberField(TEXT("free"), PoolStats.FreeFrames);
+			PoolObj->SetNumberField(TEXT("allocated_bytes"), static_cast<double>(PoolStats.AllocatedBytes));
+			PoolObj->SetNumberField(TEXT("max_frames"), PoolStats.MaxFrames);
+			PoolObj->SetNumberField(TEXT("budget_bytes"), static_cast<double>(PoolStats.BudgetBytes));
+			PoolObj->SetNumberField(TEXT("exhausted"), static_cast<double>(PoolStats.Exhausted));
+			Root->SetObjectField(TEXT("frame_pool"), PoolObj);
+		}
+
+		FPerceptionEncoderStats EncoderStats;
+		if (Subsystem->GetEncoderStats(EncoderStats))
+		{
+			TSharedRef<FJsonObject> EncoderObj = MakeShared<FJsonObject>();
+			EncoderObj->SetNumberField(TEXT("frames_encoded"), static_cast<double>(EncoderStats.FramesEncoded));
+			EncoderObj->SetNumberField(TEXT("frames_dropped"), static_cast<double>(EncoderStats.FramesDropped));
+			EncoderObj->SetNumberField(TEXT("frames_unchanged"), static_cast<double>(EncoderStats.FramesUnchanged));
+			EncoderObj->SetNumberField(TEXT("frames_suppressed"), static_cast<double>(EncoderStats.FramesSuppressed));
+			EncoderObj->SetNumberField(TEXT("scene_change"), EncoderStats.SceneChange);
+			EncoderObj->SetNumberField(TEXT("last_frame"), static_cast<double>(EncoderStats.LastFrameNumber));
+			EncoderObj->SetNumberField(TEXT("read_ms"), EncoderStats.ReadMs);
+			EncoderObj->SetNumberField(TEXT("hash_ms"), EncoderStats.HashMs);
+			EncoderObj->SetNumberField(TEXT("motion_ms"), EncoderStats.MotionMs);
+			EncoderObj->SetNumberField(TEXT("resize_ms"), EncoderStats.ResizeMs);
+			EncoderObj->SetNumberField(TEXT("analyze_ms"), EncoderStats.AnalyzeMs);
+			EncoderObj->SetNumberField(TEXT("encode_ms"), EncoderStats.EncodeMs);
+			EncoderObj->SetNumberField(TEXT("total_ms"), EncoderStats.TotalMs);
+			EncoderObj->SetNumberField(TEXT("avg_total_ms"), EncoderStats.AverageTotalMs);
+			EncoderObj->SetNumberField(TEXT("latency_ms"), EncoderStats.LatencyMs);
+			Root->SetObjectField(TEXT("encoder"), EncoderObj);
+		}
+
+		FPerceptionHistoryStats HistoryStats;
+		if (Subsystem->GetHistoryStats(HistoryStats))
+		{
+			TSharedRef<FJsonObject> HistoryObj = MakeShared<FJsonObject>();
+			HistoryObj->SetNumberField(TEXT("frames"), HistoryStats.Frames);
+			HistoryObj->SetNumberField(TEXT("bytes"), static_cast<double>(HistoryStats.Bytes));
+			HistoryObj->SetNumberField(TEXT("budget_bytes"), static_cast<double>(HistoryStats.BudgetBytes));
+			HistoryObj->SetNumberField(TEXT("max_seconds"), HistoryStats.MaxAgeSeconds);
+			HistoryObj->SetNumberField(TEXT("oldest_frame"), static_cast<double>(HistoryStats.OldestFrame));
+			HistoryObj->SetNumberField(TEXT("newest_frame"), static_cast<double>(HistoryStats.NewestFrame));
+			HistoryObj->SetNumberField(TEXT("oldest_timestamp"), HistoryStats.OldestTimestamp);
+			HistoryObj->SetNumberField(TEXT("newest_timestamp"), HistoryStats.NewestTimestamp);
+			HistoryObj->SetNumberField(TEXT("evicted"), static_cast<double>(HistoryStats.Evicted));
+			Root->SetObjectField(TEXT("history"), HistoryObj);
+		}
+
+		FPerceptionPyramidStats PyramidStats;
+		if (Subsystem->GetPyramidStats(PyramidStats))
+		{
+			TArray<TSharedPtr<FJsonValue>> LevelValues;
+			for (const FIntPoint& Size : Subsystem->GetPyramidLevelSizes())
+			{
+				TSharedRef<FJsonObject> LevelObj = MakeShared<FJsonObject>();
+				LevelObj->SetNumberField(TEXT("width"), Size.X);
+				LevelObj->SetNumberField(TEXT("height"), Size.Y);
+				LevelValues.Add(MakeShared<FJsonValueObject>(LevelObj));
+			}
+
+			TSharedRef<FJsonObject> PyramidObj = MakeShared<FJsonObject>();
+			PyramidObj->SetArrayField(TEXT("levels"), LevelValues);
+			PyramidObj->SetNumberField(TEXT("thumbnail_width"), PyramidStats.ThumbnailWidth);
+			PyramidObj->SetNumberField(TEXT("built_frame"), static_cast<double>(PyramidStats.BuiltFrame));
+			PyramidObj->SetNumberField(TEXT("built_bytes"), static_cast<double>(PyramidStats.BuiltBytes));
+			PyramidObj->SetNumberField(TEXT("builds"), static_cast<double>(PyramidStats.Builds));
+			PyramidObj->SetNumberField(TEXT("build_ms"), PyramidStats.LastBuildMs);
+			Root->SetObjectField(TEXT("pyramid"), PyramidObj);
+		}
+
+		FPerceptionRecorderStats RecorderStats;
+		if (Subsystem->GetRecorderStats(RecorderStats) && (RecorderStats.bRecording || RecorderStats.FramesWritten > 0))
+		{
+			TSharedRef<FJsonObject> RecorderObj = MakeShared<FJsonObject>();
+			RecorderObj->SetBoolField(TEXT("recording"), RecorderStats.bRecording);
+			RecorderObj->SetStringField(TEXT("directory"), FPaths::ConvertRelativePathToFull(RecorderStats.Directory));
+			RecorderObj->SetNumberField(TEXT("segments"), RecorderStats.Segments);
+			RecorderObj->SetNumberField(TEXT("frames_written"), static_cast<double>(RecorderStats.FramesWritten));
+			RecorderObj->SetNumberField(TEXT("bytes_written"), static_cast<double>(RecorderStats.BytesWritten));
+			RecorderObj->SetNumberField(TEXT("frames_dropped"), static_cast<double>(RecorderStats.FramesDropped));
+			RecorderObj->SetNumberField(TEXT("queued"), RecorderStats.Queued);
+			Root->SetObjectField(TEXT("recorder"), RecorderObj);
+		}
+
+		FPerceptionReplayStats ReplayStats;
+		if (Subsystem->GetReplayStats(ReplayStats))
+		{
+			TSharedRef<FJsonObject> ReplayObj = MakeShared<FJsonObject>();
+			ReplayObj->SetStringField(TEXT("directory"), FPaths::ConvertRelativePathToFull(ReplayStats.Directory));
+			ReplayObj->SetNumberField(TEXT("frames"), ReplayStats.Frames);
+			ReplayObj->SetNumberField(TEXT("first_frame"), static_cast<double>(ReplayStats.FirstFrame));
+			ReplayObj->SetNumberField(TEXT("last_frame"), static_cast<double>(ReplayStats.LastFrame));
+			ReplayObj->SetNumberField(TEXT("duration"), ReplayStats.Duration);
+			ReplayObj->SetNumberField(TEXT("speed"), ReplayStats.Speed);
+			ReplayObj->SetNumberField(TEXT("current_frame"), static_cast<double>(ReplayStats.CurrentFrame));
+			ReplayObj->SetBoolField(TEXT("finished"), ReplayStats.bFinished);
+			Root->SetObjectField(TEXT("replay"), ReplayObj);
+		}
+
+		// Layout is described in PerceptionSharedMemory.h
+		FPerceptionSharedMemoryInfo SharedInfo;
+		if (Subsystem->GetSharedMemoryInfo(SharedInfo))
+		{
+			TSharedRef<FJsonObject> SharedObj = MakeShared<FJsonObject>();
+			SharedObj->SetStringField(TEXT("name"), SharedInfo.Name);
+			SharedObj->SetNumberField(TEXT("bytes"), static_cast<double>(SharedInfo.TotalBytes));
+			SharedObj->SetNumberField(TEXT("version"), static_cast<int32>(FPerceptionSharedHeader::CurrentVersion));
+			SharedObj->SetNumberField(TEXT("header_bytes"), static_cast<int32>(sizeof(FPerceptionSharedHeader)));
+			SharedObj->SetNumberField(TEXT("slot_header_bytes"), static_cast<int32>(sizeof(FPerceptionSharedSlot)));
+			SharedObj->SetNumberField(TEXT("slots"), SharedInfo.SlotCount);
+			SharedObj->SetNumberField(TEXT("slot_stride"), SharedInfo.SlotStride);
+			SharedObj->SetNumberField(TEXT("max_width"), SharedInfo.MaxSize.X);
+			SharedObj->SetNumberField(TEXT("max_height"), SharedInfo.MaxSize.Y);
+			SharedObj->SetStringField(TEXT("pixel_format"), TEXT("bgra8"));
+			SharedObj->SetNumberField(TEXT("frames_written"), static_cast<double>(SharedInfo.FramesWritten));
+			SharedObj->SetNumberField(TEXT("frames_skipped"), static_cast<double>(SharedInfo.FramesSkipped));
+			Root->SetObjectField(TEXT("shared_memory"), SharedObj);
+		}
+
+		FPerceptionStreamStats StreamStats;
+		if (Subsystem->GetStreamStats(StreamStats))
+		{
+			TSharedRef<FJsonObject> StreamObj = MakeShared<FJsonObject>();
+			StreamObj->SetNumberField(TEXT("port"), FPerceptionStream::STREAM_PORT);
+			StreamObj->SetNumberField(TEXT("clients"), StreamStats.Clients);
+			StreamObj->SetNumberField(TEXT("frames_sent"), static_cast<double>(StreamStats.FramesSent));
+			StreamObj->SetNumberField(TEXT("frames_dropped"), static_cast<double>(StreamStats.FramesDropped));
+			StreamObj->SetNumberField(TEXT("bytes_sent"), static_cast<double>(StreamStats.BytesSent));
+			Root->SetObjectField(TEXT("stream"), StreamObj);
+		}
+	}
 
 	FString JsonBody;
 	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonBody);
@@ -270,6 +879,86 @@ bool FPerceptionEndpoint::HandleConfig(const FHttpServerRequest& Request,
 		{
 			Subsystem->SetJPEGQuality(Quality);
 		}
+
+		int32 Workers;
+		if (Body->TryGetNumberField(TEXT("workers"), Workers))
+		{
+			Subsystem->SetMaxPixelWorkers(Workers);
+		}
+
+		bool bImageStats = false;
+		if (Body->TryGetBoolField(TEXT("image_stats"), bImageStats))
+		{
+			Subsystem->SetImageStatsEnabled(bImageStats);
+		}
+
+		bool bMotion = false;
+		if (Body->TryGetBoolField(TEXT("motion"), bMotion))
+		{
+			Subsystem->SetMotionEnabled(bMotion);
+		}
+
+		double MinSceneChange;
+		if (Body->TryGetNumberField(TEXT("min_scene_change"), MinSceneChange))
+		{
+			Subsystem->SetMinSceneChange(static_cast<float>(MinSceneChange));
+		}
+
+		// Either pool limit may be given alone; the other keeps its current value
+		int32 PoolFrames = 0, PoolBudgetMB = 0;
+		const bool bPoolFrames = Body->TryGetNumberField(TEXT("pool_frames"), PoolFrames);
+		const bool bPoolBudget = Body->TryGetNumberField(TEXT("pool_budget_mb"), PoolBudgetMB);
+		if (bPoolFrames || bPoolBudget)
+		{
+			FPerceptionFramePoolStats Current;
+			Subsystem->GetFramePoolStats(Current);
+			Subsystem->SetFramePoolLimits(
+				PoolFrames > 0 ? PoolFrames : Current.MaxFrames,
+				PoolBudgetMB > 0 ? PoolBudgetMB : static_cast<int32>(Current.BudgetBytes / (1024 * 1024)));
+		}
+
+		// Either history limit may be given alone; 0 turns history off
+		double HistorySeconds = 0.0;
+		int32 HistoryBudgetMB = 0;
+		const bool bHistorySeconds = Body->TryGetNumberField(TEXT("history_seconds"), HistorySeconds);
+		const bool bHistoryBudget = Body->TryGetNumberField(TEXT("history_budget_mb"), HistoryBudgetMB);
+		if (bHistorySeconds || bHistoryBudget)
+		{
+			FPerceptionHistoryStats Current;
+			Subsystem->GetHistoryStats(Current);
+			Subsystem->SetHistoryLimits(
+				static_cast<float>(bHistorySeconds ? HistorySeconds : Current.MaxAgeSeconds),
+				bHistoryBudget ? HistoryBudgetMB : static_cast<int32>(Current.BudgetBytes / (1024 * 1024)));
+		}
+
+		// Either pyramid setting may be given alone
+		int32 PyramidLevels = 0, ThumbnailWidth = 0;
+		const bool bPyramidLevels = Body->TryGetNumberField(TEXT("pyramid_levels"), PyramidLevels);
+		const bool bThumbnailWidth = Body->TryGetNumberField(TEXT("thumbnail_width"), ThumbnailWidth);
+		if (bPyramidLevels || bThumbnailWidth)
+		{
+			FPerceptionPyramidStats Current;
+			Subsystem->GetPyramidStats(Current);
+			Subsystem->SetPyramidLevels(
+				bPyramidLevels ? PyramidLevels : Current.Levels,
+				bThumbnailWidth ? ThumbnailWidth : Current.ThumbnailWidth);
+		}
+
+		// {"shared_memory": true, "shm_width": 1280, "shm_height": 720, "shm_slots": 3}
+		bool bSharedMemory = false;
+		if (Body->TryGetBoolField(TEXT("shared_memory"), bSharedMemory))
+		{
+			int32 ShmWidth = 1920, ShmHeight = 1080, ShmSlots = 3;
+			Body->TryGetNumberField(TEXT("shm_width"), ShmWidth);
+			Body->TryGetNumberField(TEXT("shm_height"), ShmHeight);
+			Body->TryGetNumberField(TEXT("shm_slots"), ShmSlots);
+
+			if (!Subsystem->SetSharedMemoryExport(bSharedMemory, ShmWidth, ShmHeight, ShmSlots))
+			{
+				SendJsonResponse(OnComplete, TEXT("{\"error\":\"Failed to create shared memory\"}"), 500);
+				return true;
+			}
+		}
 	}
 
 	SendJsonResponse(OnComplete, TEXT("{\"status\":\"configured\"}"));
@@ -321,7 +1010,7 @@ bool FPerceptionEndpoint::HandleStop(const FHttpServerRequest& Request,
 	return true;
 }
 
-bool FPerceptionEndpoint::HandleSingle(const FHttpServerRequest& Request,
+bool FPerceptionEndpoint::HandleRecord(const FHttpServerRequest& Request,
                                         const FHttpResultCallback& OnComplete)
 {
 	if (!Subsystem)
@@ -330,102 +1019,437 @@ bool FPerceptionEndpoint::HandleSingle(const FHttpServerRequest& Request,
 		return true;
 	}
 
-	// If not capturing, start a temporary capture
-	const bool WasCapturing = Subsystem->IsCapturing();
-	if (!WasCapturing)
+	// {"enable": true, "name": "run1", "segment_mb": 256}; recordings go under Saved/Perception/Recordings
+	bool bEnable = true;
+	FString Name = FDateTime::Now().ToString();
+	int32 SegmentMB = 256;
+
+	if (Request.Body.Num() > 0)
+	{
+		FString BodyStr = UTF8_TO_TCHAR(reinterpret_cast<const char*>(Request.Body.GetData()));
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BodyStr);
+		TSharedPtr<FJsonObject> Body;
+
+		if (FJsonSerializer::Deserialize(Reader, Body) && Body.IsValid())
+		{
+			Body->TryGetBoolField(TEXT("enable"), bEnable);
+			Body->TryGetStringField(TEXT("name"), Name);
+			Body->TryGetNumberField(TEXT("segment_mb"), SegmentMB);
+		}
+	}
+
+	if (!bEnable)
+	{
+		Subsystem->StopRecording();
+		SendJsonResponse(OnComplete, TEXT("{\"status\":\"stopped\"}"));
+		return true;
+	}
+
+	FString Directory;
+	if (!ResolveRecordingDirectory(Name, Directory))
 	{
-		Subsystem->RequestSingleFrame();
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Invalid recording name\"}"), 400);
+		return true;
 	}
 
-	// Give the frame a moment to arrive, then try to read
-	// We schedule a delayed response via async
-	AsyncTask(ENamedThreads::GameThread, [this, OnComplete, WasCapturing]()
+	if (!Subsystem->StartRecording(Directory, SegmentMB))
 	{
-		if (!Subsystem)
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Failed to start recording\"}"), 409);
+		return true;
+	}
+
+	FString JsonBody;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonBody);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("status"), TEXT("recording"));
+	Writer->WriteValue(TEXT("directory"), FPaths::ConvertRelativePathToFull(Directory));
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	SendJsonResponse(OnComplete, JsonBody);
+	return true;
+}
+
+bool FPerceptionEndpoint::HandleReplay(const FHttpServerRequest& Request,
+                                        const FHttpResultCallback& OnComplete)
+{
+	if (!Subsystem)
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Subsystem not available\"}"), 503);
+		return true;
+	}
+
+	// {"enable": true, "name": "run1", "speed": 1.0}
+	bool bEnable = true;
+	FString Name;
+	double Speed = 1.0;
+
+	if (Request.Body.Num() > 0)
+	{
+		FString BodyStr = UTF8_TO_TCHAR(reinterpret_cast<const char*>(Request.Body.GetData()));
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BodyStr);
+		TSharedPtr<FJsonObject> Body;
+
+		if (FJsonSerializer::Deserialize(Reader, Body) && Body.IsValid())
 		{
-			SendJsonResponse(OnComplete, TEXT("{\"error\":\"Subsystem destroyed\"}"), 500);
-			return;
+			Body->TryGetBoolField(TEXT("enable"), bEnable);
+			Body->TryGetStringField(TEXT("name"), Name);
+			Body->TryGetNumberField(TEXT("speed"), Speed);
 		}
+	}
 
-		// Try to get a frame with a brief spin (up to 500ms)
-		FPerceptionPacket Packet;
-		constexpr float MaxWait = 0.5f;
-		constexpr float PollInterval = 0.05f;
-		float Waited = 0.0f;
+	if (!bEnable)
+	{
+		Subsystem->StopReplay();
+		SendJsonResponse(OnComplete, TEXT("{\"status\":\"live\"}"));
+		return true;
+	}
+
+	FString Directory;
+	if (!ResolveRecordingDirectory(Name, Directory) || !Subsystem->StartReplay(Directory, static_cast<float>(Speed)))
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Recording not found\"}"), 404);
+		return true;
+	}
 
-		while (Waited < MaxWait)
+	SendJsonResponse(OnComplete, TEXT("{\"status\":\"replaying\"}"));
+	return true;
+}
+
+bool FPerceptionEndpoint::HandleSingle(const FHttpServerRequest& Request,
+                                        const FHttpResultCallback& OnComplete)
+{
+	if (!Subsystem)
+	{
+		SendJsonResponse(OnComplete, TEXT("{\"error\":\"Subsystem not available\"}"), 503);
+		return true;
+	}
+
+	// One capture after this request; overlapping requests share it
+	FFrameWaiter Waiter;
+	Waiter.OnComplete = OnComplete;
+	Waiter.Deadline = FPlatformTime::Seconds() + GetTimeoutSeconds(Request, DefaultSingleTimeoutMs);
+	Waiter.bBinary = AcceptsBinary(Request);
+	Waiter.CaptureId = NextCaptureId++;
+	const uint64 CaptureId = Waiter.CaptureId;
+	Waiters.Add(MoveTemp(Waiter));
+
+	// Resolved on the game thread, possibly right away (replays)
+	TWeakPtr<bool, ESPMode::ThreadSafe> WeakToken = LifetimeToken;
+	Subsystem->CaptureSingleFrame().Next([this, WeakToken, CaptureId](FPerceptionPacket Packet)
+	{
+		if (WeakToken.IsValid())
 		{
-			Packet = Subsystem->GetLatestPacket();
-			if (Packet.bValid)
-			{
-				break;
-			}
-			FPlatformProcess::Sleep(PollInterval);
-			Waited += PollInterval;
+			CompleteCapture(CaptureId, MoveTemp(Packet));
+		}
+	});
+
+	ScheduleDeadlineTick();
+	return true;  // Completed from CompleteCapture or at the deadline
+}
+
+void FPerceptionEndpoint::ParkWaiter(FFrameWaiter&& Waiter)
+{
+	if (TryCompleteWaiter(Waiter, FPlatformTime::Seconds()))
+	{
+		return;
+	}
+
+	Waiters.Add(MoveTemp(Waiter));
+	ScheduleDeadlineTick();
+}
+
+void FPerceptionEndpoint::WakeWaiters()
+{
+	const double Now = FPlatformTime::Seconds();
+	const int32 Parked = Waiters.Num();
+
+	for (int32 i = 0; i < Waiters.Num(); )
+	{
+		if (Waiters[i].CaptureId == 0 && TryCompleteWaiter(Waiters[i], Now))
+		{
+			Waiters.RemoveAt(i);
 		}
+		else
+		{
+			++i;
+		}
+	}
+
+	if (Waiters.Num() != Parked)
+	{
+		ScheduleDeadlineTick();
+	}
+}
+
+void FPerceptionEndpoint::CompleteCapture(uint64 CaptureId, FPerceptionPacket&& Packet)
+{
+	const int32 Index = Waiters.IndexOfByPredicate([CaptureId](const FFrameWaiter& Waiter)
+	{
+		return Waiter.CaptureId == CaptureId;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return;  // Timed out or the endpoint stopped
+	}
+
+	if (Packet.bValid)
+	{
+		SendPacket(Waiters[Index].OnComplete, MoveTemp(Packet), Waiters[Index].bBinary);
+	}
+	else
+	{
+		SendJsonResponse(Waiters[Index].OnComplete, TEXT("{\"error\":\"Capture failed\"}"), 500);
+	}
+
+	Waiters.RemoveAt(Index);
+	ScheduleDeadlineTick();
+}
+
+bool FPerceptionEndpoint::TickWaiters(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
 
-		// Stop if we started it
-		if (!WasCapturing)
+	for (int32 i = 0; i < Waiters.Num(); )
+	{
+		if (TryCompleteWaiter(Waiters[i], Now))
+		{
+			Waiters.RemoveAt(i);
+		}
+		else
 		{
-			Subsystem->StopCapture();
+			++i;
 		}
+	}
 
-		if (!Packet.bValid)
+	// One-shot: rescheduled for the next deadline, if any
+	WaiterTickHandle.Reset();
+	ScheduleDeadlineTick();
+	return false;
+}
+
+void FPerceptionEndpoint::ScheduleDeadlineTick()
+{
+	double Earliest = TNumericLimits<double>::Max();
+	for (const FFrameWaiter& Waiter : Waiters)
+	{
+		Earliest = FMath::Min(Earliest, Waiter.Deadline);
+	}
+
+	if (WaiterTickHandle.IsValid())
+	{
+		if (Waiters.Num() > 0 && Earliest >= ScheduledDeadline)
 		{
-			SendJsonResponse(OnComplete, TEXT("{\"error\":\"Capture timed out\"}"), 408);
 			return;
 		}
+		FTSTicker::GetCoreTicker().RemoveTicker(WaiterTickHandle);
+		WaiterTickHandle.Reset();
+	}
 
-		// Build the same JSON response as HandleFrame
-		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
-		FString ImageBase64 = FBase64::Encode(Packet.ImageData.GetData(), Packet.ImageData.Num());
-		Root->SetStringField(TEXT("image"), ImageBase64);
-		Root->SetNumberField(TEXT("width"), Packet.Width);
-		Root->SetNumberField(TEXT("height"), Packet.Height);
-		Root->SetStringField(TEXT("format"),
-			Packet.Format == EPerceptionImageFormat::PNG ? TEXT("png") : TEXT("jpeg"));
-		Root->SetNumberField(TEXT("frame_number"), static_cast<double>(Packet.FrameNumber));
-		Root->SetNumberField(TEXT("timestamp"), Packet.Timestamp);
-
-		TSharedRef<FJsonObject> CameraObj = MakeShared<FJsonObject>();
-		TArray<TSharedPtr<FJsonValue>> LocArr;
-		LocArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Location.X));
-		LocArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Location.Y));
-		LocArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Location.Z));
-		CameraObj->SetArrayField(TEXT("location"), LocArr);
-		TArray<TSharedPtr<FJsonValue>> RotArr;
-		RotArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Rotation.Pitch));
-		RotArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Rotation.Yaw));
-		RotArr.Add(MakeShared<FJsonValueNumber>(Packet.Metadata.Camera.Rotation.Roll));
-		CameraObj->SetArrayField(TEXT("rotation"), RotArr);
-		CameraObj->SetNumberField(TEXT("fov"), Packet.Metadata.Camera.FOV);
-		Root->SetObjectField(TEXT("camera"), CameraObj);
-
-		TSharedRef<FJsonObject> SceneObj = MakeShared<FJsonObject>();
-		SceneObj->SetStringField(TEXT("map"), Packet.Metadata.MapName);
-		SceneObj->SetNumberField(TEXT("actor_count"), Packet.Metadata.ActorCount);
-		Root->SetObjectField(TEXT("scene"), SceneObj);
-
-		TArray<TSharedPtr<FJsonValue>> SelArr;
-		for (const FString& Name : Packet.Metadata.SelectedActors)
-		{
-			SelArr.Add(MakeShared<FJsonValueString>(Name));
-		}
-		Root->SetArrayField(TEXT("selection"), SelArr);
-
-		FString JsonBody;
-		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonBody);
-		FJsonSerializer::Serialize(Root, Writer);
-
-		SendJsonResponse(OnComplete, JsonBody);
-	});
+	if (Waiters.Num() == 0)
+	{
+		return;
+	}
+
+	ScheduledDeadline = Earliest;
+	const float Delay = static_cast<float>(FMath::Max(Earliest - FPlatformTime::Seconds(), 0.0));
+	WaiterTickHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FPerceptionEndpoint::TickWaiters), Delay);
+}
+
+bool FPerceptionEndpoint::TryCompleteWaiter(FFrameWaiter& Waiter, double Now)
+{
+	if (!Subsystem)
+	{
+		SendJsonResponse(Waiter.OnComplete, TEXT("{\"error\":\"Subsystem destroyed\"}"), 500);
+		return true;
+	}
+
+	if (Waiter.CaptureId == 0 && Subsystem->GetLatestPacketFrameNumber() > Waiter.AfterFrame)
+	{
+		// Cheap check first; only build the packet once one newer than the waiter's is published
+		FPerceptionPacket Packet = (Waiter.Level != INDEX_NONE) ? Subsystem->GetPyramidPacket(Waiter.Level)
+		                                                         : Subsystem->GetLatestPacket();
+		if (Packet.bValid && Packet.FrameNumber > Waiter.AfterFrame)
+		{
+			SendPacket(Waiter.OnComplete, MoveTemp(Packet), Waiter.bBinary);
+			return true;
+		}
+	}
+
+	if (Now >= Waiter.Deadline)
+	{
+		SendJsonResponse(Waiter.OnComplete, FString::Printf(
+			TEXT("{\"error\":\"Timed out waiting for a frame\",\"latest_frame\":%lld}"),
+			Subsystem->GetLatestPacketFrameNumber()), 408);
+		return true;
+	}
 
-	return true;  // We'll respond asynchronously
+	return false;
+}
+
+double FPerceptionEndpoint::GetTimeoutSeconds(const FHttpServerRequest& Request, int32 DefaultMs)
+{
+	const FString* Timeout = Request.QueryParams.Find(TEXT("timeout"));
+	const int32 TimeoutMs = Timeout ? FCString::Atoi(**Timeout) : DefaultMs;
+	return FMath::Clamp(TimeoutMs, 0, MaxLongPollTimeoutMs) / 1000.0;
+}
+
+void FPerceptionEndpoint::SendPacket(const FHttpResultCallback& OnComplete, FPerceptionPacket&& Packet, bool bBinary)
+{
+	if (bBinary)
+	{
+		SendPacketBinary(OnComplete, MoveTemp(Packet));
+		return;
+	}
+
+	SendJsonResponse(OnComplete, PacketToJson(Packet));
 }
 
 void FPerceptionEndpoint::SendJsonResponse(const FHttpResultCallback& OnComplete,
                                             const FString& JsonBody, int32 StatusCode)
 {
 	auto Response = FHttpServerResponse::Create(JsonBody, TEXT("application/json"));
+	Response->Code = static_cast<EHttpServerResponseCodes>(StatusCode);
 	OnComplete(MoveTemp(Response));
 }
+
+bool FPerceptionEndpoint::AcceptsBinary(const FHttpServerRequest& Request)
+{
+	const TArray<FString>* Accept = Request.Headers.Find(TEXT("Accept"));
+	if (!Accept)
+	{
+		return false;
+	}
+
+	for (const FString& Value : *Accept)
+	{
+		// Only explicit types: browsers list image/webp etc. but still expect the JSON route
+		if (Value.Contains(TEXT("image/jpeg")) || Value.Contains(TEXT("image/png")) ||
+		    Value.Contains(TEXT("application/octet-stream")))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FPerceptionEndpoint::SendPacketBinary(const FHttpResultCallback& OnComplete, FPerceptionPacket&& Packet)
+{
+	const bool bPNG = (Packet.Format == EPerceptionImageFormat::PNG);
+	auto Response = FHttpServerResponse::Create(MoveTemp(Packet.ImageData), bPNG ? TEXT("image/png") : TEXT("image/jpeg"));
+
+	// Scalars get their own headers so clients can skip JSON entirely; the rest
+	// of the metadata goes in one condensed JSON header (UTF-8)
+	Response->Headers.Add(TEXT("X-Perception-Frame"), TArray<FString>{ LexToString(Packet.FrameNumber) });
+	Response->Headers.Add(TEXT("X-Perception-Timestamp"), TArray<FString>{ FString::Printf(TEXT("%.6f"), Packet.Timestamp) });
+	Response->Headers.Add(TEXT("X-Perception-Width"), TArray<FString>{ LexToString(Packet.Width) });
+	Response->Headers.Add(TEXT("X-Perception-Height"), TArray<FString>{ LexToString(Packet.Height) });
+	Response->Headers.Add(TEXT("X-Perception-Format"), TArray<FString>{ FString(bPNG ? TEXT("png") : TEXT("jpeg")) });
+	if (!Packet.Region.IsEmpty())
+	{
+		Response->Headers.Add(TEXT("X-Perception-Roi"), TArray<FString>{ FString::Printf(TEXT("%d,%d,%d,%d"),
+			Packet.Region.Min.X, Packet.Region.Min.Y, Packet.Region.Width(), Packet.Region.Height()) });
+	}
+	Response->Headers.Add(TEXT("X-Perception-Hash"), TArray<FString>{ FString::Printf(TEXT("%016llx"), static_cast<uint64>(Packet.PerceptualHash)) });
+	Response->Headers.Add(TEXT("X-Perception-Scene-Change"), TArray<FString>{ FString::Printf(TEXT("%.4f"), Packet.SceneChange) });
+
+	// Selection names, histograms, motion vectors and tile bitmaps grow with the scene; past
+	// MaxJsonHeaderBytes only the scalars go in the header and the JSON routes have the rest
+	bool bMetadataTruncated = false;
+	const FString MetadataJson = MetadataToHeaderJson(Packet.Metadata, bMetadataTruncated);
+	if (bMetadataTruncated)
+	{
+		Response->Headers.Add(TEXT("X-Perception-Metadata-Truncated"), TArray<FString>{ FString(TEXT("1")) });
+	}
+	Response->Headers.Add(TEXT("X-Perception-Metadata"), TArray<FString>{ MetadataJson });
+
+	if (Packet.Changes.TileSize > 0)
+	{
+		Response->Headers.Add(TEXT("X-Perception-Unchanged"), TArray<FString>{ FString(Packet.Changes.bUnchanged ? TEXT("1") : TEXT("0")) });
+
+		auto ChangesToJson = [&Packet](bool bScalarsOnly)
+		{
+			FString ChangesJson;
+			TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+				TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ChangesJson);
+			Writer->WriteObjectStart();
+			WriteChangesFields(*Writer, Packet.Changes, bScalarsOnly);
+			Writer->WriteObjectEnd();
+			Writer->Close();
+			return ChangesJson;
+		};
+
+		FString ChangesJson = ChangesToJson(false);
+		if (FTCHARToUTF8(*ChangesJson).Length() > MaxJsonHeaderBytes)
+		{
+			ChangesJson = ChangesToJson(true);
+			Response->Headers.Add(TEXT("X-Perception-Changes-Truncated"), TArray<FString>{ FString(TEXT("1")) });
+		}
+		Response->Headers.Add(TEXT("X-Perception-Changes"), TArray<FString>{ ChangesJson });
+	}
+
+	OnComplete(MoveTemp(Response));
+}
+
+FString FPerceptionEndpoint::MetadataToJson(const FPerceptionMetadata& Metadata, bool bScalarsOnly)
+{
+	FString MetadataJson;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&MetadataJson);
+	Writer->WriteObjectStart();
+	WriteMetadataFields(*Writer, Metadata, bScalarsOnly);
+	Writer->WriteObjectEnd();
+	Writer->Close();
+	return MetadataJson;
+}
+
+FString FPerceptionEndpoint::MetadataToHeaderJson(const FPerceptionMetadata& Metadata, bool& bOutTruncated)
+{
+	FString MetadataJson = MetadataToJson(Metadata);
+	bOutTruncated = FTCHARToUTF8(*MetadataJson).Length() > MaxJsonHeaderBytes;
+	if (bOutTruncated)
+	{
+		MetadataJson = MetadataToJson(Metadata, true);
+	}
+	return MetadataJson;
+}
+
+FString FPerceptionEndpoint::PacketToJson(const FPerceptionPacket& Packet)
+{
+	// Streamed straight into the string, no FJsonObject tree per response
+	FString JsonBody;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonBody);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("image"), FBase64::Encode(Packet.ImageData.GetData(), Packet.ImageData.Num()));
+	Writer->WriteValue(TEXT("width"), Packet.Width);
+	Writer->WriteValue(TEXT("height"), Packet.Height);
+	if (!Packet.Region.IsEmpty())
+	{
+		// [x, y, width, height] of the captured frame the image was cut from
+		Writer->WriteArrayStart(TEXT("roi"));
+		Writer->WriteValue(Packet.Region.Min.X);
+		Writer->WriteValue(Packet.Region.Min.Y);
+		Writer->WriteValue(Packet.Region.Width());
+		Writer->WriteValue(Packet.Region.Height());
+		Writer->WriteArrayEnd();
+	}
+	Writer->WriteValue(TEXT("format"), FString(Packet.Format == EPerceptionImageFormat::PNG ? TEXT("png") : TEXT("jpeg")));
+	Writer->WriteValue(TEXT("frame_number"), Packet.FrameNumber);
+	Writer->WriteValue(TEXT("timestamp"), Packet.Timestamp);
+	// Hex: a 64-bit value doesn't survive JSON numbers
+	Writer->WriteValue(TEXT("perceptual_hash"), FString::Printf(TEXT("%016llx"), static_cast<uint64>(Packet.PerceptualHash)));
+	Writer->WriteValue(TEXT("scene_change"), Packet.SceneChange);
+	WriteMetadataFields(*Writer, Packet.Metadata);
+	if (Packet.Changes.TileSize > 0)
+	{
+		Writer->WriteObjectStart(TEXT("changes"));
+		WriteChangesFields(*Writer, Packet.Changes);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return JsonBody;
+}
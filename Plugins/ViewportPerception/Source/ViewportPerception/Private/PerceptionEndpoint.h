@@ -2,11 +2,35 @@
 // Lightweight HTTP server serving perception packets on port 30011.
 // Routes:
 //   GET  /perception/frame   -> latest perception packet (JSON + base64 image)
-//   GET  /perception/status  -> capture state, fps, buffer stats
-//   PUT  /perception/config  -> set resolution, format, rate
+//                               ?after=N&timeout=ms long-polls for the first frame newer than N
+//                               ?at=T (platform seconds, negative: seconds ago) or ?frame=N
+//                               answers from history with what was on screen then
+//                               ?level=N or ?width=W picks a pyramid level of the latest
+//                               frame (0 = the frame at its own size, each level half the last)
+//                               ?roi=x,y,w,h (capture pixels) or ?roi=selection crops the
+//                               captured frame before resizing; &width= sets the output width
+//   GET  /perception/frame.bin -> latest encoded image as the raw body, metadata in
+//                               X-Perception-* headers (also served by /frame and
+//                               /single to clients sending Accept: image/*)
+//   GET  /perception/changes -> changed-tile bitmap and regions of the latest frame
+//                               (?since=N: everything changed after frame N)
+//   GET  /perception/history -> frames held in the history ring (number, timestamp, size);
+//                               409 while replaying, as the ring holds live frames
+//   GET  /perception/stream  -> redirect to the multipart stream on port 30012
+//                               (PerceptionStream.h) on 127.0.0.1, fps and metadata passed through
+//   GET  /perception/status  -> capture state, fps, buffer stats, motion search kernel
+//   PUT  /perception/config  -> set resolution, format, rate, buffer pool, shared-memory export,
+//                               min_scene_change publish threshold, image_stats, motion,
+//                               history_seconds / history_budget_mb, pyramid_levels / thumbnail_width
 //   PUT  /perception/start   -> begin capturing
 //   PUT  /perception/stop    -> stop capturing
-//   PUT  /perception/single  -> one-shot capture
+//   PUT  /perception/single  -> one-shot capture (?timeout=ms)
+//   PUT  /perception/record  -> start/stop recording published packets to disk
+//                               ({"enable", "name", "segment_mb"}, under Saved/Perception/Recordings)
+//   PUT  /perception/replay  -> serve a recording through these routes instead of the live
+//                               viewport ({"enable", "name", "speed"})
+// Waiting requests are parked and answered on the game thread when the encoder publishes
+// or their capture lands; a ticker only fires at their deadlines. Nothing sleeps.
 
 #pragma once
 
@@ -14,6 +38,8 @@
 #include "HttpServerModule.h"
 #include "IHttpRouter.h"
 #include "HttpRouteHandle.h"
+#include "Containers/Ticker.h"
+#include "PerceptionTypes.h"
 
 class UViewportPerceptionSubsystem;
 
@@ -29,21 +55,107 @@ public:
 	/** Stop the HTTP server. */
 	void Stop();
 
+	/** Condensed JSON of the metadata, as sent in X-Perception-Metadata headers. bScalarsOnly
+	 *  leaves out the arrays that grow with the scene (selection names, luma histogram, motion
+	 *  vectors) and reports the selection as a count. */
+	static FString MetadataToJson(const FPerceptionMetadata& Metadata, bool bScalarsOnly = false);
+
+	/** Longest JSON value put in one header. Proxies commonly refuse responses whose headers
+	 *  pass 4-8 KB in all, so longer ones are cut down to their scalar fields. */
+	static constexpr int32 MaxJsonHeaderBytes = 2048;
+
+	/** Metadata JSON for an X-Perception-Metadata header: the full object if it fits in
+	 *  MaxJsonHeaderBytes, else the scalars only, with bOutTruncated set. */
+	static FString MetadataToHeaderJson(const FPerceptionMetadata& Metadata, bool& bOutTruncated);
+
+	/** Answer the parked long polls a newer packet is now out for. Game thread; the subsystem
+	 *  calls it after each encoder publish and as a replay's playhead moves. */
+	void WakeWaiters();
+
 private:
 	// Route handlers
 	bool HandleFrame(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleFrameBinary(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleChanges(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleHistory(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleStream(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 	bool HandleStatus(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 	bool HandleConfig(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 	bool HandleStart(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 	bool HandleStop(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 	bool HandleSingle(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleRecord(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleReplay(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+
+	/** Shared by /frame and /frame.bin: latest packet, or park a long poll. */
+	bool ServeFrame(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete, bool bBinary);
+
+	/** A request waiting for a frame newer than AfterFrame, or for its deadline. */
+	struct FFrameWaiter
+	{
+		FHttpResultCallback OnComplete;
+		int64 AfterFrame = 0;
+		double Deadline = 0.0;
+
+		/** Pyramid level to answer with; INDEX_NONE for the capture settings */
+		int32 Level = INDEX_NONE;
+		bool bBinary = false;
+
+		/** Nonzero for /single: answered by CompleteCapture with that capture instead of the latest frame */
+		uint64 CaptureId = 0;
+	};
+
+	/** Answer the waiter now if it can be, otherwise park it until a publish or its deadline. */
+	void ParkWaiter(FFrameWaiter&& Waiter);
+
+	/** Answer the /single waiter for CaptureId with its capture, if it is still parked. */
+	void CompleteCapture(uint64 CaptureId, FPerceptionPacket&& Packet);
+
+	/** Game-thread ticker, due at the earliest parked deadline. */
+	bool TickWaiters(float DeltaTime);
 
-	/** Build a JSON response and send it. */
+	/** Point the ticker at the earliest parked deadline, or remove it once none are parked. */
+	void ScheduleDeadlineTick();
+
+	/** Respond with a newer frame or a timeout. Returns false if the waiter keeps waiting. */
+	bool TryCompleteWaiter(FFrameWaiter& Waiter, double Now);
+
+	/** ?timeout=ms in seconds, clamped to MaxLongPollTimeoutMs. */
+	static double GetTimeoutSeconds(const FHttpServerRequest& Request, int32 DefaultMs);
+
+	void SendPacket(const FHttpResultCallback& OnComplete, FPerceptionPacket&& Packet, bool bBinary);
+
+	/** Send a JSON body with StatusCode; errors carry their HTTP status so binary clients can tell them from images. */
 	void SendJsonResponse(const FHttpResultCallback& OnComplete, const FString& JsonBody, int32 StatusCode = 200);
 
+	/** Send the encoded image as the body, with frame info and metadata in response headers.
+	 *  JSON headers longer than MaxJsonHeaderBytes carry their scalar fields only, flagged by
+	 *  X-Perception-Metadata-Truncated / X-Perception-Changes-Truncated. */
+	static void SendPacketBinary(const FHttpResultCallback& OnComplete, FPerceptionPacket&& Packet);
+
+	/** Serialize a packet for the JSON routes (base64 image). */
+	static FString PacketToJson(const FPerceptionPacket& Packet);
+
+	/** True if the request's Accept header asks for an image or raw bytes rather than JSON. */
+	static bool AcceptsBinary(const FHttpServerRequest& Request);
+
 	UViewportPerceptionSubsystem* Subsystem = nullptr;
 
 	TArray<FHttpRouteHandle> RouteHandles;
+
+	// Game thread only
+	TArray<FFrameWaiter> Waiters;
+	FTSTicker::FDelegateHandle WaiterTickHandle;
+	double ScheduledDeadline = 0.0;
+	uint64 NextCaptureId = 1;
+
+	/** Captures outlive the endpoint; their continuations hold this weakly */
+	TSharedRef<bool, ESPMode::ThreadSafe> LifetimeToken = MakeShared<bool, ESPMode::ThreadSafe>(true);
+
+	static constexpr int32 DefaultLongPollTimeoutMs = 5000;
+	static constexpr int32 DefaultSingleTimeoutMs = 1000;
+	static constexpr int32 MaxLongPollTimeoutMs = 30000;
+
 	static constexpr int32 PERCEPTION_PORT = 30011;
 	bool bRunning = false;
 };
@@ -0,0 +1,203 @@
+// PerceptionFrame.cpp
+
+#include "PerceptionFrame.h"
+
+// --- FPerceptionFrameRef ---
+
+FPerceptionFrameRef::FPerceptionFrameRef(FPerceptionFrame* InFrame)
+	: Frame(InFrame)
+{
+	if (Frame)
+	{
+		Frame->RefCount.IncrementExchange();
+	}
+}
+
+FPerceptionFrameRef::FPerceptionFrameRef(const FPerceptionFrameRef& Other)
+	: FPerceptionFrameRef(Other.Frame)
+{
+}
+
+FPerceptionFrameRef::FPerceptionFrameRef(FPerceptionFrameRef&& Other)
+	: Frame(Other.Frame)
+{
+	Other.Frame = nullptr;
+}
+
+FPerceptionFrameRef& FPerceptionFrameRef::operator=(const FPerceptionFrameRef& Other)
+{
+	if (Frame != Other.Frame)
+	{
+		FPerceptionFrameRef Copy(Other);
+		Swap(Frame, Copy.Frame);
+	}
+	return *this;
+}
+
+FPerceptionFrameRef& FPerceptionFrameRef::operator=(FPerceptionFrameRef&& Other)
+{
+	if (this != &Other)
+	{
+		Reset();
+		Frame = Other.Frame;
+		Other.Frame = nullptr;
+	}
+	return *this;
+}
+
+FPerceptionFrameRef::~FPerceptionFrameRef()
+{
+	Reset();
+}
+
+FPerceptionFrame& FPerceptionFrameRef::Edit()
+{
+	check(Frame && Frame->RefCount.Load() == 1);
+	return *Frame;
+}
+
+void FPerceptionFrameRef::Reset()
+{
+	FPerceptionFrame* Released = Frame;
+	Frame = nullptr;
+
+	if (Released && Released->RefCount.DecrementExchange() == 1)
+	{
+		if (TSharedPtr<FPerceptionFramePool, ESPMode::ThreadSafe> Pool = Released->Pool.Pin())
+		{
+			Pool->Recycle(Released);
+		}
+		else
+		{
+			delete Released;  // Pool already gone
+		}
+	}
+}
+
+// --- FPerceptionFramePool ---
+
+TSharedRef<FPerceptionFramePool, ESPMode::ThreadSafe> FPerceptionFramePool::Create(int32 MaxFrames, int64 BudgetBytes)
+{
+	return MakeShareable(new FPerceptionFramePool(MaxFrames, BudgetBytes));
+}
+
+FPerceptionFramePool::FPerceptionFramePool(int32 InMaxFrames, int64 InBudgetBytes)
+	: MaxFrames(FMath::Max(InMaxFrames, 1))
+	, BudgetBytes(FMath::Max<int64>(InBudgetBytes, 0))
+{
+}
+
+FPerceptionFramePool::~FPerceptionFramePool()
+{
+	// Frames still held by handles delete themselves once their pool can't be pinned
+	for (FPerceptionFrame* Frame : FreeFrames)
+	{
+		delete Frame;
+	}
+	FreeFrames.Reset();
+}
+
+FPerceptionFrameRef FPerceptionFramePool::Acquire(FIntPoint Size)
+{
+	const int32 NumPixels = FMath::Max(Size.X, 0) * FMath::Max(Size.Y, 0);
+	const int64 NeededBytes = static_cast<int64>(NumPixels) * sizeof(FColor);
+
+	FPerceptionFrame* Frame = nullptr;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		// Prefer a free buffer that already has the capacity; otherwise grow the largest one
+		int32 BestIndex = INDEX_NONE;
+		for (int32 i = 0; i < FreeFrames.Num(); ++i)
+		{
+			if (BestIndex == INDEX_NONE || FreeFrames[i]->Pixels.Max() > FreeFrames[BestIndex]->Pixels.Max())
+			{
+				BestIndex = i;
+			}
+			if (FreeFrames[i]->Pixels.Max() >= NumPixels)
+			{
+				BestIndex = i;
+				break;
+			}
+		}
+
+		if (BestIndex != INDEX_NONE)
+		{
+			FPerceptionFrame* Candidate = FreeFrames[BestIndex];
+			const int64 GrowBytes = FMath::Max<int64>(NeededBytes - Candidate->AccountedBytes, 0);
+			if (GrowBytes == 0 || AllocatedBytes + GrowBytes <= BudgetBytes)
+			{
+				FreeFrames.RemoveAtSwap(BestIndex);
+				Frame = Candidate;
+			}
+		}
+		else if (NumFrames < MaxFrames && AllocatedBytes + NeededBytes <= BudgetBytes)
+		{
+			Frame = new FPerceptionFrame();
+			Frame->Pool = AsShared();
+			++NumFrames;
+		}
+
+		if (!Frame)
+		{
+			++ExhaustedCount;
+			return FPerceptionFrameRef();
+		}
+
+		// Reserve the budget before allocating outside the lock
+		AllocatedBytes += FMath::Max<int64>(NeededBytes - Frame->AccountedBytes, 0);
+		Frame->AccountedBytes = FMath::Max(Frame->AccountedBytes, NeededBytes);
+	}
+
+	Frame->Pixels.SetNumUninitialized(NumPixels, EAllowShrinking::No);
+	Frame->Size = Size;
+	Frame->FrameNumber = 0;
+	Frame->Timestamp = 0.0;
+	return FPerceptionFrameRef(Frame);
+}
+
+void FPerceptionFramePool::Recycle(FPerceptionFrame* Frame)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Writers (e.g. an RHI readback) may have reallocated the array
+	const int64 ActualBytes = Frame->Pixels.GetAllocatedSize();
+	AllocatedBytes += ActualBytes - Frame->AccountedBytes;
+	Frame->AccountedBytes = ActualBytes;
+
+	FreeFrames.Add(Frame);
+	TrimLocked();
+}
+
+void FPerceptionFramePool::SetLimits(int32 InMaxFrames, int64 InBudgetBytes)
+{
+	FScopeLock ScopeLock(&Lock);
+	MaxFrames = FMath::Max(InMaxFrames, 1);
+	BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+	TrimLocked();
+}
+
+void FPerceptionFramePool::TrimLocked()
+{
+	while (FreeFrames.Num() > 0 && (NumFrames > MaxFrames || AllocatedBytes > BudgetBytes))
+	{
+		FPerceptionFrame* Frame = FreeFrames.Pop(EAllowShrinking::No);
+		AllocatedBytes -= Frame->AccountedBytes;
+		--NumFrames;
+		delete Frame;
+	}
+}
+
+FPerceptionFramePoolStats FPerceptionFramePool::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FPerceptionFramePoolStats Stats;
+	Stats.Frames = NumFrames;
+	Stats.FreeFrames = FreeFrames.Num();
+	Stats.AllocatedBytes = AllocatedBytes;
+	Stats.MaxFrames = MaxFrames;
+	Stats.BudgetBytes = BudgetBytes;
+	Stats.Exhausted = ExhaustedCount;
+	return Stats;
+}
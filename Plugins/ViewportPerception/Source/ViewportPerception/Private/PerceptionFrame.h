@@ -0,0 +1,121 @@
+// PerceptionFrame.h
+// Pooled, reference-counted frame buffers shared between the producer, the
+// PixelBus and its readers.
+// The producer fills a frame it holds exclusively, then publishes it to the
+// bus; from then on the frame is immutable and readers share it by handle
+// instead of copying pixels. When the last handle is released the buffer goes
+// back to its pool with its allocation intact, so steady-state capture reuses
+// the same few buffers.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FPerceptionFramePool;
+
+/** One captured frame. Readers only ever see it through a const handle. */
+class FPerceptionFrame
+{
+public:
+	TArray<FColor> Pixels;
+	FIntPoint Size = FIntPoint::ZeroValue;
+	int64 FrameNumber = 0;
+	double Timestamp = 0.0;
+
+private:
+	friend class FPerceptionFrameRef;
+	friend class FPerceptionFramePool;
+
+	TAtomic<int32> RefCount { 0 };
+
+	/** Bytes this frame was last accounted for in its pool */
+	int64 AccountedBytes = 0;
+
+	TWeakPtr<FPerceptionFramePool, ESPMode::ThreadSafe> Pool;
+};
+
+/** Ref-counted handle to a pooled frame. Copies share the frame; nothing is deep-copied. */
+class FPerceptionFrameRef
+{
+public:
+	FPerceptionFrameRef() = default;
+	FPerceptionFrameRef(const FPerceptionFrameRef& Other);
+	FPerceptionFrameRef(FPerceptionFrameRef&& Other);
+	FPerceptionFrameRef& operator=(const FPerceptionFrameRef& Other);
+	FPerceptionFrameRef& operator=(FPerceptionFrameRef&& Other);
+	~FPerceptionFrameRef();
+
+	bool IsValid() const { return Frame != nullptr; }
+	explicit operator bool() const { return IsValid(); }
+
+	const FPerceptionFrame* operator->() const { return Frame; }
+	const FPerceptionFrame& operator*() const { return *Frame; }
+
+	/** Write access for the producer while it holds the only handle, before publishing. */
+	FPerceptionFrame& Edit();
+
+	void Reset();
+
+private:
+	friend class FPerceptionFramePool;
+
+	explicit FPerceptionFrameRef(FPerceptionFrame* InFrame);
+
+	FPerceptionFrame* Frame = nullptr;
+};
+
+/** Pool usage snapshot */
+struct FPerceptionFramePoolStats
+{
+	/** Buffers currently allocated, in use or free */
+	int32 Frames = 0;
+	int32 FreeFrames = 0;
+	int64 AllocatedBytes = 0;
+
+	int32 MaxFrames = 0;
+	int64 BudgetBytes = 0;
+
+	/** Acquire calls refused because the pool was at its frame or memory limit */
+	int64 Exhausted = 0;
+};
+
+class FPerceptionFramePool : public TSharedFromThis<FPerceptionFramePool, ESPMode::ThreadSafe>
+{
+public:
+	static constexpr int32 DefaultMaxFrames = 6;
+	static constexpr int64 DefaultBudgetBytes = 256ll * 1024 * 1024;
+
+	static TSharedRef<FPerceptionFramePool, ESPMode::ThreadSafe> Create(
+		int32 MaxFrames = DefaultMaxFrames, int64 BudgetBytes = DefaultBudgetBytes);
+
+	~FPerceptionFramePool();
+
+	/** Hand out an exclusively held frame with room for Size pixels (Pixels.Num() is set).
+	 *  Returns an invalid handle if the frame count or memory budget would be exceeded. */
+	FPerceptionFrameRef Acquire(FIntPoint Size);
+
+	/** Change the limits. Free buffers over the new limits are released right away;
+	 *  buffers in use are released when their last handle goes away. */
+	void SetLimits(int32 MaxFrames, int64 BudgetBytes);
+
+	FPerceptionFramePoolStats GetStats() const;
+
+private:
+	friend class FPerceptionFrameRef;
+
+	FPerceptionFramePool(int32 InMaxFrames, int64 InBudgetBytes);
+
+	/** Called when the last handle to Frame is released. */
+	void Recycle(FPerceptionFrame* Frame);
+
+	/** Delete free frames until the pool is within its limits. Lock must be held. */
+	void TrimLocked();
+
+	mutable FCriticalSection Lock;
+	TArray<FPerceptionFrame*> FreeFrames;
+	int32 NumFrames = 0;
+	int64 AllocatedBytes = 0;
+	int32 MaxFrames;
+	int64 BudgetBytes;
+	int64 ExhaustedCount = 0;
+};
@@ -0,0 +1,248 @@
+// PerceptionHistory.cpp
+
+#include "PerceptionHistory.h"
+
+namespace
+{
+	/** Bytes an entry holds besides its image. */
+	int64 GetPacketOverhead(const FPerceptionPacket& Packet)
+	{
+		return sizeof(FPerceptionPacket)
+			+ Packet.Changes.Bitmap.GetAllocatedSize()
+			+ Packet.Changes.Regions.GetAllocatedSize()
+			+ Packet.Metadata.Motion.Vectors.GetAllocatedSize();
+	}
+}
+
+void FPerceptionHistory::Configure(int64 InBudgetBytes, double InMaxAgeSeconds)
+{
+	FScopeLock ScopeLock(&Lock);
+	BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+	MaxAgeSeconds = FMath::Max(InMaxAgeSeconds, 0.0);
+	EvictToLimits();
+}
+
+bool FPerceptionHistory::IsEnabled() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return BudgetBytes > 0 && MaxAgeSeconds > 0.0;
+}
+
+void FPerceptionHistory::Add(const FPerceptionPacket& Packet, int64 SharedImageFrame)
+{
+	if (!Packet.bValid)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	if (BudgetBytes <= 0 || MaxAgeSeconds <= 0.0)
+	{
+		return;
+	}
+
+	if (Entries.Num() > 0)
+	{
+		const int64 Newest = Entries.Last().Packet.FrameNumber;
+		if (Packet.FrameNumber < Newest)
+		{
+			return;
+		}
+
+		// Same frame re-encoded after a settings change: the new encode replaces it
+		if (Packet.FrameNumber == Newest)
+		{
+			Bytes -= Entries.Last().Bytes;
+			Entries.Pop();
+		}
+	}
+
+	FEntry Entry;
+	Entry.Packet = Packet;
+	Entry.Bytes = GetPacketOverhead(Packet);
+
+	if (SharedImageFrame > 0 && Entries.Num() > 0 && Entries.Last().Packet.FrameNumber == SharedImageFrame)
+	{
+		Entry.Image = Entries.Last().Image;
+		Entry.Packet.ImageData.Empty();
+	}
+	else
+	{
+		Entry.Bytes += Entry.Packet.ImageData.Num();
+		Entry.Image = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Entry.Packet.ImageData));
+	}
+
+	if (PendingMetadataFrame == Packet.FrameNumber)
+	{
+		FPerceptionMetadata Metadata = MoveTemp(PendingMetadata);
+		Metadata.CopyEncodeResults(Entry.Packet.Metadata);
+		Entry.Packet.Metadata = MoveTemp(Metadata);
+		PendingMetadataFrame = 0;
+	}
+
+	Bytes += Entry.Bytes;
+	Entries.Add(MoveTemp(Entry));
+
+	EvictToLimits();
+}
+
+void FPerceptionHistory::AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (Entries.Num() == 0 || FrameNumber > Entries.Last().Packet.FrameNumber)
+	{
+		PendingMetadata = Metadata;
+		PendingMetadataFrame = FrameNumber;
+		return;
+	}
+
+	// Metadata follows the frame closely, so it is nearly always for the newest entry
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		FPerceptionPacket& Packet = Entries[i].Packet;
+		if (Packet.FrameNumber == FrameNumber)
+		{
+			FPerceptionMetadata Patched = Metadata;
+			Patched.CopyEncodeResults(Packet.Metadata);
+			Packet.Metadata = MoveTemp(Patched);
+			return;
+		}
+		if (Packet.FrameNumber < FrameNumber)
+		{
+			return;
+		}
+	}
+}
+
+template <typename ProjectionType, typename KeyType>
+int32 FPerceptionHistory::FindAtOrBefore(KeyType Key, ProjectionType Projection) const
+{
+	if (Entries.Num() == 0 || Key < Projection(Entries.First().Packet))
+	{
+		return INDEX_NONE;
+	}
+
+	// Entries are in frame and capture order, so both keys are sorted
+	int32 Low = 0;
+	int32 High = Entries.Num() - 1;
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low + 1) / 2;
+		if (Projection(Entries[Mid].Packet) <= Key)
+		{
+			Low = Mid;
+		}
+		else
+		{
+			High = Mid - 1;
+		}
+	}
+	return Low;
+}
+
+bool FPerceptionHistory::FindByFrame(int64 FrameNumber, FPerceptionPacket& OutPacket) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const int32 Index = FindAtOrBefore(FrameNumber, [](const FPerceptionPacket& Packet) { return Packet.FrameNumber; });
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	CopyOut(Entries[Index], OutPacket);
+	return true;
+}
+
+bool FPerceptionHistory::FindByTime(double Timestamp, FPerceptionPacket& OutPacket) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const int32 Index = FindAtOrBefore(Timestamp, [](const FPerceptionPacket& Packet) { return Packet.Timestamp; });
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	CopyOut(Entries[Index], OutPacket);
+	return true;
+}
+
+void FPerceptionHistory::GetEntries(TArray<FPerceptionHistoryEntryInfo>& OutEntries) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	OutEntries.Reset(Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FEntry& Entry = Entries[i];
+		FPerceptionHistoryEntryInfo& Info = OutEntries.AddDefaulted_GetRef();
+		Info.FrameNumber = Entry.Packet.FrameNumber;
+		Info.Timestamp = Entry.Packet.Timestamp;
+		Info.Width = Entry.Packet.Width;
+		Info.Height = Entry.Packet.Height;
+		Info.Format = Entry.Packet.Format;
+		Info.ImageBytes = Entry.Image.IsValid() ? Entry.Image->Num() : 0;
+		Info.SceneChange = Entry.Packet.SceneChange;
+		Info.bSharedImage = (i > 0 && Entries[i - 1].Image == Entry.Image);
+	}
+}
+
+FPerceptionHistoryStats FPerceptionHistory::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FPerceptionHistoryStats Stats;
+	Stats.Frames = Entries.Num();
+	Stats.Bytes = Bytes;
+	Stats.BudgetBytes = BudgetBytes;
+	Stats.MaxAgeSeconds = MaxAgeSeconds;
+	Stats.Evicted = Evicted;
+	if (Entries.Num() > 0)
+	{
+		Stats.OldestFrame = Entries.First().Packet.FrameNumber;
+		Stats.NewestFrame = Entries.Last().Packet.FrameNumber;
+		Stats.OldestTimestamp = Entries.First().Packet.Timestamp;
+		Stats.NewestTimestamp = Entries.Last().Packet.Timestamp;
+	}
+	return Stats;
+}
+
+void FPerceptionHistory::EvictToLimits()
+{
+	// Age is measured against the newest entry, so history outlives a capture stop
+	while (Entries.Num() > 0
+		&& (Bytes > BudgetBytes || MaxAgeSeconds <= 0.0
+			|| Entries.Last().Packet.Timestamp - Entries.First().Packet.Timestamp > MaxAgeSeconds))
+	{
+		PopOldest();
+		++Evicted;
+	}
+}
+
+void FPerceptionHistory::PopOldest()
+{
+	const FEntry& Oldest = Entries.First();
+	if (Entries.Num() > 1 && Entries[1].Image == Oldest.Image)
+	{
+		// The image stays alive in the next entry, and so does its charge
+		Entries[1].Bytes += Oldest.Image->Num();
+		Bytes -= Oldest.Bytes - Oldest.Image->Num();
+	}
+	else
+	{
+		Bytes -= Oldest.Bytes;
+	}
+	Entries.PopFront();
+}
+
+void FPerceptionHistory::CopyOut(const FEntry& Entry, FPerceptionPacket& OutPacket) const
+{
+	OutPacket = Entry.Packet;
+	if (Entry.Image.IsValid())
+	{
+		OutPacket.ImageData = *Entry.Image;
+	}
+}
@@ -0,0 +1,119 @@
+// PerceptionHistory.h
+// Ring of recently published packets, for looking back at what the viewport showed.
+//
+// The encoder adds every packet it publishes, already compressed. Entries are
+// evicted oldest first once they span more than MaxAgeSeconds or hold more than
+// the memory budget. Packets that reused the previous image (no tile changed)
+// share its bytes instead of holding a copy. Lookups by frame number or capture
+// timestamp return the newest entry at or before the one asked for: frames the
+// encoder dropped or held back were showing the same picture as that entry.
+//
+// Metadata is attached on the game tick, usually after the frame was encoded, so
+// it is forwarded here by frame number and patched into the entry.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
+#include "PerceptionTypes.h"
+
+/** Occupancy and limits of the history ring. */
+struct FPerceptionHistoryStats
+{
+	int32 Frames = 0;
+	int64 Bytes = 0;
+
+	int64 BudgetBytes = 0;
+	double MaxAgeSeconds = 0.0;
+
+	int64 OldestFrame = 0;
+	int64 NewestFrame = 0;
+	double OldestTimestamp = 0.0;
+	double NewestTimestamp = 0.0;
+
+	/** Entries dropped to stay within the limits */
+	int64 Evicted = 0;
+};
+
+/** One history entry without its image, for listings. */
+struct FPerceptionHistoryEntryInfo
+{
+	int64 FrameNumber = 0;
+	double Timestamp = 0.0;
+	int32 Width = 0;
+	int32 Height = 0;
+	EPerceptionImageFormat Format = EPerceptionImageFormat::JPEG;
+	int32 ImageBytes = 0;
+	float SceneChange = 0.0f;
+
+	/** The image is the previous entry's (no tile changed) */
+	bool bSharedImage = false;
+};
+
+class FPerceptionHistory
+{
+public:
+	static constexpr int64 DefaultBudgetBytes = 64ll * 1024 * 1024;
+	static constexpr double DefaultMaxAgeSeconds = 10.0;
+
+	/** Set the limits, evicting to meet them. A budget or age of 0 turns history off and empties it. */
+	void Configure(int64 BudgetBytes, double MaxAgeSeconds);
+
+	bool IsEnabled() const;
+
+	/** Add a published packet. SharedImageFrame is the frame whose image Packet reused
+	 *  unchanged, or 0; if that is the newest entry, its bytes are shared. Thread-safe. */
+	void Add(const FPerceptionPacket& Packet, int64 SharedImageFrame = 0);
+
+	/** Give frame FrameNumber the metadata collected for it, keeping the encode-stage fields. */
+	void AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber);
+
+	/** Packet on screen at frame FrameNumber. False if history doesn't reach back that far. */
+	bool FindByFrame(int64 FrameNumber, FPerceptionPacket& OutPacket) const;
+
+	/** Packet on screen at platform time Timestamp (as in FPerceptionPacket::Timestamp).
+	 *  False if history doesn't reach back that far. */
+	bool FindByTime(double Timestamp, FPerceptionPacket& OutPacket) const;
+
+	/** Every entry, oldest first. */
+	void GetEntries(TArray<FPerceptionHistoryEntryInfo>& OutEntries) const;
+
+	FPerceptionHistoryStats GetStats() const;
+
+private:
+	struct FEntry
+	{
+		/** Everything but the image */
+		FPerceptionPacket Packet;
+		TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Image;
+
+		/** Bytes this entry is charged for; a shared image is charged to its oldest holder */
+		int64 Bytes = 0;
+	};
+
+	/** Index of the newest entry at or before Key, by Projection, or INDEX_NONE. Lock must be held. */
+	template <typename ProjectionType, typename KeyType>
+	int32 FindAtOrBefore(KeyType Key, ProjectionType Projection) const;
+
+	/** Drop oldest entries until the limits hold. Lock must be held. */
+	void EvictToLimits();
+
+	/** Drop the oldest entry, handing its image charge on if the next one shares it. Lock must be held. */
+	void PopOldest();
+
+	void CopyOut(const FEntry& Entry, FPerceptionPacket& OutPacket) const;
+
+	mutable FCriticalSection Lock;
+
+	/** Oldest first */
+	TRingBuffer<FEntry> Entries;
+
+	int64 Bytes = 0;
+	int64 BudgetBytes = DefaultBudgetBytes;
+	double MaxAgeSeconds = DefaultMaxAgeSeconds;
+	int64 Evicted = 0;
+
+	/** Metadata that arrived before its frame was added */
+	FPerceptionMetadata PendingMetadata;
+	int64 PendingMetadataFrame = 0;
+};
@@ -0,0 +1,365 @@
+// PerceptionMotion.cpp
+
+#include "PerceptionMotion.h"
+#include "PerceptionAdapter.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	#define PERCEPTION_MOTION_NEON 1
+	#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#define PERCEPTION_MOTION_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#ifndef PERCEPTION_MOTION_NEON
+	#define PERCEPTION_MOTION_NEON 0
+#endif
+#ifndef PERCEPTION_MOTION_SSE2
+	#define PERCEPTION_MOTION_SSE2 0
+#endif
+
+namespace PerceptionMotion
+{
+	constexpr int32 BlockArea = FPerceptionMotionEstimator::BlockSize * FPerceptionMotionEstimator::BlockSize;
+
+	/** Below this, summed neighbour differences (both axes) mark a block as flat: nothing to match on. */
+	constexpr uint32 MinTexture = BlockArea * 4;
+
+	/** A best match worse than this (average error per pixel 10) means the content is new. */
+	constexpr uint32 MaxMatchError = BlockArea * 10;
+
+	/** Zero motion wins unless a candidate beats it by this much, so noise doesn't read as motion. */
+	constexpr uint32 ZeroBias = BlockArea / 2;
+
+	/** Plane pixels a block may be off the global model and still follow it. */
+	constexpr double InlierDistance = 1.5;
+
+	/** Global motion below this many plane pixels counts as none. */
+	constexpr double MinGlobalMotion = 0.5;
+
+	/** Fractions of textured blocks moving on their own that make a frame Scene / Mixed. */
+	constexpr float SceneThreshold = 0.05f;
+	constexpr float MixedThreshold = 0.2f;
+
+	enum class EBlockState : uint8
+	{
+		Flat,
+		Matched,
+		Unmatched
+	};
+
+	struct FBlock
+	{
+		FIntPoint Vector = FIntPoint::ZeroValue;
+		EBlockState State = EBlockState::Flat;
+	};
+
+	/** Least-squares fit of V = T + S * P over the blocks Include accepts. False if none. */
+	static bool FitModel(const TArray<FBlock>& Blocks, const TArray<FVector2D>& Positions,
+	                     TFunctionRef<bool(int32)> Include, FVector2D& OutT, double& OutS)
+	{
+		FVector2D MeanP = FVector2D::ZeroVector, MeanV = FVector2D::ZeroVector;
+		int32 Count = 0;
+		for (int32 i = 0; i < Blocks.Num(); ++i)
+		{
+			if (Include(i))
+			{
+				MeanP += Positions[i];
+				MeanV += FVector2D(Blocks[i].Vector);
+				++Count;
+			}
+		}
+		if (Count == 0)
+		{
+			return false;
+		}
+		MeanP /= Count;
+		MeanV /= Count;
+
+		double Num = 0.0, Den = 0.0;
+		for (int32 i = 0; i < Blocks.Num(); ++i)
+		{
+			if (Include(i))
+			{
+				const FVector2D Pc = Positions[i] - MeanP;
+				const FVector2D Vc = FVector2D(Blocks[i].Vector) - MeanV;
+				Num += FVector2D::DotProduct(Pc, Vc);
+				Den += Pc.SizeSquared();
+			}
+		}
+
+		OutS = (Den > UE_SMALL_NUMBER) ? Num / Den : 0.0;
+		OutT = MeanV - OutS * MeanP;
+		return true;
+	}
+}
+
+const TCHAR* FPerceptionMotionEstimator::GetKernelName()
+{
+#if PERCEPTION_MOTION_SSE2
+	return TEXT("SSE2");
+#elif PERCEPTION_MOTION_NEON
+	return TEXT("NEON");
+#else
+	return TEXT("Scalar");
+#endif
+}
+
+uint32 FPerceptionMotionEstimator::BlockSAD(const uint8* A, int32 StrideA, const uint8* B, int32 StrideB)
+{
+#if PERCEPTION_MOTION_SSE2
+	__m128i Acc = _mm_setzero_si128();
+	for (int32 Row = 0; Row < BlockSize; ++Row)
+	{
+		const __m128i RowA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A + Row * StrideA));
+		const __m128i RowB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + Row * StrideB));
+		Acc = _mm_add_epi64(Acc, _mm_sad_epu8(RowA, RowB));
+	}
+	return static_cast<uint32>(_mm_cvtsi128_si32(Acc) + _mm_cvtsi128_si32(_mm_srli_si128(Acc, 8)));
+#elif PERCEPTION_MOTION_NEON
+	// 16 rows of pairwise sums peak at 16 * 2 * 255, within 16 bits
+	uint16x8_t Acc = vdupq_n_u16(0);
+	for (int32 Row = 0; Row < BlockSize; ++Row)
+	{
+		Acc = vpadalq_u8(Acc, vabdq_u8(vld1q_u8(A + Row * StrideA), vld1q_u8(B + Row * StrideB)));
+	}
+	const uint64x2_t Sum = vpaddlq_u32(vpaddlq_u16(Acc));
+	return static_cast<uint32>(vgetq_lane_u64(Sum, 0) + vgetq_lane_u64(Sum, 1));
+#else
+	uint32 Sum = 0;
+	for (int32 Row = 0; Row < BlockSize; ++Row)
+	{
+		for (int32 x = 0; x < BlockSize; ++x)
+		{
+			Sum += static_cast<uint32>(FMath::Abs(A[Row * StrideA + x] - B[Row * StrideB + x]));
+		}
+	}
+	return Sum;
+#endif
+}
+
+FPerceptionMotion FPerceptionMotionEstimator::Update(const FPerceptionFrame& Frame, int32 MaxWorkers)
+{
+	FPerceptionMotion Motion;
+	if (Frame.Size.X <= 0 || Frame.Size.Y <= 0 || Frame.Pixels.Num() != Frame.Size.X * Frame.Size.Y)
+	{
+		return Motion;
+	}
+
+	const int32 Factor = FMath::Max(1, FMath::RoundToInt32(static_cast<float>(Frame.Size.X) / AnalysisWidth));
+	FPlaneRef Base, Current;
+	int64 BaseFrameNumber = 0;
+	FIntPoint PlaneSize;
+
+	// Takes the planes of Frame if it is the one analyzed last; Lock held
+	auto TakeKeptPlanes = [&]()
+	{
+		Base = BasePlane;
+		Current = PrevPlane;
+		BaseFrameNumber = BaseFrame;
+		PlaneSize = PrevPlaneSize;
+	};
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (Frame.FrameNumber < PrevFrame)
+		{
+			return Motion;
+		}
+		if (Frame.FrameNumber == PrevFrame)
+		{
+			if (PrevMotionFrame == PrevFrame)
+			{
+				return PrevMotion;
+			}
+			TakeKeptPlanes();
+		}
+	}
+
+	if (!Current.IsValid())
+	{
+		Current = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(
+			FPerceptionAdapter::DownsampleLuma(Frame.Pixels, Frame.Size, Factor, PlaneSize, MaxWorkers));
+
+		FScopeLock ScopeLock(&Lock);
+		if (Frame.FrameNumber < PrevFrame)
+		{
+			return Motion;
+		}
+		if (Frame.FrameNumber == PrevFrame)
+		{
+			// Another caller got the frame in first
+			if (PrevMotionFrame == PrevFrame)
+			{
+				return PrevMotion;
+			}
+			TakeKeptPlanes();
+		}
+		else
+		{
+			const bool bComparable = PrevFrame > 0 && PrevSize == Frame.Size;
+			BasePlane = bComparable ? PrevPlane : nullptr;
+			BaseFrame = bComparable ? PrevFrame : 0;
+			PrevPlane = Current;
+			PrevSize = Frame.Size;
+			PrevPlaneSize = PlaneSize;
+			PrevFrame = Frame.FrameNumber;
+			Base = BasePlane;
+			BaseFrameNumber = BaseFrame;
+		}
+	}
+
+	if (Base.IsValid() && Base->Num() == Current->Num() && Current->Num() > 0)
+	{
+		Motion.BaseFrame = BaseFrameNumber;
+		Estimate(*Base, *Current, PlaneSize, Factor, MaxWorkers, Motion);
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	if (Frame.FrameNumber == PrevFrame)
+	{
+		PrevMotion = Motion;
+		PrevMotionFrame = Frame.FrameNumber;
+	}
+	return Motion;
+}
+
+void FPerceptionMotionEstimator::Estimate(const TArray<uint8>& Previous, const TArray<uint8>& Current, FIntPoint PlaneSize,
+                                          int32 Factor, int32 MaxWorkers, FPerceptionMotion& Motion)
+{
+	using namespace PerceptionMotion;
+
+	const FIntPoint Grid(PlaneSize.X / BlockSize, PlaneSize.Y / BlockSize);
+	if (Grid.X < 2 || Grid.Y < 2)
+	{
+		return;
+	}
+
+	const int32 Width = PlaneSize.X;
+	TArray<FBlock> Blocks;
+	Blocks.SetNum(Grid.X * Grid.Y);
+
+	auto SearchRow = [&](int32 BlockY)
+	{
+		const int32 Y0 = BlockY * BlockSize;
+		for (int32 BlockX = 0; BlockX < Grid.X; ++BlockX)
+		{
+			const int32 X0 = BlockX * BlockSize;
+			const uint8* Cur = Current.GetData() + Y0 * Width + X0;
+			FBlock& Block = Blocks[BlockY * Grid.X + BlockX];
+
+			// Texture: the block against itself shifted a pixel, sideways and down (up/left at the far edges)
+			const int32 StepX = (X0 + BlockSize < PlaneSize.X) ? 1 : -1;
+			const int32 StepY = (Y0 + BlockSize < PlaneSize.Y) ? Width : -Width;
+			if (BlockSAD(Cur, Width, Cur + StepX, Width) + BlockSAD(Cur, Width, Cur + StepY, Width) < MinTexture)
+			{
+				continue;
+			}
+
+			const uint32 ZeroSAD = BlockSAD(Cur, Width, Previous.GetData() + Y0 * Width + X0, Width);
+			uint32 BestSAD = ZeroSAD;
+			FIntPoint Best = FIntPoint::ZeroValue;
+
+			const int32 MinDY = FMath::Max(-SearchRange, -Y0);
+			const int32 MaxDY = FMath::Min(SearchRange, PlaneSize.Y - BlockSize - Y0);
+			const int32 MinDX = FMath::Max(-SearchRange, -X0);
+			const int32 MaxDX = FMath::Min(SearchRange, PlaneSize.X - BlockSize - X0);
+			for (int32 DY = MinDY; DY <= MaxDY; ++DY)
+			{
+				const uint8* PrevRow = Previous.GetData() + (Y0 + DY) * Width + X0;
+				for (int32 DX = MinDX; DX <= MaxDX; ++DX)
+				{
+					const uint32 SAD = BlockSAD(Cur, Width, PrevRow + DX, Width);
+					if (SAD < BestSAD)
+					{
+						BestSAD = SAD;
+						Best = FIntPoint(DX, DY);
+					}
+				}
+			}
+
+			if (ZeroSAD <= BestSAD + ZeroBias)
+			{
+				BestSAD = ZeroSAD;
+				Best = FIntPoint::ZeroValue;
+			}
+
+			// The block came from Best in the previous frame, so its content moved by -Best
+			Block.State = (BestSAD <= MaxMatchError) ? EBlockState::Matched : EBlockState::Unmatched;
+			Block.Vector = (Block.State == EBlockState::Matched) ? -Best : FIntPoint::ZeroValue;
+		}
+	};
+
+	const int32 Bands = FMath::Clamp(MaxWorkers, 1, Grid.Y);
+	ParallelFor(TEXT("PerceptionMotion.BlockRows"), Bands, 1, [&](int32 Band)
+	{
+		for (int32 BlockY = Grid.Y * Band / Bands; BlockY < Grid.Y * (Band + 1) / Bands; ++BlockY)
+		{
+			SearchRow(BlockY);
+		}
+	}, Bands > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	// Block centres relative to the frame centre, for the zoom term
+	TArray<FVector2D> Positions;
+	Positions.SetNumUninitialized(Blocks.Num());
+	int32 Textured = 0;
+	for (int32 i = 0; i < Blocks.Num(); ++i)
+	{
+		Positions[i] = FVector2D(
+			(i % Grid.X) * BlockSize + BlockSize * 0.5 - PlaneSize.X * 0.5,
+			(i / Grid.X) * BlockSize + BlockSize * 0.5 - PlaneSize.Y * 0.5);
+		Textured += (Blocks[i].State != EBlockState::Flat) ? 1 : 0;
+	}
+
+	auto IsInlier = [&](int32 i, const FVector2D& T, double S)
+	{
+		return Blocks[i].State == EBlockState::Matched
+			&& FVector2D::Distance(FVector2D(Blocks[i].Vector), T + S * Positions[i]) <= InlierDistance;
+	};
+
+	// Fit on every match, then refit on the blocks that agree so independent movers don't skew it
+	FVector2D T = FVector2D::ZeroVector;
+	double S = 0.0;
+	if (FitModel(Blocks, Positions, [&](int32 i) { return Blocks[i].State == EBlockState::Matched; }, T, S))
+	{
+		const FVector2D FirstT = T;
+		const double FirstS = S;
+		if (!FitModel(Blocks, Positions, [&](int32 i) { return IsInlier(i, FirstT, FirstS); }, T, S))
+		{
+			T = FirstT;
+			S = FirstS;
+		}
+	}
+
+	int32 Inliers = 0;
+	for (int32 i = 0; i < Blocks.Num(); ++i)
+	{
+		Inliers += IsInlier(i, T, S) ? 1 : 0;
+	}
+
+	Motion.bValid = true;
+	Motion.BlockSize = BlockSize * Factor;
+	Motion.GridSize = Grid;
+	Motion.CameraTranslation = T * Factor;
+	Motion.CameraZoom = static_cast<float>(S);
+	Motion.Coherence = Textured > 0 ? static_cast<float>(Inliers) / Textured : 0.0f;
+	Motion.LocalMotion = Textured > 0 ? static_cast<float>(Textured - Inliers) / Textured : 0.0f;
+
+	Motion.Vectors.SetNumUninitialized(Blocks.Num());
+	for (int32 i = 0; i < Blocks.Num(); ++i)
+	{
+		Motion.Vectors[i] = Blocks[i].Vector * Factor;
+	}
+
+	const double MeanRadius = (PlaneSize.X + PlaneSize.Y) * 0.25;
+	const bool bGlobal = (T.Size() + FMath::Abs(S) * MeanRadius) >= MinGlobalMotion;
+	if (bGlobal)
+	{
+		Motion.Kind = (Motion.LocalMotion < MixedThreshold) ? EPerceptionMotionKind::Camera : EPerceptionMotionKind::Mixed;
+	}
+	else
+	{
+		Motion.Kind = (Motion.LocalMotion < SceneThreshold) ? EPerceptionMotionKind::Static : EPerceptionMotionKind::Scene;
+	}
+}
@@ -0,0 +1,66 @@
+// PerceptionMotion.h
+// Coarse block-motion estimation between consecutive analyzed frames.
+//
+// Each frame is reduced to a luma plane about AnalysisWidth pixels wide
+// (FPerceptionAdapter::DownsampleLuma). The plane is cut into BlockSize blocks
+// and every textured block is matched against the previous plane by full
+// search within +-SearchRange, using sums of absolute differences (SSE2
+// _mm_sad_epu8 / NEON, scalar fallback). Block rows are searched in parallel.
+//
+// A translation-plus-zoom model is then fitted to the matched vectors, twice,
+// the second time on the inliers of the first. Blocks that follow it are
+// camera motion; blocks that don't, or found no match, are scene changes.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PerceptionTypes.h"
+#include "PerceptionFrame.h"
+
+class FPerceptionMotionEstimator
+{
+public:
+	/** Target width of the luma plane; the downsample factor is picked to land near it. */
+	static constexpr int32 AnalysisWidth = 256;
+
+	/** Block edge on the luma plane (16 bytes: one SAD instruction per block row). */
+	static constexpr int32 BlockSize = 16;
+
+	/** Search radius on the luma plane. */
+	static constexpr int32 SearchRange = 8;
+
+	/** Motion of Frame against the last frame analyzed before it. Frames older than the last
+	 *  one analyzed get an invalid result unless it is the same frame. Thread-safe; the search
+	 *  runs outside the lock, so callers for different frames don't queue behind it. */
+	FPerceptionMotion Update(const FPerceptionFrame& Frame, int32 MaxWorkers = 1);
+
+	/** Sum of absolute differences of a BlockSize x BlockSize block. */
+	static uint32 BlockSAD(const uint8* A, int32 StrideA, const uint8* B, int32 StrideB);
+
+	/** Name of the vector path compiled into this build ("SSE2", "NEON" or "Scalar"). */
+	static const TCHAR* GetKernelName();
+
+private:
+	/** Fill Motion from the two planes. */
+	static void Estimate(const TArray<uint8>& Previous, const TArray<uint8>& Current, FIntPoint PlaneSize,
+	                     int32 Factor, int32 MaxWorkers, FPerceptionMotion& Motion);
+
+	/** Planes are shared so Update swaps them under Lock and searches them outside it */
+	using FPlaneRef = TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+	FCriticalSection Lock;
+
+	FPlaneRef PrevPlane;
+	FIntPoint PrevSize = FIntPoint::ZeroValue;
+	FIntPoint PrevPlaneSize = FIntPoint::ZeroValue;
+	int64 PrevFrame = 0;
+
+	/** Plane PrevFrame is measured against (null if none of the same size), so a repeat
+	 *  request that arrives before PrevMotion is in can run the search itself */
+	FPlaneRef BasePlane;
+	int64 BaseFrame = 0;
+
+	/** Result for PrevMotionFrame, for repeat requests */
+	FPerceptionMotion PrevMotion;
+	int64 PrevMotionFrame = 0;
+};
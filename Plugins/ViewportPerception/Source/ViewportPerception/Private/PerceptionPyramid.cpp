@@ -0,0 +1,159 @@
+// PerceptionPyramid.cpp
+
+#include "PerceptionPyramid.h"
+#include "PerceptionAdapter.h"
+
+namespace
+{
+	/** Halvings stop before either axis would drop below this */
+	constexpr int32 MinLevelEdge = 16;
+}
+
+void FPerceptionPyramid::Configure(int32 Levels, int32 InThumbnailWidth)
+{
+	FScopeLock ScopeLock(&Lock);
+	NumLevels = FMath::Clamp(Levels, 1, MaxLevels);
+	ThumbnailWidth = FMath::Max(InThumbnailWidth, 0);
+
+	// Kept levels may no longer match the new layout
+	Built.Reset();
+	BuiltFrame = 0;
+}
+
+TArray<FIntPoint> FPerceptionPyramid::ComputeLevelSizes(FIntPoint BaseSize, int32 Levels, int32 InThumbnailWidth)
+{
+	TArray<FIntPoint> Sizes;
+	if (BaseSize.X <= 0 || BaseSize.Y <= 0)
+	{
+		return Sizes;
+	}
+
+	Sizes.Add(BaseSize);
+	while (Sizes.Num() < Levels)
+	{
+		const FIntPoint Half(Sizes.Last().X / 2, Sizes.Last().Y / 2);
+		if (Half.X < MinLevelEdge || Half.Y < MinLevelEdge)
+		{
+			break;
+		}
+		Sizes.Add(Half);
+	}
+
+	if (InThumbnailWidth > 0 && InThumbnailWidth < Sizes.Last().X)
+	{
+		const int32 Height = FMath::Max(1, FMath::RoundToInt32(static_cast<double>(BaseSize.Y) * InThumbnailWidth / BaseSize.X));
+		Sizes.Add(FIntPoint(InThumbnailWidth, Height));
+	}
+
+	return Sizes;
+}
+
+TArray<FIntPoint> FPerceptionPyramid::GetLevelSizes(FIntPoint FrameSize) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return ComputeLevelSizes(FrameSize, NumLevels, ThumbnailWidth);
+}
+
+int32 FPerceptionPyramid::FindLevelForWidth(FIntPoint FrameSize, int32 Width) const
+{
+	const TArray<FIntPoint> Sizes = GetLevelSizes(FrameSize);
+	for (int32 Level = Sizes.Num() - 1; Level > 0; --Level)
+	{
+		if (Sizes[Level].X >= Width)
+		{
+			return Level;
+		}
+	}
+	return 0;
+}
+
+TSharedPtr<const FPerceptionPyramidLevels, ESPMode::ThreadSafe> FPerceptionPyramid::Build(const FPerceptionFrame& Frame,
+                                                                                          const TArray<FColor>* Seed,
+                                                                                          FIntPoint SeedSize, int32 MaxWorkers)
+{
+	// Held across the pass so concurrent requests for the frame share it
+	FScopeLock ScopeLock(&Lock);
+
+	if (Built.IsValid() && BuiltFrame == Frame.FrameNumber)
+	{
+		return Built;
+	}
+
+	const TArray<FIntPoint> Sizes = ComputeLevelSizes(Frame.Size, NumLevels, ThumbnailWidth);
+	if (Sizes.Num() == 0 || Frame.Pixels.Num() < Frame.Size.X * Frame.Size.Y)
+	{
+		return nullptr;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSharedRef<FPerceptionPyramidLevels, ESPMode::ThreadSafe> Levels = MakeShared<FPerceptionPyramidLevels, ESPMode::ThreadSafe>();
+	Levels->SetNum(Sizes.Num());
+
+	// Level 0 is the frame itself; nothing to copy
+	(*Levels)[0].Size = Frame.Size;
+
+	for (int32 Level = 1; Level < Sizes.Num(); ++Level)
+	{
+		FPerceptionPyramidLevel& Current = (*Levels)[Level];
+
+		// Level 1 is the only one read from a large source: the encoder's resize of the frame if
+		// it covers the level, so the full frame isn't read again, else the frame itself
+		const TArray<FColor>* Source = &(*Levels)[Level - 1].Pixels;
+		FIntPoint SourceSize = (*Levels)[Level - 1].Size;
+		if (Level == 1)
+		{
+			const bool bSeedCovers = Seed && SeedSize.X >= Sizes[Level].X && SeedSize.Y >= Sizes[Level].Y
+				&& Seed->Num() >= SeedSize.X * SeedSize.Y;
+			Source = bSeedCovers ? Seed : &Frame.Pixels;
+			SourceSize = bSeedCovers ? SeedSize : Frame.Size;
+		}
+
+		if (SourceSize == Sizes[Level])
+		{
+			Current.Size = SourceSize;
+			Current.Pixels = *Source;
+		}
+		else if (Sizes[Level] == FIntPoint(SourceSize.X / 2, SourceSize.Y / 2))
+		{
+			Current.Pixels = FPerceptionAdapter::Halve(*Source, SourceSize, Current.Size, MaxWorkers);
+		}
+		else
+		{
+			// Thumbnail, or a seed that isn't exactly twice the level
+			Current.Size = Sizes[Level];
+			Current.Pixels = FPerceptionAdapter::Resize(*Source, SourceSize, Current.Size, MaxWorkers);
+		}
+
+		if (Current.Pixels.Num() == 0)
+		{
+			return nullptr;
+		}
+	}
+
+	Built = Levels;
+	BuiltFrame = Frame.FrameNumber;
+	++Builds;
+	LastBuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	return Built;
+}
+
+FPerceptionPyramidStats FPerceptionPyramid::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FPerceptionPyramidStats Stats;
+	Stats.Levels = NumLevels;
+	Stats.ThumbnailWidth = ThumbnailWidth;
+	Stats.BuiltFrame = Built.IsValid() ? BuiltFrame : 0;
+	Stats.Builds = Builds;
+	Stats.LastBuildMs = LastBuildMs;
+	if (Built.IsValid())
+	{
+		for (const FPerceptionPyramidLevel& Level : *Built)
+		{
+			Stats.BuiltBytes += Level.Pixels.Num() * sizeof(FColor);
+		}
+	}
+	return Stats;
+}
@@ -0,0 +1,88 @@
+// PerceptionPyramid.h
+// Multi-resolution renditions of one captured frame.
+//
+// Level 0 is the captured frame at its own size; each level after it is half the
+// size of the one before (2x2 box average), and an optional thumbnail of a fixed
+// width comes last. All levels are produced in one cascaded pass: level 1 is the
+// only one read from a large source, and every smaller level is made from the
+// level above it, so a 1/8 rendition costs a sliver of the full-res work. Level 1
+// starts from the image the encoder already resized the frame to when that covers
+// it, so the full-resolution frame isn't read a second time.
+//
+// The pass runs on the first level or width request for a frame and its pixels
+// are kept until a newer frame is asked for; encoding stays per request and per
+// level, in the subsystem's packet cache, so levels nobody asks for are never
+// compressed.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PerceptionFrame.h"
+
+struct FPerceptionPyramidLevel
+{
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	/** Empty for level 0, which is the frame's own pixels */
+	TArray<FColor> Pixels;
+};
+
+using FPerceptionPyramidLevels = TArray<FPerceptionPyramidLevel>;
+
+struct FPerceptionPyramidStats
+{
+	int32 Levels = 0;
+	int32 ThumbnailWidth = 0;
+
+	/** Frame the kept levels belong to, 0 if none */
+	int64 BuiltFrame = 0;
+
+	int64 Builds = 0;
+	int64 BuiltBytes = 0;
+	double LastBuildMs = 0.0;
+};
+
+class FPerceptionPyramid
+{
+public:
+	/** Halving levels, level 0 included, before the thumbnail. */
+	static constexpr int32 MaxLevels = 5;
+
+	static constexpr int32 DefaultLevels = 3;
+	static constexpr int32 DefaultThumbnailWidth = 160;
+
+	/** Levels is clamped to 1..MaxLevels; ThumbnailWidth 0 drops the thumbnail. Thread-safe. */
+	void Configure(int32 Levels, int32 ThumbnailWidth);
+
+	/** Size of every level for a frame of FrameSize. Halvings that would go below 16 px are
+	 *  skipped, as is a thumbnail no narrower than the last halving. */
+	TArray<FIntPoint> GetLevelSizes(FIntPoint FrameSize) const;
+
+	/** Smallest level at least Width wide, or level 0 if none is. */
+	int32 FindLevelForWidth(FIntPoint FrameSize, int32 Width) const;
+
+	/** Pixels of every level of Frame, level 0 left empty. Level 1 is made from Seed, an image of
+	 *  the same frame SeedSize large, if it covers the level, else from the frame. The cascade runs
+	 *  on the first call for a frame; later calls share its result. Thread-safe; concurrent
+	 *  callers for the same frame wait for one pass. */
+	TSharedPtr<const FPerceptionPyramidLevels, ESPMode::ThreadSafe> Build(const FPerceptionFrame& Frame,
+	                                                                      const TArray<FColor>* Seed = nullptr,
+	                                                                      FIntPoint SeedSize = FIntPoint::ZeroValue,
+	                                                                      int32 MaxWorkers = 1);
+
+	FPerceptionPyramidStats GetStats() const;
+
+private:
+	static TArray<FIntPoint> ComputeLevelSizes(FIntPoint BaseSize, int32 Levels, int32 ThumbnailWidth);
+
+	mutable FCriticalSection Lock;
+
+	int32 NumLevels = DefaultLevels;
+	int32 ThumbnailWidth = DefaultThumbnailWidth;
+
+	TSharedPtr<const FPerceptionPyramidLevels, ESPMode::ThreadSafe> Built;
+	int64 BuiltFrame = 0;
+
+	int64 Builds = 0;
+	double LastBuildMs = 0.0;
+};
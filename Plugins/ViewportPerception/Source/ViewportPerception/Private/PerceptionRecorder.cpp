@@ -0,0 +1,324 @@
+// PerceptionRecorder.cpp
+
+#include "PerceptionRecorder.h"
+#include "PerceptionEncoder.h"
+#include "ViewportPerceptionModule.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+const TCHAR* FPerceptionRecorder::IndexFileName = TEXT("index.vpidx");
+
+FString FPerceptionRecorder::GetSegmentFileName(int32 Segment)
+{
+	return FString::Printf(TEXT("segment_%05d.vpseg"), Segment);
+}
+
+FString FPerceptionRecorder::GetRecordingsRoot()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Perception"), TEXT("Recordings"));
+}
+
+FPerceptionRecorder::FPerceptionRecorder()
+	: bStopRequested(false)
+	, bAccepting(false)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FPerceptionRecorder::~FPerceptionRecorder()
+{
+	Shutdown();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+bool FPerceptionRecorder::Start(const FString& InDirectory, int64 InSegmentBytes)
+{
+	if (Thread)
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Already recording to %s"), *Directory);
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString IndexPath = FPaths::Combine(InDirectory, IndexFileName);
+
+	if (!PlatformFile.CreateDirectoryTree(*InDirectory))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to create recording directory %s"), *InDirectory);
+		return false;
+	}
+
+	if (PlatformFile.FileExists(*IndexPath))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("%s already holds a recording"), *InDirectory);
+		return false;
+	}
+
+	IndexFile.Reset(PlatformFile.OpenWrite(*IndexPath));
+	FPerceptionRecordingHeader Header;
+	Header.EntryBytes = sizeof(FPerceptionRecordIndexEntry);
+	if (!IndexFile || !IndexFile->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header)))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to create %s"), *IndexPath);
+		IndexFile.Reset();
+		return false;
+	}
+
+	Directory = InDirectory;
+	SegmentBytes = FMath::Max<int64>(InSegmentBytes, 1024 * 1024);
+	bFailed = false;
+
+	{
+		FScopeLock Lock(&StatsLock);
+		Stats = FPerceptionRecorderStats();
+		Stats.Directory = Directory;
+	}
+
+	if (!OpenSegment(0))
+	{
+		IndexFile.Reset();
+		return false;
+	}
+
+	bStopRequested = false;
+	Thread = FRunnableThread::Create(this, TEXT("PerceptionRecorder"), 0, TPri_BelowNormal);
+
+	if (!Thread)
+	{
+		SegmentFile.Reset();
+		IndexFile.Reset();
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to create recorder thread"));
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&StatsLock);
+		Stats.bRecording = true;
+	}
+	bAccepting = true;
+
+	UE_LOG(LogViewportPerception, Log, TEXT("Recording to %s"), *Directory);
+	return true;
+}
+
+void FPerceptionRecorder::Shutdown()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	bAccepting = false;
+	{
+		FScopeLock Lock(&StatsLock);
+		Stats.bRecording = false;
+	}
+
+	Thread->Kill(true);  // Calls Stop() and waits for Run() to write out the queue
+	delete Thread;
+	Thread = nullptr;
+
+	SegmentFile.Reset();
+	IndexFile.Reset();
+
+	{
+		FScopeLock Lock(&QueueLock);
+		Queue.Reset();
+	}
+
+	UE_LOG(LogViewportPerception, Log, TEXT("Recording to %s stopped"), *Directory);
+}
+
+void FPerceptionRecorder::Enqueue(const TSharedRef<const FPerceptionEncodedFrame, ESPMode::ThreadSafe>& Frame)
+{
+	if (!bAccepting)
+	{
+		return;
+	}
+
+	bool bDropped = false;
+	{
+		FScopeLock Lock(&QueueLock);
+		if (Queue.Num() >= MaxQueued)
+		{
+			bDropped = true;
+		}
+		else
+		{
+			FPendingFrame& Pending = Queue.AddDefaulted_GetRef();
+			Pending.Frame = Frame;
+			Pending.QueuedTime = FPlatformTime::Seconds();
+		}
+	}
+
+	if (bDropped)
+	{
+		FScopeLock Lock(&StatsLock);
+		++Stats.FramesDropped;
+		return;
+	}
+
+	WakeEvent->Trigger();
+}
+
+void FPerceptionRecorder::AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber)
+{
+	FScopeLock Lock(&QueueLock);
+	for (FPendingFrame& Pending : Queue)
+	{
+		if (Pending.Frame->Packet.FrameNumber == FrameNumber)
+		{
+			Pending.Metadata = Metadata;
+			Pending.bHasMetadata = true;
+			break;
+		}
+	}
+}
+
+FPerceptionRecorderStats FPerceptionRecorder::GetStats() const
+{
+	FPerceptionRecorderStats Result;
+	{
+		FScopeLock Lock(&StatsLock);
+		Result = Stats;
+	}
+	{
+		FScopeLock Lock(&QueueLock);
+		Result.Queued = Queue.Num();
+	}
+	return Result;
+}
+
+uint32 FPerceptionRecorder::Run()
+{
+	while (!bStopRequested)
+	{
+		// Also wakes up to flush packets whose metadata never came
+		WakeEvent->Wait(50);
+		WritePending(false);
+	}
+
+	WritePending(true);
+	return 0;
+}
+
+void FPerceptionRecorder::Stop()
+{
+	bStopRequested = true;
+	WakeEvent->Trigger();
+}
+
+void FPerceptionRecorder::WritePending(bool bAll)
+{
+	for (;;)
+	{
+		FPendingFrame Pending;
+		{
+			FScopeLock Lock(&QueueLock);
+			if (Queue.Num() == 0)
+			{
+				return;
+			}
+
+			// Once a newer packet is out, metadata can no longer be attached to this one
+			const FPendingFrame& Oldest = Queue[0];
+			const bool bSettled = bAll || Oldest.bHasMetadata || Queue.Num() > 1
+				|| FPlatformTime::Seconds() - Oldest.QueuedTime >= MetadataGraceSeconds;
+			if (!bSettled)
+			{
+				return;
+			}
+
+			Pending = MoveTemp(Queue[0]);
+			Queue.RemoveAt(0, EAllowShrinking::No);
+		}
+
+		if (!bFailed && !WriteRecord(Pending))
+		{
+			bFailed = true;
+			UE_LOG(LogViewportPerception, Warning, TEXT("Recording to %s failed, dropping further frames"), *Directory);
+		}
+
+		if (bFailed)
+		{
+			FScopeLock Lock(&StatsLock);
+			++Stats.FramesDropped;
+		}
+	}
+}
+
+bool FPerceptionRecorder::WriteRecord(const FPendingFrame& Pending)
+{
+	FPerceptionPacket Packet = Pending.Frame->Packet;
+	if (Pending.bHasMetadata)
+	{
+		FPerceptionMetadata Metadata = Pending.Metadata;
+		Metadata.CopyEncodeResults(Packet.Metadata);
+		Packet.Metadata = MoveTemp(Metadata);
+	}
+
+	TArray<uint8> Payload;
+	FMemoryWriter Writer(Payload);
+	FPerceptionPacket::StaticStruct()->SerializeItem(Writer, &Packet, nullptr);
+
+	FPerceptionRecordHeader Header;
+	Header.PayloadBytes = Payload.Num();
+	Header.FrameNumber = Packet.FrameNumber;
+	const int64 RecordBytes = sizeof(Header) + Payload.Num();
+
+	// Every segment holds at least one record, however large
+	if (SegmentOffset > 0 && SegmentOffset + RecordBytes > SegmentBytes && !OpenSegment(CurrentSegment + 1))
+	{
+		return false;
+	}
+
+	if (!SegmentFile->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header))
+		|| !SegmentFile->Write(Payload.GetData(), Payload.Num())
+		|| !SegmentFile->Flush())
+	{
+		return false;
+	}
+
+	// Index last, once the record is on disk
+	FPerceptionRecordIndexEntry Entry;
+	Entry.FrameNumber = Packet.FrameNumber;
+	Entry.Timestamp = Packet.Timestamp;
+	Entry.Offset = SegmentOffset;
+	Entry.Segment = CurrentSegment;
+	Entry.Length = static_cast<int32>(RecordBytes);
+	if (!IndexFile->Write(reinterpret_cast<const uint8*>(&Entry), sizeof(Entry)) || !IndexFile->Flush())
+	{
+		return false;
+	}
+
+	SegmentOffset += RecordBytes;
+
+	FScopeLock Lock(&StatsLock);
+	++Stats.FramesWritten;
+	Stats.BytesWritten += RecordBytes + sizeof(Entry);
+	return true;
+}
+
+bool FPerceptionRecorder::OpenSegment(int32 Segment)
+{
+	const FString Path = FPaths::Combine(Directory, GetSegmentFileName(Segment));
+	SegmentFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path));
+	if (!SegmentFile)
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to create %s"), *Path);
+		return false;
+	}
+
+	CurrentSegment = Segment;
+	SegmentOffset = 0;
+
+	FScopeLock Lock(&StatsLock);
+	Stats.Segments = Segment + 1;
+	return true;
+}
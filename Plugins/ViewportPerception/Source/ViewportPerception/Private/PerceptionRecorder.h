@@ -0,0 +1,167 @@
+// PerceptionRecorder.h
+// Records published packets to disk for offline replay (PerceptionReplay.h).
+//
+// A recording is a directory of segment files plus an append-only index:
+//
+//   index.vpidx          FPerceptionRecordingHeader, then one FPerceptionRecordIndexEntry per frame
+//   segment_00000.vpseg  FPerceptionRecordHeader + payload, per frame, back to back
+//   segment_00001.vpseg  ...started once the previous one would exceed the segment size
+//
+// The payload is the whole FPerceptionPacket (encoded image, metadata, changes,
+// hashes) in tagged-property serialization, so recordings stay readable as the
+// packet struct grows. A record is written to its segment before its index entry,
+// so the index never points at missing bytes, even after a crash.
+//
+// The encoder hands packets over as it publishes them; a worker thread writes
+// them out. Packets wait briefly for the metadata attached on the game tick
+// before they are written. If the disk can't keep up the queue is capped and
+// further packets are dropped rather than held.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "PerceptionTypes.h"
+
+struct FPerceptionEncodedFrame;
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+/** Start of the index file. */
+struct FPerceptionRecordingHeader
+{
+	static constexpr uint32 MagicValue = 0x58495056; // "VPIX"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = MagicValue;
+	uint32 Version = CurrentVersion;
+	uint32 EntryBytes = 0;
+	uint32 Reserved = 0;
+};
+
+/** Where one frame's record lives. */
+struct FPerceptionRecordIndexEntry
+{
+	int64 FrameNumber = 0;
+
+	/** Platform seconds at capture, as in FPerceptionPacket::Timestamp */
+	double Timestamp = 0.0;
+
+	/** Byte offset of the record header in its segment */
+	int64 Offset = 0;
+
+	int32 Segment = 0;
+
+	/** Record header plus payload */
+	int32 Length = 0;
+};
+static_assert(sizeof(FPerceptionRecordIndexEntry) == 32, "Index entries are written as raw 32-byte records");
+
+/** Start of each record in a segment. */
+struct FPerceptionRecordHeader
+{
+	static constexpr uint32 MagicValue = 0x43525056; // "VPRC"
+
+	uint32 Magic = MagicValue;
+	uint32 PayloadBytes = 0;
+	int64 FrameNumber = 0;
+};
+
+struct FPerceptionRecorderStats
+{
+	bool bRecording = false;
+	FString Directory;
+	int32 Segments = 0;
+	int64 FramesWritten = 0;
+	int64 BytesWritten = 0;
+
+	/** Packets dropped because the write queue was full */
+	int64 FramesDropped = 0;
+
+	int32 Queued = 0;
+};
+
+class FPerceptionRecorder : public FRunnable
+{
+public:
+	static constexpr int64 DefaultSegmentBytes = 256ll * 1024 * 1024;
+
+	/** Packets waiting to be written beyond this are dropped. */
+	static constexpr int32 MaxQueued = 64;
+
+	/** How long a packet waits for its metadata when no newer packet has arrived. */
+	static constexpr double MetadataGraceSeconds = 0.25;
+
+	static const TCHAR* IndexFileName;
+
+	/** segment_NNNNN.vpseg */
+	static FString GetSegmentFileName(int32 Segment);
+
+	/** Saved/Perception/Recordings, where recordings named over HTTP go. */
+	static FString GetRecordingsRoot();
+
+	FPerceptionRecorder();
+	virtual ~FPerceptionRecorder() override;
+
+	/** Begin a recording in Directory, which is created if needed. Fails if a recording is
+	 *  running, Directory already holds one, or the files can't be opened. */
+	bool Start(const FString& Directory, int64 SegmentBytes = DefaultSegmentBytes);
+
+	/** Write out everything queued and close the files. */
+	void Shutdown();
+
+	bool IsRecording() const { return bAccepting.Load(); }
+
+	/** Queue a published packet for writing; ignored unless recording. Cheap; called from the encoder thread. */
+	void Enqueue(const TSharedRef<const FPerceptionEncodedFrame, ESPMode::ThreadSafe>& Frame);
+
+	/** Give a queued frame the metadata collected for it, keeping the encode-stage fields. */
+	void AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber);
+
+	FPerceptionRecorderStats GetStats() const;
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FPendingFrame
+	{
+		TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> Frame;
+		FPerceptionMetadata Metadata;
+		bool bHasMetadata = false;
+		double QueuedTime = 0.0;
+	};
+
+	/** Write queued packets that are done waiting for metadata (all of them if bAll). Worker thread. */
+	void WritePending(bool bAll);
+
+	/** Append one record and its index entry, starting a new segment if this one is full. Worker thread. */
+	bool WriteRecord(const FPendingFrame& Pending);
+
+	/** Close the current segment and open the next. Worker thread. */
+	bool OpenSegment(int32 Segment);
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	TAtomic<bool> bStopRequested;
+
+	/** Set while Enqueue takes packets, so the encoder thread never looks at Thread */
+	TAtomic<bool> bAccepting;
+
+	mutable FCriticalSection QueueLock;
+	TArray<FPendingFrame> Queue;
+
+	mutable FCriticalSection StatsLock;
+	FPerceptionRecorderStats Stats;
+
+	// Worker thread only (and Start/Shutdown while it isn't running)
+	FString Directory;
+	int64 SegmentBytes = DefaultSegmentBytes;
+	TUniquePtr<IFileHandle> IndexFile;
+	TUniquePtr<IFileHandle> SegmentFile;
+	int32 CurrentSegment = 0;
+	int64 SegmentOffset = 0;
+	bool bFailed = false;
+};
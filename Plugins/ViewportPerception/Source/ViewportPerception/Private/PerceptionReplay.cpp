@@ -0,0 +1,318 @@
+// PerceptionReplay.cpp
+
+#include "PerceptionReplay.h"
+#include "ViewportPerceptionModule.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+FPerceptionReplay::~FPerceptionReplay()
+{
+	Close();
+}
+
+bool FPerceptionReplay::Open(const FString& InDirectory)
+{
+	TArray<uint8> IndexBytes;
+	const FString IndexPath = FPaths::Combine(InDirectory, FPerceptionRecorder::IndexFileName);
+	if (!FFileHelper::LoadFileToArray(IndexBytes, *IndexPath))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("No recording index at %s"), *IndexPath);
+		return false;
+	}
+
+	FPerceptionRecordingHeader Header;
+	if (IndexBytes.Num() < static_cast<int32>(sizeof(Header)))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Recording index %s is truncated"), *IndexPath);
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, IndexBytes.GetData(), sizeof(Header));
+	if (Header.Magic != FPerceptionRecordingHeader::MagicValue
+		|| Header.Version != FPerceptionRecordingHeader::CurrentVersion
+		|| Header.EntryBytes != sizeof(FPerceptionRecordIndexEntry))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Recording index %s has an unsupported format"), *IndexPath);
+		return false;
+	}
+
+	// A partial trailing entry (recorder killed mid-write) is ignored
+	const int32 NumEntries = (IndexBytes.Num() - sizeof(Header)) / sizeof(FPerceptionRecordIndexEntry);
+	if (NumEntries == 0)
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Recording %s has no frames"), *InDirectory);
+		return false;
+	}
+
+	// Drops the old recording's prefetch and segment handle before its directory changes
+	Close();
+
+	FScopeLock ScopeLock(&Lock);
+
+	Entries.SetNumUninitialized(NumEntries);
+	FMemory::Memcpy(Entries.GetData(), IndexBytes.GetData() + sizeof(Header), NumEntries * sizeof(FPerceptionRecordIndexEntry));
+
+	Directory = InDirectory;
+	CachedIndex = INDEX_NONE;
+	CachedPacket = FPerceptionPacket();
+	PlayStartTime = FPlatformTime::Seconds();
+	Speed = 0.0f;
+
+	UE_LOG(LogViewportPerception, Log, TEXT("Opened recording %s: %d frames"), *Directory, NumEntries);
+	return true;
+}
+
+void FPerceptionReplay::Close()
+{
+	TFuture<TOptional<FPerceptionPacket>> Pending;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Entries.Empty();
+		CachedIndex = INDEX_NONE;
+		CachedPacket = FPerceptionPacket();
+		PrefetchIndex = INDEX_NONE;
+		Pending = MoveTemp(Prefetch);
+	}
+
+	// The worker reads through this object; let it finish before the handle goes
+	if (Pending.IsValid())
+	{
+		Pending.Wait();
+	}
+
+	FScopeLock FileScopeLock(&FileLock);
+	SegmentFile.Reset();
+	OpenSegment = INDEX_NONE;
+}
+
+bool FPerceptionReplay::IsOpen() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Num() > 0;
+}
+
+void FPerceptionReplay::Play(float InSpeed)
+{
+	FScopeLock ScopeLock(&Lock);
+	Speed = FMath::Max(InSpeed, 0.0f);
+	PlayStartTime = FPlatformTime::Seconds();
+}
+
+int32 FPerceptionReplay::GetPlayheadIndex() const
+{
+	if (Entries.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const double Target = Entries[0].Timestamp + (FPlatformTime::Seconds() - PlayStartTime) * Speed;
+	const int32 Upper = Algo::UpperBoundBy(Entries, Target, &FPerceptionRecordIndexEntry::Timestamp);
+	return FMath::Max(Upper - 1, 0);
+}
+
+int64 FPerceptionReplay::GetCurrentFrameNumber() const
+{
+	FScopeLock ScopeLock(&Lock);
+	const int32 Index = GetPlayheadIndex();
+	return Index != INDEX_NONE ? Entries[Index].FrameNumber : 0;
+}
+
+double FPerceptionReplay::GetCurrentTimestamp() const
+{
+	FScopeLock ScopeLock(&Lock);
+	const int32 Index = GetPlayheadIndex();
+	return Index != INDEX_NONE ? Entries[Index].Timestamp : 0.0;
+}
+
+bool FPerceptionReplay::GetCurrentPacket(FPerceptionPacket& OutPacket)
+{
+	int32 Index;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Index = GetPlayheadIndex();
+	}
+	return Index != INDEX_NONE && LoadPacket(Index, OutPacket);
+}
+
+bool FPerceptionReplay::GetPacketByFrame(int64 FrameNumber, FPerceptionPacket& OutPacket)
+{
+	int32 Index;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Index = Algo::UpperBoundBy(Entries, FrameNumber, &FPerceptionRecordIndexEntry::FrameNumber) - 1;
+	}
+	return Index >= 0 && LoadPacket(Index, OutPacket);
+}
+
+bool FPerceptionReplay::GetPacketAt(double Timestamp, FPerceptionPacket& OutPacket)
+{
+	int32 Index;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Index = Algo::UpperBoundBy(Entries, Timestamp, &FPerceptionRecordIndexEntry::Timestamp) - 1;
+	}
+	return Index >= 0 && LoadPacket(Index, OutPacket);
+}
+
+FPerceptionReplayStats FPerceptionReplay::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FPerceptionReplayStats Stats;
+	Stats.bOpen = Entries.Num() > 0;
+	Stats.Directory = Directory;
+	Stats.Frames = Entries.Num();
+	Stats.Speed = Speed;
+	if (Entries.Num() > 0)
+	{
+		const int32 Index = GetPlayheadIndex();
+		Stats.FirstFrame = Entries[0].FrameNumber;
+		Stats.LastFrame = Entries.Last().FrameNumber;
+		Stats.Duration = Entries.Last().Timestamp - Entries[0].Timestamp;
+		Stats.CurrentFrame = Entries[Index].FrameNumber;
+		Stats.bFinished = (Index == Entries.Num() - 1);
+	}
+	return Stats;
+}
+
+bool FPerceptionReplay::LoadPacket(int32 Index, FPerceptionPacket& OutPacket)
+{
+	FPerceptionRecordIndexEntry Entry;
+	TFuture<TOptional<FPerceptionPacket>> Ready;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!Entries.IsValidIndex(Index))
+		{
+			return false;
+		}
+
+		if (Index == CachedIndex)
+		{
+			OutPacket = CachedPacket;
+			StartPrefetch(Index + 1);
+			return true;
+		}
+
+		if (Index == PrefetchIndex)
+		{
+			Ready = MoveTemp(Prefetch);
+			PrefetchIndex = INDEX_NONE;
+		}
+		Entry = Entries[Index];
+	}
+
+	// Outside Lock: a prefetch still in flight, or a seek, costs this caller only
+	FPerceptionPacket Packet;
+	if (Ready.IsValid())
+	{
+		TOptional<FPerceptionPacket> Prefetched = Ready.Get();
+		if (!Prefetched.IsSet())
+		{
+			return false;
+		}
+		Packet = MoveTemp(Prefetched.GetValue());
+	}
+	else if (!ReadRecord(Entry, Packet))
+	{
+		return false;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	if (Entries.IsValidIndex(Index))
+	{
+		CachedIndex = Index;
+		CachedPacket = Packet;
+		StartPrefetch(Index + 1);
+	}
+	OutPacket = MoveTemp(Packet);
+	return true;
+}
+
+void FPerceptionReplay::StartPrefetch(int32 Index)
+{
+	if (!Entries.IsValidIndex(Index) || Index == CachedIndex || Index == PrefetchIndex)
+	{
+		return;
+	}
+
+	// One read ahead at a time; a prefetch the playhead skipped is simply dropped when done
+	if (Prefetch.IsValid() && !Prefetch.IsReady())
+	{
+		return;
+	}
+
+	const FPerceptionRecordIndexEntry Entry = Entries[Index];
+	PrefetchIndex = Index;
+	Prefetch = Async(EAsyncExecution::ThreadPool, [this, Entry]() -> TOptional<FPerceptionPacket>
+	{
+		FPerceptionPacket Packet;
+		if (!ReadRecord(Entry, Packet))
+		{
+			return TOptional<FPerceptionPacket>();
+		}
+		return TOptional<FPerceptionPacket>(MoveTemp(Packet));
+	});
+}
+
+bool FPerceptionReplay::ReadRecord(const FPerceptionRecordIndexEntry& Entry, FPerceptionPacket& OutPacket)
+{
+	if (Entry.Length < static_cast<int32>(sizeof(FPerceptionRecordHeader)))
+	{
+		return false;
+	}
+
+	// Open can swap the directory from another thread
+	FString RecordingDirectory;
+	{
+		FScopeLock ScopeLock(&Lock);
+		RecordingDirectory = Directory;
+	}
+
+	FScopeLock FileScopeLock(&FileLock);
+
+	if (Entry.Segment != OpenSegment)
+	{
+		const FString Path = FPaths::Combine(RecordingDirectory, FPerceptionRecorder::GetSegmentFileName(Entry.Segment));
+		SegmentFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+		OpenSegment = SegmentFile ? Entry.Segment : INDEX_NONE;
+		if (!SegmentFile)
+		{
+			UE_LOG(LogViewportPerception, Warning, TEXT("Failed to open %s"), *Path);
+			return false;
+		}
+	}
+
+	TArray<uint8> Record;
+	Record.SetNumUninitialized(Entry.Length);
+	if (!SegmentFile->Seek(Entry.Offset) || !SegmentFile->Read(Record.GetData(), Record.Num()))
+	{
+		return false;
+	}
+	FileScopeLock.Unlock();
+
+	FPerceptionRecordHeader Header;
+	FMemory::Memcpy(&Header, Record.GetData(), sizeof(Header));
+	if (Header.Magic != FPerceptionRecordHeader::MagicValue || Header.FrameNumber != Entry.FrameNumber
+		|| sizeof(Header) + Header.PayloadBytes != static_cast<uint32>(Entry.Length))
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Corrupt record for frame %lld in %s"), Entry.FrameNumber, *RecordingDirectory);
+		return false;
+	}
+
+	FPerceptionPacket Packet;
+	TArrayView<const uint8> Payload(Record.GetData() + sizeof(Header), Header.PayloadBytes);
+	FMemoryReaderView Reader(Payload);
+	FPerceptionPacket::StaticStruct()->SerializeItem(Reader, &Packet, nullptr);
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	OutPacket = MoveTemp(Packet);
+	return true;
+}
@@ -0,0 +1,106 @@
+// PerceptionReplay.h
+// Plays back a recording made by FPerceptionRecorder (layout in PerceptionRecorder.h).
+//
+// The index is loaded whole; records are read from their segment on demand and
+// the last one read is kept, so repeat requests for the playhead frame don't touch
+// the disk. Whenever a record is served, the one after it is read and deserialized
+// on a worker thread, so a playhead moving forward finds its next frame waiting.
+// Disk reads never happen under the lock the playhead queries take. The playhead
+// follows the recorded capture times scaled by Speed from the moment Play is
+// called, and stops on the last frame. Speed 0 holds the first frame; any frame
+// can still be fetched by number or recorded time. Thread-safe.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "PerceptionTypes.h"
+#include "PerceptionRecorder.h"
+
+class IFileHandle;
+
+struct FPerceptionReplayStats
+{
+	bool bOpen = false;
+	FString Directory;
+	int32 Frames = 0;
+	int64 FirstFrame = 0;
+	int64 LastFrame = 0;
+
+	/** Recorded seconds between the first and last frame */
+	double Duration = 0.0;
+
+	float Speed = 1.0f;
+	int64 CurrentFrame = 0;
+
+	/** The playhead is on the last frame */
+	bool bFinished = false;
+};
+
+class FPerceptionReplay
+{
+public:
+	~FPerceptionReplay();
+
+	/** Load the recording in Directory. False if it has no readable index or no frames. */
+	bool Open(const FString& Directory);
+
+	void Close();
+
+	bool IsOpen() const;
+
+	/** Restart the playhead on the first frame, advancing at Speed times recorded time. */
+	void Play(float Speed = 1.0f);
+
+	/** Frame number under the playhead, 0 if nothing is open. */
+	int64 GetCurrentFrameNumber() const;
+
+	/** Recorded capture time under the playhead. */
+	double GetCurrentTimestamp() const;
+
+	/** Packet under the playhead. */
+	bool GetCurrentPacket(FPerceptionPacket& OutPacket);
+
+	/** Newest recorded packet at or before frame FrameNumber. */
+	bool GetPacketByFrame(int64 FrameNumber, FPerceptionPacket& OutPacket);
+
+	/** Newest recorded packet captured at or before Timestamp (recorded platform seconds). */
+	bool GetPacketAt(double Timestamp, FPerceptionPacket& OutPacket);
+
+	FPerceptionReplayStats GetStats() const;
+
+private:
+	/** Index entry under the playhead. Lock must be held. */
+	int32 GetPlayheadIndex() const;
+
+	/** Record Index from the cache, the prefetch, or the disk, then prefetch the one after it.
+	 *  Takes Lock itself; must not be called with it held. */
+	bool LoadPacket(int32 Index, FPerceptionPacket& OutPacket);
+
+	/** Read and deserialize one record from its segment. Takes Lock briefly for the directory, then
+	 *  FileLock for the read; the caller must hold neither. */
+	bool ReadRecord(const FPerceptionRecordIndexEntry& Entry, FPerceptionPacket& OutPacket);
+
+	/** Start reading record Index on a worker unless it is cached or already on its way. Lock must be held. */
+	void StartPrefetch(int32 Index);
+
+	mutable FCriticalSection Lock;
+
+	FString Directory;
+	TArray<FPerceptionRecordIndexEntry> Entries;
+
+	double PlayStartTime = 0.0;
+	float Speed = 1.0f;
+
+	// Segment reads, by callers and the prefetch alike
+	FCriticalSection FileLock;
+	TUniquePtr<IFileHandle> SegmentFile;
+	int32 OpenSegment = INDEX_NONE;
+
+	int32 CachedIndex = INDEX_NONE;
+	FPerceptionPacket CachedPacket;
+
+	/** Record being read ahead on a worker; its packet is unset if the read failed */
+	int32 PrefetchIndex = INDEX_NONE;
+	TFuture<TOptional<FPerceptionPacket>> Prefetch;
+};
@@ -0,0 +1,367 @@
+// PerceptionResampler.cpp
+
+#include "PerceptionResampler.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	#define PERCEPTION_RESAMPLE_NEON 1
+	#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#define PERCEPTION_RESAMPLE_SSE2 1
+	#include <emmintrin.h>
+	#if PLATFORM_ALWAYS_HAS_AVX_2
+		#define PERCEPTION_RESAMPLE_AVX2 1
+		#include <immintrin.h>
+	#endif
+#endif
+
+#ifndef PERCEPTION_RESAMPLE_NEON
+	#define PERCEPTION_RESAMPLE_NEON 0
+#endif
+#ifndef PERCEPTION_RESAMPLE_SSE2
+	#define PERCEPTION_RESAMPLE_SSE2 0
+#endif
+#ifndef PERCEPTION_RESAMPLE_AVX2
+	#define PERCEPTION_RESAMPLE_AVX2 0
+#endif
+
+namespace PerceptionResample
+{
+	/** Split a source coordinate into a clamped integer tap and an 8.8 weight toward tap + 1. */
+	static void MakeTap(float SrcCoord, int32 SrcLimit, int32& OutTap, uint16& OutWeight)
+	{
+		const int32 Floor = FMath::FloorToInt32(SrcCoord);
+		int32 Weight = FMath::RoundToInt32((SrcCoord - Floor) * 256.0f);
+		int32 Tap = Floor;
+
+		if (Weight >= 256)
+		{
+			++Tap;
+			Weight = 0;
+		}
+		if (Tap < 0)
+		{
+			Tap = 0;
+			Weight = 0;
+		}
+		if (Tap >= SrcLimit - 1)
+		{
+			Tap = SrcLimit - 1;
+			Weight = 0;
+		}
+
+		OutTap = Tap;
+		OutWeight = static_cast<uint16>(Weight);
+	}
+
+	/** Out = (Top * (256 - W) + Bottom * W + 128) >> 8, per byte. Count is in bytes. */
+	static void BlendRowsScalar(const uint8* Top, const uint8* Bottom, uint8* Out, int32 Count, uint32 W)
+	{
+		const uint32 InvW = 256 - W;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Out[i] = static_cast<uint8>((Top[i] * InvW + Bottom[i] * W + 128) >> 8);
+		}
+	}
+
+	static void BlendRows(const uint8* Top, const uint8* Bottom, uint8* Out, int32 Count, uint32 W)
+	{
+		int32 i = 0;
+
+#if PERCEPTION_RESAMPLE_AVX2
+		{
+			const __m256i Zero = _mm256_setzero_si256();
+			const __m256i WBot = _mm256_set1_epi16(static_cast<int16>(W));
+			const __m256i WTop = _mm256_set1_epi16(static_cast<int16>(256 - W));
+			const __m256i Round = _mm256_set1_epi16(128);
+			for (; i + 32 <= Count; i += 32)
+			{
+				const __m256i T = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Top + i));
+				const __m256i B = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Bottom + i));
+				// Per-lane unpack and pack are symmetric, so byte order is preserved
+				__m256i Lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(T, Zero), WTop),
+				                              _mm256_mullo_epi16(_mm256_unpacklo_epi8(B, Zero), WBot));
+				__m256i Hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(T, Zero), WTop),
+				                              _mm256_mullo_epi16(_mm256_unpackhi_epi8(B, Zero), WBot));
+				Lo = _mm256_srli_epi16(_mm256_add_epi16(Lo, Round), 8);
+				Hi = _mm256_srli_epi16(_mm256_add_epi16(Hi, Round), 8);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + i), _mm256_packus_epi16(Lo, Hi));
+			}
+		}
+#endif
+
+#if PERCEPTION_RESAMPLE_SSE2
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i WBot = _mm_set1_epi16(static_cast<int16>(W));
+			const __m128i WTop = _mm_set1_epi16(static_cast<int16>(256 - W));
+			const __m128i Round = _mm_set1_epi16(128);
+			for (; i + 16 <= Count; i += 16)
+			{
+				const __m128i T = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Top + i));
+				const __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Bottom + i));
+				// Max sum is 255 * 256 + 128, which still fits an unsigned 16-bit lane
+				__m128i Lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(T, Zero), WTop),
+				                           _mm_mullo_epi16(_mm_unpacklo_epi8(B, Zero), WBot));
+				__m128i Hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(T, Zero), WTop),
+				                           _mm_mullo_epi16(_mm_unpackhi_epi8(B, Zero), WBot));
+				Lo = _mm_srli_epi16(_mm_add_epi16(Lo, Round), 8);
+				Hi = _mm_srli_epi16(_mm_add_epi16(Hi, Round), 8);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + i), _mm_packus_epi16(Lo, Hi));
+			}
+		}
+#elif PERCEPTION_RESAMPLE_NEON
+		{
+			// Weights of exactly 256 don't fit a byte lane; BlendRows is never called with W == 0
+			const uint8x8_t WBot = vdup_n_u8(static_cast<uint8>(W));
+			const uint8x8_t WTop = vdup_n_u8(static_cast<uint8>(256 - W));
+			for (; i + 16 <= Count; i += 16)
+			{
+				const uint8x16_t T = vld1q_u8(Top + i);
+				const uint8x16_t B = vld1q_u8(Bottom + i);
+				uint16x8_t Lo = vmull_u8(vget_low_u8(T), WTop);
+				Lo = vmlal_u8(Lo, vget_low_u8(B), WBot);
+				uint16x8_t Hi = vmull_u8(vget_high_u8(T), WTop);
+				Hi = vmlal_u8(Hi, vget_high_u8(B), WBot);
+				vst1q_u8(Out + i, vcombine_u8(vrshrn_n_u16(Lo, 8), vrshrn_n_u16(Hi, 8)));
+			}
+		}
+#endif
+
+		BlendRowsScalar(Top + i, Bottom + i, Out + i, Count - i, W);
+	}
+
+	/** Horizontal pass: one output pixel per column from scratch[Offset] and scratch[Offset + 1]. */
+	static void BlendColumns(const FColor* Scratch, FColor* Out, int32 Count,
+	                         const int32* Offsets, const uint16* Weights)
+	{
+#if PERCEPTION_RESAMPLE_SSE2
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i Round = _mm_set1_epi16(128);
+		const __m128i Opaque = _mm_set1_epi32(static_cast<int32>(0xFF000000u));
+		for (int32 X = 0; X < Count; ++X)
+		{
+			// Two adjacent source pixels -> 8 x u16 [left BGRA, right BGRA]
+			const __m128i Pair = _mm_unpacklo_epi8(
+				_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Scratch + Offsets[X])), Zero);
+			const __m128i W = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Weights + X * 8));
+			__m128i Sum = _mm_mullo_epi16(Pair, W);
+			Sum = _mm_add_epi16(Sum, _mm_srli_si128(Sum, 8));
+			Sum = _mm_srli_epi16(_mm_add_epi16(Sum, Round), 8);
+			const __m128i Packed = _mm_or_si128(_mm_packus_epi16(Sum, Zero), Opaque);
+			Out[X] = FColor(static_cast<uint32>(_mm_cvtsi128_si32(Packed)));
+		}
+#elif PERCEPTION_RESAMPLE_NEON
+		for (int32 X = 0; X < Count; ++X)
+		{
+			const uint16x8_t Pair = vmovl_u8(vld1_u8(reinterpret_cast<const uint8*>(Scratch + Offsets[X])));
+			const uint16x8_t Prod = vmulq_u16(Pair, vld1q_u16(Weights + X * 8));
+			const uint16x4_t Sum = vadd_u16(vget_low_u16(Prod), vget_high_u16(Prod));
+			const uint8x8_t Narrow = vrshrn_n_u16(vcombine_u16(Sum, Sum), 8);
+			FColor Pixel(vget_lane_u32(vreinterpret_u32_u8(Narrow), 0));
+			Pixel.A = 255;
+			Out[X] = Pixel;
+		}
+#else
+		for (int32 X = 0; X < Count; ++X)
+		{
+			const FColor& L = Scratch[Offsets[X]];
+			const FColor& R = Scratch[Offsets[X] + 1];
+			const uint32 InvW = Weights[X * 8];
+			const uint32 W = Weights[X * 8 + 4];
+			Out[X] = FColor(
+				static_cast<uint8>((L.R * InvW + R.R * W + 128) >> 8),
+				static_cast<uint8>((L.G * InvW + R.G * W + 128) >> 8),
+				static_cast<uint8>((L.B * InvW + R.B * W + 128) >> 8),
+				255);
+		}
+#endif
+	}
+
+	/** Average 2x2 blocks of two source rows into one output row: (a + b + c + d + 2) >> 2 per channel.
+	 *  Alpha is forced opaque, matching the resampler output. */
+	static void HalveRowScalar(const FColor* Row0, const FColor* Row1, FColor* Out, int32 Count)
+	{
+		const uint8* A = reinterpret_cast<const uint8*>(Row0);
+		const uint8* B = reinterpret_cast<const uint8*>(Row1);
+		uint8* Dst = reinterpret_cast<uint8*>(Out);
+		for (int32 X = 0; X < Count; ++X)
+		{
+			for (int32 C = 0; C < 3; ++C)
+			{
+				const int32 S = X * 8 + C;
+				Dst[X * 4 + C] = static_cast<uint8>((A[S] + A[S + 4] + B[S] + B[S + 4] + 2) >> 2);
+			}
+			Dst[X * 4 + 3] = 255;
+		}
+	}
+
+	static void HalveRow(const FColor* Row0, const FColor* Row1, FColor* Out, int32 Count)
+	{
+		int32 X = 0;
+
+#if PERCEPTION_RESAMPLE_SSE2
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i Round = _mm_set1_epi16(2);
+			const __m128i Opaque = _mm_set1_epi32(static_cast<int32>(0xFF000000u));
+			for (; X + 4 <= Count; X += 4)
+			{
+				// 8 source pixels per row -> 4 output pixels
+				const __m128i* P0 = reinterpret_cast<const __m128i*>(Row0 + X * 2);
+				const __m128i* P1 = reinterpret_cast<const __m128i*>(Row1 + X * 2);
+				const __m128i A0 = _mm_loadu_si128(P0), A1 = _mm_loadu_si128(P0 + 1);
+				const __m128i B0 = _mm_loadu_si128(P1), B1 = _mm_loadu_si128(P1 + 1);
+
+				// Vertical sums as u16: [p0 p1] [p2 p3] [p4 p5] [p6 p7]
+				const __m128i S01 = _mm_add_epi16(_mm_unpacklo_epi8(A0, Zero), _mm_unpacklo_epi8(B0, Zero));
+				const __m128i S23 = _mm_add_epi16(_mm_unpackhi_epi8(A0, Zero), _mm_unpackhi_epi8(B0, Zero));
+				const __m128i S45 = _mm_add_epi16(_mm_unpacklo_epi8(A1, Zero), _mm_unpacklo_epi8(B1, Zero));
+				const __m128i S67 = _mm_add_epi16(_mm_unpackhi_epi8(A1, Zero), _mm_unpackhi_epi8(B1, Zero));
+
+				// Horizontal sums: even pixels + odd pixels
+				__m128i Lo = _mm_add_epi16(_mm_unpacklo_epi64(S01, S23), _mm_unpackhi_epi64(S01, S23));
+				__m128i Hi = _mm_add_epi16(_mm_unpacklo_epi64(S45, S67), _mm_unpackhi_epi64(S45, S67));
+				Lo = _mm_srli_epi16(_mm_add_epi16(Lo, Round), 2);
+				Hi = _mm_srli_epi16(_mm_add_epi16(Hi, Round), 2);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + X), _mm_or_si128(_mm_packus_epi16(Lo, Hi), Opaque));
+			}
+		}
+#elif PERCEPTION_RESAMPLE_NEON
+		const uint8x16_t Opaque = vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000u));
+		for (; X + 4 <= Count; X += 4)
+		{
+			// De-interleave even and odd pixels of both rows
+			const uint32x4x2_t A = vld2q_u32(reinterpret_cast<const uint32*>(Row0 + X * 2));
+			const uint32x4x2_t B = vld2q_u32(reinterpret_cast<const uint32*>(Row1 + X * 2));
+			const uint8x16_t AE = vreinterpretq_u8_u32(A.val[0]), AO = vreinterpretq_u8_u32(A.val[1]);
+			const uint8x16_t BE = vreinterpretq_u8_u32(B.val[0]), BO = vreinterpretq_u8_u32(B.val[1]);
+			const uint16x8_t Lo = vaddq_u16(vaddl_u8(vget_low_u8(AE), vget_low_u8(AO)),
+			                                vaddl_u8(vget_low_u8(BE), vget_low_u8(BO)));
+			const uint16x8_t Hi = vaddq_u16(vaddl_u8(vget_high_u8(AE), vget_high_u8(AO)),
+			                                vaddl_u8(vget_high_u8(BE), vget_high_u8(BO)));
+			const uint8x16_t Packed = vcombine_u8(vrshrn_n_u16(Lo, 2), vrshrn_n_u16(Hi, 2));
+			vst1q_u8(reinterpret_cast<uint8*>(Out + X), vorrq_u8(Packed, Opaque));
+		}
+#endif
+
+		HalveRowScalar(Row0 + X * 2, Row1 + X * 2, Out + X, Count - X);
+	}
+}
+
+
+FPerceptionResampler::FPerceptionResampler(FIntPoint InSourceSize, FIntPoint InTargetSize)
+	: SourceSize(InSourceSize)
+	, TargetSize(InTargetSize)
+{
+	check(SourceSize.X > 0 && SourceSize.Y > 0 && TargetSize.X > 0 && TargetSize.Y > 0);
+
+	// Pixel-center aligned mapping, same as the original float resize
+	const float ScaleX = static_cast<float>(SourceSize.X) / static_cast<float>(TargetSize.X);
+	const float ScaleY = static_cast<float>(SourceSize.Y) / static_cast<float>(TargetSize.Y);
+
+	ColumnOffsets.SetNumUninitialized(TargetSize.X);
+	ColumnWeights.SetNumUninitialized(TargetSize.X * 8);
+	for (int32 X = 0; X < TargetSize.X; ++X)
+	{
+		uint16 Weight;
+		PerceptionResample::MakeTap((X + 0.5f) * ScaleX - 0.5f, SourceSize.X, ColumnOffsets[X], Weight);
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			ColumnWeights[X * 8 + Lane] = static_cast<uint16>(WeightOne - Weight);
+			ColumnWeights[X * 8 + 4 + Lane] = Weight;
+		}
+	}
+
+	RowTop.SetNumUninitialized(TargetSize.Y);
+	RowBottom.SetNumUninitialized(TargetSize.Y);
+	RowWeights.SetNumUninitialized(TargetSize.Y);
+	for (int32 Y = 0; Y < TargetSize.Y; ++Y)
+	{
+		PerceptionResample::MakeTap((Y + 0.5f) * ScaleY - 0.5f, SourceSize.Y, RowTop[Y], RowWeights[Y]);
+		RowBottom[Y] = FMath::Min(RowTop[Y] + 1, SourceSize.Y - 1);
+	}
+}
+
+void FPerceptionResampler::ResampleRows(const FColor* Source, FColor* Dest, int32 RowBegin, int32 RowEnd) const
+{
+	const int32 SrcW = SourceSize.X;
+	const int32 DstW = TargetSize.X;
+
+	// One spare pixel so the right tap of the last column never reads past the row
+	TArray<FColor> Scratch;
+	Scratch.SetNumUninitialized(SrcW + 1);
+
+	int32 CachedTop = INDEX_NONE;
+	uint16 CachedWeight = 0;
+
+	for (int32 Y = FMath::Max(RowBegin, 0); Y < FMath::Min(RowEnd, TargetSize.Y); ++Y)
+	{
+		const int32 Top = RowTop[Y];
+		const uint16 Weight = RowWeights[Y];
+
+		// Consecutive rows often map to the same blend when upscaling
+		if (Top != CachedTop || Weight != CachedWeight)
+		{
+			const FColor* TopRow = Source + static_cast<int64>(Top) * SrcW;
+			if (Weight == 0)
+			{
+				FMemory::Memcpy(Scratch.GetData(), TopRow, SrcW * sizeof(FColor));
+			}
+			else
+			{
+				const FColor* BottomRow = Source + static_cast<int64>(RowBottom[Y]) * SrcW;
+				PerceptionResample::BlendRows(reinterpret_cast<const uint8*>(TopRow),
+				                              reinterpret_cast<const uint8*>(BottomRow),
+				                              reinterpret_cast<uint8*>(Scratch.GetData()),
+				                              SrcW * static_cast<int32>(sizeof(FColor)), Weight);
+			}
+			Scratch[SrcW] = Scratch[SrcW - 1];
+			CachedTop = Top;
+			CachedWeight = Weight;
+		}
+
+		PerceptionResample::BlendColumns(Scratch.GetData(), Dest + static_cast<int64>(Y) * DstW, DstW,
+		                                 ColumnOffsets.GetData(), ColumnWeights.GetData());
+	}
+}
+
+int32 FPerceptionResampler::GetHalvingSteps(FIntPoint SourceSize, FIntPoint TargetSize)
+{
+	if (TargetSize.X <= 0 || TargetSize.Y <= 0)
+	{
+		return 0;
+	}
+
+	int32 Steps = 0;
+	while (SourceSize.X >= TargetSize.X * 2 && SourceSize.Y >= TargetSize.Y * 2)
+	{
+		SourceSize = GetHalvedSize(SourceSize);
+		++Steps;
+	}
+	return Steps;
+}
+
+void FPerceptionResampler::HalveRows(const FColor* Source, int32 SourceWidth, FColor* Dest, FIntPoint DestSize,
+                                     int32 RowBegin, int32 RowEnd)
+{
+	check(SourceWidth >= DestSize.X * 2);
+
+	for (int32 Y = FMath::Max(RowBegin, 0); Y < FMath::Min(RowEnd, DestSize.Y); ++Y)
+	{
+		const FColor* Row0 = Source + static_cast<int64>(Y) * 2 * SourceWidth;
+		PerceptionResample::HalveRow(Row0, Row0 + SourceWidth, Dest + static_cast<int64>(Y) * DestSize.X, DestSize.X);
+	}
+}
+
+const TCHAR* FPerceptionResampler::GetKernelName()
+{
+#if PERCEPTION_RESAMPLE_AVX2
+	return TEXT("AVX2");
+#elif PERCEPTION_RESAMPLE_SSE2
+	return TEXT("SSE2");
+#elif PERCEPTION_RESAMPLE_NEON
+	return TEXT("NEON");
+#else
+	return TEXT("Scalar");
+#endif
+}
@@ -0,0 +1,60 @@
+// PerceptionResampler.h
+// Fixed-point bilinear resampler used by FPerceptionAdapter::Resize.
+//
+// Tables are built once per source/target size pair: every destination column
+// gets its left source column and an 8.8 fixed-point weight, every destination
+// row its two source rows and weight. Each output row is then produced in two
+// passes: a vertical blend of the two source rows into a scratch row
+// (SSE2/AVX2/NEON, scalar fallback) and a horizontal blend through the column
+// table. All paths use the same integer math, so results are bit-identical.
+//
+// Large reductions first go through HalveRows, a 2x2 box average, until the
+// image is within 2x of the target. Bilinear alone only reads four pixels per
+// output and skips the rest, which aliases once the ratio passes 2x.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FPerceptionResampler
+{
+public:
+	FPerceptionResampler(FIntPoint InSourceSize, FIntPoint InTargetSize);
+
+	/** Resample destination rows [RowBegin, RowEnd). Safe to call concurrently on disjoint ranges. */
+	void ResampleRows(const FColor* Source, FColor* Dest, int32 RowBegin, int32 RowEnd) const;
+
+	/** Number of 2x2 halvings to apply before resampling: halve while both axes are at least 2x the target. */
+	static int32 GetHalvingSteps(FIntPoint SourceSize, FIntPoint TargetSize);
+
+	/** Size after one halving. Odd trailing columns/rows are dropped. */
+	static FIntPoint GetHalvedSize(FIntPoint Size) { return FIntPoint(Size.X / 2, Size.Y / 2); }
+
+	/** Box-average destination rows [RowBegin, RowEnd) of a halving from a SourceWidth-wide image. */
+	static void HalveRows(const FColor* Source, int32 SourceWidth, FColor* Dest, FIntPoint DestSize,
+	                      int32 RowBegin, int32 RowEnd);
+
+	FIntPoint GetSourceSize() const { return SourceSize; }
+	FIntPoint GetTargetSize() const { return TargetSize; }
+
+	/** Name of the vector path compiled into this build ("AVX2", "SSE2", "NEON" or "Scalar"). */
+	static const TCHAR* GetKernelName();
+
+private:
+	/** Weight scale for 8.8 fixed point */
+	static constexpr int32 WeightOne = 256;
+
+	FIntPoint SourceSize;
+	FIntPoint TargetSize;
+
+	/** Left source column per destination column; the right one is always +1 (scratch row is padded). */
+	TArray<int32> ColumnOffsets;
+
+	/** Per destination column: 4x (256 - W) then 4x W, laid out for one 128-bit multiply. */
+	TArray<uint16> ColumnWeights;
+
+	/** Top source row, bottom source row and bottom-row weight per destination row. */
+	TArray<int32> RowTop;
+	TArray<int32> RowBottom;
+	TArray<uint16> RowWeights;
+};
@@ -0,0 +1,221 @@
+// PerceptionSharedMemory.cpp
+
+#include "PerceptionSharedMemory.h"
+#include "PerceptionAdapter.h"
+#include "ViewportPerceptionModule.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+
+FString FPerceptionSharedMemory::GetDefaultName()
+{
+	return FString::Printf(TEXT("ViewportPerception_%u"), FPlatformProcess::GetCurrentProcessId());
+}
+
+FIntPoint FPerceptionSharedMemory::FitSize(FIntPoint Source, FIntPoint MaxSize)
+{
+	if (Source.X <= MaxSize.X && Source.Y <= MaxSize.Y)
+	{
+		return Source;
+	}
+
+	const double Scale = FMath::Min(static_cast<double>(MaxSize.X) / Source.X, static_cast<double>(MaxSize.Y) / Source.Y);
+	return FIntPoint(
+		FMath::Clamp(FMath::FloorToInt32(Source.X * Scale), 1, MaxSize.X),
+		FMath::Clamp(FMath::FloorToInt32(Source.Y * Scale), 1, MaxSize.Y));
+}
+
+TUniquePtr<FPerceptionSharedMemory> FPerceptionSharedMemory::Create(const FString& InName, int32 InSlotCount, FIntPoint InMaxSize)
+{
+	const int32 Slots = FMath::Clamp(InSlotCount, 2, 16);
+	const FIntPoint Max(FMath::Clamp(InMaxSize.X, 1, 8192), FMath::Clamp(InMaxSize.Y, 1, 8192));
+	const int64 Stride = Align(static_cast<int64>(sizeof(FPerceptionSharedSlot)) + static_cast<int64>(Max.X) * Max.Y * sizeof(FColor), 64);
+	const int64 TotalBytes = sizeof(FPerceptionSharedHeader) + Slots * Stride;
+
+	if (Stride > MAX_int32)
+	{
+		return nullptr;
+	}
+
+	FPlatformMemory::FSharedMemoryRegion* Region = FPlatformMemory::MapNamedSharedMemoryRegion(
+		InName, true,
+		static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Read) | static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Write),
+		TotalBytes);
+
+	if (!Region)
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to map shared memory '%s' (%lld bytes)"), *InName, TotalBytes);
+		return nullptr;
+	}
+
+	TUniquePtr<FPerceptionSharedMemory> Export(new FPerceptionSharedMemory());
+	Export->Region = Region;
+	Export->Header = static_cast<FPerceptionSharedHeader*>(Region->GetAddress());
+	Export->Name = InName;
+	Export->SlotCount = Slots;
+	Export->SlotStride = static_cast<int32>(Stride);
+	Export->MaxSize = Max;
+	Export->SlotSequences.SetNumZeroed(Slots);
+	Export->IdleEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	Export->IdleEvent->Trigger();
+
+	// Slot headers first, the magic last: a reader that sees the magic sees a valid layout
+	FMemory::Memzero(Region->GetAddress(), sizeof(FPerceptionSharedHeader));
+	for (int32 i = 0; i < Slots; ++i)
+	{
+		FMemory::Memzero(static_cast<uint8*>(Region->GetAddress()) + sizeof(FPerceptionSharedHeader) + i * Stride,
+		                 sizeof(FPerceptionSharedSlot));
+	}
+
+	FPerceptionSharedHeader* Header = Export->Header;
+	Header->Version = FPerceptionSharedHeader::CurrentVersion;
+	Header->HeaderSize = sizeof(FPerceptionSharedHeader);
+	Header->SlotCount = Slots;
+	Header->SlotStride = static_cast<uint32>(Stride);
+	Header->MaxWidth = Max.X;
+	Header->MaxHeight = Max.Y;
+	Header->PixelFormat = 0;
+	Header->LatestSlot = INDEX_NONE;
+	FPlatformMisc::MemoryBarrier();
+	Header->Magic = FPerceptionSharedHeader::MagicValue;
+
+	UE_LOG(LogViewportPerception, Log, TEXT("Shared memory '%s': %d slots up to %dx%d, %lld bytes"),
+		*InName, Slots, Max.X, Max.Y, TotalBytes);
+
+	return Export;
+}
+
+FPerceptionSharedMemory::~FPerceptionSharedMemory()
+{
+	{
+		FScopeLock Lock(&PendingLock);
+		Pending.Reset();
+	}
+
+	if (IdleEvent)
+	{
+		IdleEvent->Wait();
+
+		// The worker signals while holding the lock; let it leave before members go away
+		{
+			FScopeLock Lock(&PendingLock);
+		}
+
+		FPlatformProcess::ReturnSynchEventToPool(IdleEvent);
+		IdleEvent = nullptr;
+	}
+
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+	}
+}
+
+void FPerceptionSharedMemory::Submit(const FPerceptionFrameRef& Frame)
+{
+	{
+		FScopeLock Lock(&PendingLock);
+		if (Pending.IsValid())
+		{
+			FramesSkipped.IncrementExchange();
+		}
+		Pending = Frame;
+
+		if (bDraining)
+		{
+			return;
+		}
+		bDraining = true;
+		IdleEvent->Reset();
+	}
+
+	Async(EAsyncExecution::ThreadPool, [this]()
+	{
+		Drain();
+	});
+}
+
+void FPerceptionSharedMemory::Drain()
+{
+	for (;;)
+	{
+		FPerceptionFrameRef Frame;
+		{
+			FScopeLock Lock(&PendingLock);
+			Frame = MoveTemp(Pending);
+			if (!Frame.IsValid())
+			{
+				// Signalled under the lock so a Submit racing with us can't be mistaken for idle
+				bDraining = false;
+				IdleEvent->Trigger();
+				return;
+			}
+		}
+
+		WriteSlot(*Frame);
+	}
+}
+
+void FPerceptionSharedMemory::WriteSlot(const FPerceptionFrame& Frame)
+{
+	if (Frame.Size.X <= 0 || Frame.Size.Y <= 0 || Frame.Pixels.Num() != Frame.Size.X * Frame.Size.Y)
+	{
+		return;
+	}
+
+	const FIntPoint Size = FitSize(Frame.Size, MaxSize);
+	const TArray<FColor>* Pixels = &Frame.Pixels;
+	if (Size != Frame.Size)
+	{
+		Scratch = FPerceptionAdapter::Resize(Frame.Pixels, Frame.Size, Size);
+		Pixels = &Scratch;
+	}
+
+	if (Pixels->Num() != Size.X * Size.Y)
+	{
+		return;
+	}
+
+	// Readers can write the mapping too, so nothing in it is read back here: the layout and the
+	// sequence come from our own copies, and a tampered header can't steer writes outside the region
+	uint8* SlotBase = reinterpret_cast<uint8*>(Header) + sizeof(FPerceptionSharedHeader) + static_cast<int64>(NextSlot) * SlotStride;
+	FPerceptionSharedSlot* Slot = reinterpret_cast<FPerceptionSharedSlot*>(SlotBase);
+
+	const int64 Sequence = SlotSequences[NextSlot];
+	SlotSequences[NextSlot] = Sequence + 2;
+	FPlatformAtomics::AtomicStore(&Slot->Sequence, Sequence + 1);
+	FPlatformMisc::MemoryBarrier();
+
+	Slot->FrameNumber = Frame.FrameNumber;
+	Slot->Timestamp = Frame.Timestamp;
+	Slot->Width = Size.X;
+	Slot->Height = Size.Y;
+	Slot->RowPitch = Size.X * sizeof(FColor);
+	Slot->SourceWidth = Frame.Size.X;
+	Slot->SourceHeight = Frame.Size.Y;
+	FMemory::Memcpy(SlotBase + sizeof(FPerceptionSharedSlot), Pixels->GetData(), Pixels->Num() * sizeof(FColor));
+
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::AtomicStore(&Slot->Sequence, Sequence + 2);
+
+	FPlatformAtomics::AtomicStore(&Header->LatestSlot, NextSlot);
+	FPlatformAtomics::AtomicStore(&Header->LatestFrame, Frame.FrameNumber);
+	FPlatformAtomics::InterlockedIncrement(&Header->WriteCount);
+
+	NextSlot = (NextSlot + 1) % SlotCount;
+	FramesWritten.IncrementExchange();
+}
+
+FPerceptionSharedMemoryInfo FPerceptionSharedMemory::GetInfo() const
+{
+	FPerceptionSharedMemoryInfo Info;
+	Info.Name = Name;
+	Info.TotalBytes = sizeof(FPerceptionSharedHeader) + static_cast<int64>(SlotCount) * SlotStride;
+	Info.SlotCount = SlotCount;
+	Info.SlotStride = SlotStride;
+	Info.MaxSize = MaxSize;
+	Info.FramesWritten = FramesWritten.Load();
+	Info.FramesSkipped = FramesSkipped.Load();
+	return Info;
+}
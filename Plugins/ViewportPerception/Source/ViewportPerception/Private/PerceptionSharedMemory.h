@@ -0,0 +1,126 @@
+// PerceptionSharedMemory.h
+// Mirrors published frames into a named, memory-mapped ring so consumers on the
+// same host can read raw pixels without encode, HTTP or decode.
+//
+// Layout (little-endian, no padding beyond what is listed):
+//   FPerceptionSharedHeader                       at offset 0, HeaderSize bytes
+//   SlotCount x { FPerceptionSharedSlot, pixels } at HeaderSize + i * SlotStride
+// Pixels are BGRA8 rows of RowPitch bytes, at most MaxWidth x MaxHeight; larger
+// frames are downscaled to fit, keeping the aspect ratio.
+//
+// Each slot is sequence-locked: the writer makes Sequence odd, writes the slot,
+// then makes it even again and publishes the slot index and frame number in the
+// header. A reader loads Sequence (retry if odd), reads the slot in place, then
+// loads Sequence again; the read is valid if it did not change. The writer
+// cycles through the slots, so a reader has SlotCount - 1 frames' time to read
+// before the slot is reused.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+#include "PerceptionFrame.h"
+
+class FEvent;
+
+/** Shared-memory header. Fields up to PixelFormat are written once, before Magic. */
+struct FPerceptionSharedHeader
+{
+	static constexpr uint32 MagicValue = 0x4D535056;  // "VPSM"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic;
+	uint32 Version;
+	uint32 HeaderSize;
+	uint32 SlotCount;
+	uint32 SlotStride;
+	uint32 MaxWidth;
+	uint32 MaxHeight;
+	uint32 PixelFormat;       // 0 = BGRA8
+
+	volatile int64 LatestFrame;   // 0 until the first frame
+	volatile int32 LatestSlot;    // -1 until the first frame
+	uint32 Reserved0;
+	volatile int64 WriteCount;
+	uint8 Reserved1[16];
+};
+static_assert(sizeof(FPerceptionSharedHeader) == 64, "Shared-memory header layout changed");
+
+/** Per-slot header, followed directly by the pixels. */
+struct FPerceptionSharedSlot
+{
+	volatile int64 Sequence;  // Odd while the writer is in the slot
+	int64 FrameNumber;
+	double Timestamp;         // Platform seconds at capture
+	uint32 Width;
+	uint32 Height;
+	uint32 RowPitch;          // Bytes per pixel row
+	uint32 SourceWidth;       // Captured size before downscaling
+	uint32 SourceHeight;
+	uint8 Reserved[20];
+};
+static_assert(sizeof(FPerceptionSharedSlot) == 64, "Shared-memory slot layout changed");
+
+/** What a consumer needs to open and read the mapping. */
+struct FPerceptionSharedMemoryInfo
+{
+	FString Name;
+	int64 TotalBytes = 0;
+	int32 SlotCount = 0;
+	int32 SlotStride = 0;
+	FIntPoint MaxSize = FIntPoint::ZeroValue;
+	int64 FramesWritten = 0;
+	int64 FramesSkipped = 0;
+};
+
+class FPerceptionSharedMemory
+{
+public:
+	/** Name for this process's mapping, unique per editor instance. */
+	static FString GetDefaultName();
+
+	/** Create the mapping. Null if the platform refuses the region. */
+	static TUniquePtr<FPerceptionSharedMemory> Create(const FString& Name, int32 SlotCount, FIntPoint MaxSize);
+
+	/** Waits for any copy in flight, then unmaps the region. */
+	~FPerceptionSharedMemory();
+
+	/** Queue a published frame for copying on a worker. Only the newest queued frame
+	 *  is kept, so a slow copy skips frames instead of backing up the producer. */
+	void Submit(const FPerceptionFrameRef& Frame);
+
+	FPerceptionSharedMemoryInfo GetInfo() const;
+
+	/** Size a frame is stored at: Source scaled down to fit MaxSize, aspect kept. */
+	static FIntPoint FitSize(FIntPoint Source, FIntPoint MaxSize);
+
+private:
+	FPerceptionSharedMemory() = default;
+
+	/** Worker: copy queued frames until none is left. */
+	void Drain();
+
+	void WriteSlot(const FPerceptionFrame& Frame);
+
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+	FPerceptionSharedHeader* Header = nullptr;
+	FString Name;
+	int32 SlotCount = 0;
+	int32 SlotStride = 0;
+	FIntPoint MaxSize = FIntPoint::ZeroValue;
+
+	mutable FCriticalSection PendingLock;
+	FPerceptionFrameRef Pending;
+	bool bDraining = false;
+	FEvent* IdleEvent = nullptr;
+
+	// Worker only
+	int32 NextSlot = 0;
+
+	/** Last sequence written to each slot; the mapping's copy is output only */
+	TArray<int64> SlotSequences;
+	TArray<FColor> Scratch;
+
+	TAtomic<int64> FramesWritten { 0 };
+	TAtomic<int64> FramesSkipped { 0 };
+};
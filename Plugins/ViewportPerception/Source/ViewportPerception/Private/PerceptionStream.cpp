@@ -0,0 +1,488 @@
+// PerceptionStream.cpp
+
+#include "PerceptionStream.h"
+#include "PerceptionEncoder.h"
+#include "PerceptionEndpoint.h"
+#include "PerceptionReplay.h"
+#include "PixelBus.h"
+#include "ViewportPerceptionModule.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+
+namespace
+{
+	const TCHAR* const Boundary = TEXT("perceptionframe");
+
+	/** Request line and headers larger than this are refused */
+	constexpr int32 MaxRequestBytes = 8 * 1024;
+
+	/** Seconds a client may take to send its request */
+	constexpr double RequestTimeout = 5.0;
+
+	/** Seconds a streaming client may accept no bytes at all before it is dropped */
+	constexpr double StallTimeout = 10.0;
+
+	/** How long an idle sender thread waits on the listening socket; bounds Stop latency */
+	constexpr int32 IdleWaitMs = 100;
+}
+
+FPerceptionStream::FPerceptionStream(FPerceptionEncoder* InEncoder, FPixelBus* InPixelBus)
+	: Encoder(InEncoder)
+	, PixelBus(InPixelBus)
+	, bStopRequested(false)
+{
+	check(Encoder);
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FPerceptionStream::~FPerceptionStream()
+{
+	Shutdown();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FPerceptionStream::Start()
+{
+	if (Thread)
+	{
+		return;
+	}
+
+	// Loopback only, like the HTTP routes: the feed is unauthenticated. Connections are accepted
+	// by the sender thread itself, so none can arrive before there is someone to take them.
+	ListenSocket = FTcpSocketBuilder(TEXT("PerceptionStreamListener"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToEndpoint(FIPv4Endpoint(FIPv4Address::InternalLoopback, STREAM_PORT))
+		.Listening(8)
+		.Build();
+
+	if (!ListenSocket)
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to listen on port %d, streaming disabled"), STREAM_PORT);
+		return;
+	}
+
+	bStopRequested = false;
+	Thread = FRunnableThread::Create(this, TEXT("PerceptionStream"), 0, TPri_BelowNormal);
+
+	if (!Thread)
+	{
+		UE_LOG(LogViewportPerception, Warning, TEXT("Failed to create stream thread, streaming disabled"));
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+		return;
+	}
+
+	UE_LOG(LogViewportPerception, Log, TEXT("Stream listening on port %d"), STREAM_PORT);
+}
+
+void FPerceptionStream::Shutdown()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);  // Calls Stop() and waits for Run() to return
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	// Only the sender thread accepts, so nothing is left half-handed-over
+	if (ListenSocket)
+	{
+		ListenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+	}
+}
+
+FPerceptionStreamStats FPerceptionStream::GetStats() const
+{
+	FScopeLock Lock(&StatsLock);
+	return Stats;
+}
+
+void FPerceptionStream::AcceptPending(double Now)
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	bool bPending = false;
+	while (ListenSocket->HasPendingConnection(bPending) && bPending)
+	{
+		TSharedRef<FInternetAddr> RemoteAddress = SocketSubsystem->CreateInternetAddr();
+		FSocket* Socket = ListenSocket->Accept(*RemoteAddress, TEXT("PerceptionStreamClient"));
+		if (!Socket)
+		{
+			break;
+		}
+
+		FClient& Client = Clients.AddDefaulted_GetRef();
+		Client.Socket = Socket;
+		Client.Address = FIPv4Endpoint(RemoteAddress);
+		Client.ConnectTime = Now;
+		Client.Socket->SetNonBlocking(true);
+		Client.Socket->SetNoDelay(true);
+	}
+}
+
+uint32 FPerceptionStream::Run()
+{
+	while (!bStopRequested)
+	{
+		const double Now = FPlatformTime::Seconds();
+		AcceptPending(Now);
+
+		for (int32 i = Clients.Num() - 1; i >= 0; --i)
+		{
+			FClient& Client = Clients[i];
+
+			bool bKeep = Client.bStreaming || ReadRequest(Client, Now);
+			if (bKeep && Client.bStreaming)
+			{
+				QueuePacket(Client, Now);
+				bKeep = Flush(Client, Now);
+			}
+
+			if (!bKeep)
+			{
+				CloseClient(Client);
+				Clients.RemoveAtSwap(i);
+			}
+		}
+
+		{
+			FScopeLock Lock(&StatsLock);
+			Stats.Clients = Clients.Num();
+		}
+
+		// Idle on the listening socket until a connection arrives; with clients, poll often
+		// enough for pacing and partial sends. New packets are picked up on the next pass.
+		if (Clients.Num() > 0)
+		{
+			WakeEvent->Wait(5);
+		}
+		else
+		{
+			ListenSocket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(IdleWaitMs));
+		}
+	}
+
+	for (FClient& Client : Clients)
+	{
+		CloseClient(Client);
+	}
+	Clients.Reset();
+
+	FScopeLock Lock(&StatsLock);
+	Stats.Clients = 0;
+	return 0;
+}
+
+void FPerceptionStream::Stop()
+{
+	bStopRequested = true;
+	WakeEvent->Trigger();
+}
+
+bool FPerceptionStream::ReadRequest(FClient& Client, double Now)
+{
+	uint32 PendingSize = 0;
+	while (Client.Socket->HasPendingData(PendingSize) && PendingSize > 0)
+	{
+		const int32 Offset = Client.Request.Num();
+		const int32 ToRead = FMath::Min(static_cast<int32>(PendingSize), MaxRequestBytes - Offset);
+		if (ToRead <= 0)
+		{
+			return false;
+		}
+
+		int32 BytesRead = 0;
+		Client.Request.AddUninitialized(ToRead);
+		const bool bRead = Client.Socket->Recv(Client.Request.GetData() + Offset, ToRead, BytesRead);
+		Client.Request.SetNum(Offset + (bRead ? BytesRead : 0), EAllowShrinking::No);
+		if (!bRead || BytesRead == 0)
+		{
+			break;
+		}
+	}
+
+	// Wait for the blank line that ends the headers
+	int32 HeaderEnd = INDEX_NONE;
+	for (int32 i = 3; i < Client.Request.Num(); ++i)
+	{
+		if (Client.Request[i - 3] == '\r' && Client.Request[i - 2] == '\n' &&
+		    Client.Request[i - 1] == '\r' && Client.Request[i] == '\n')
+		{
+			HeaderEnd = i + 1;
+			break;
+		}
+	}
+
+	if (HeaderEnd == INDEX_NONE)
+	{
+		return (Now - Client.ConnectTime) < RequestTimeout;
+	}
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Client.Request.GetData()), HeaderEnd);
+	const FString Head(Converted.Length(), Converted.Get());
+	Client.Request.Empty();
+
+	// "GET /perception/stream?fps=5 HTTP/1.1"
+	FString RequestLine;
+	Head.Split(TEXT("\r\n"), &RequestLine, nullptr);
+	TArray<FString> Parts;
+	RequestLine.ParseIntoArray(Parts, TEXT(" "));
+
+	FString Path = (Parts.Num() >= 2) ? Parts[1] : FString();
+	FString Query;
+	Path.Split(TEXT("?"), &Path, &Query);
+
+	if (Parts.Num() < 2 || Parts[0] != TEXT("GET") || Path != TEXT("/perception/stream"))
+	{
+		AppendUtf8(Client.Outgoing, TEXT("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"));
+		Flush(Client, Now);
+		return false;
+	}
+
+	TArray<FString> Params;
+	Query.ParseIntoArray(Params, TEXT("&"));
+	for (const FString& Param : Params)
+	{
+		FString Key, Value;
+		if (!Param.Split(TEXT("="), &Key, &Value))
+		{
+			continue;
+		}
+
+		if (Key == TEXT("fps"))
+		{
+			const float FPS = FCString::Atof(*Value);
+			Client.MinInterval = (FPS > 0.0f) ? 1.0 / FMath::Clamp(FPS, 0.1f, 60.0f) : 0.0;
+		}
+		else if (Key == TEXT("metadata"))
+		{
+			Client.bMetadataPart = (Value == TEXT("part"));
+		}
+	}
+
+	AppendUtf8(Client.Outgoing, FString::Printf(
+		TEXT("HTTP/1.1 200 OK\r\n")
+		TEXT("Content-Type: multipart/x-mixed-replace; boundary=%s\r\n")
+		TEXT("Cache-Control: no-cache, no-store\r\n")
+		TEXT("Pragma: no-cache\r\n")
+		TEXT("Connection: close\r\n\r\n"), Boundary));
+	Client.LastProgressTime = Now;
+	Client.bStreaming = true;
+
+	UE_LOG(LogViewportPerception, Log, TEXT("Stream client %s connected (%s)"),
+		*Client.Address.ToString(), *RequestLine);
+	return true;
+}
+
+void FPerceptionStream::SetReplay(TSharedPtr<FPerceptionReplay, ESPMode::ThreadSafe> InReplay)
+{
+	{
+		FScopeLock ScopeLock(&ReplayLock);
+		Replay = MoveTemp(InReplay);
+		++SourceVersion;
+	}
+	WakeEvent->Trigger();
+}
+
+void FPerceptionStream::QueuePacket(FClient& Client, double Now)
+{
+	TSharedPtr<FPerceptionReplay, ESPMode::ThreadSafe> ActiveReplay;
+	int32 Version;
+	{
+		FScopeLock ScopeLock(&ReplayLock);
+		ActiveReplay = Replay;
+		Version = SourceVersion;
+	}
+
+	// Frame numbers of a recording and of the live viewport don't compare
+	if (Client.SourceVersion != Version)
+	{
+		Client.SourceVersion = Version;
+		Client.LastSentFrame = 0;
+		Client.LastBusyFrame = 0;
+		Client.BusyFramesSeen = 0;
+	}
+
+	TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> Latest;
+	int64 FrameNumber = 0;
+	if (ActiveReplay.IsValid())
+	{
+		FrameNumber = ActiveReplay->GetCurrentFrameNumber();
+	}
+	else
+	{
+		Latest = Encoder->GetLatest();
+		FrameNumber = Latest.IsValid() ? Latest->Packet.FrameNumber : 0;
+	}
+
+	if (FrameNumber <= 0)
+	{
+		return;
+	}
+
+	// Each packet goes out at most once
+	if (FrameNumber <= Client.LastSentFrame)
+	{
+		return;
+	}
+
+	// Never queue behind unsent bytes; remember what went by instead
+	if (Client.OutgoingOffset < Client.Outgoing.Num())
+	{
+		if (FrameNumber > Client.LastBusyFrame)
+		{
+			Client.LastBusyFrame = FrameNumber;
+			++Client.BusyFramesSeen;
+		}
+		return;
+	}
+
+	if (Now < Client.NextSendTime)
+	{
+		return;
+	}
+
+	// Only now that it is due: a replayed packet may have to come off the disk (read ahead, normally)
+	FPerceptionPacket Replayed;
+	if (ActiveReplay.IsValid() && (!ActiveReplay->GetCurrentPacket(Replayed) || Replayed.FrameNumber != FrameNumber))
+	{
+		return;
+	}
+	const FPerceptionPacket& Packet = ActiveReplay.IsValid() ? Replayed : Latest->Packet;
+
+	// Metadata is attached on the game tick and may have arrived after the encode; recordings keep their own
+	FPerceptionMetadata Fresh;
+	int64 MetaFrame = 0;
+	const bool bFresh = !ActiveReplay.IsValid() && PixelBus && PixelBus->ReadLatestMetadata(Fresh, MetaFrame)
+		&& MetaFrame == FrameNumber;
+	if (bFresh)
+	{
+		// Image stats and motion come from the encode, not the bus
+		Fresh.CopyEncodeResults(Packet.Metadata);
+	}
+	const FPerceptionMetadata& Metadata = bFresh ? Fresh : Packet.Metadata;
+
+	Client.Outgoing.Reset();
+	Client.OutgoingOffset = 0;
+
+	if (Client.bMetadataPart)
+	{
+		// A part body has no size limit; it carries the full object
+		const FTCHARToUTF8 Json(*FPerceptionEndpoint::MetadataToJson(Metadata));
+		AppendUtf8(Client.Outgoing, FString::Printf(
+			TEXT("--%s\r\nContent-Type: application/json\r\nContent-Length: %d\r\nX-Perception-Frame: %lld\r\n\r\n"),
+			Boundary, Json.Length(), FrameNumber));
+		Client.Outgoing.Append(reinterpret_cast<const uint8*>(Json.Get()), Json.Length());
+		AppendUtf8(Client.Outgoing, TEXT("\r\n"));
+	}
+
+	const bool bPNG = (Packet.Format == EPerceptionImageFormat::PNG);
+	FString PartHeader = FString::Printf(
+		TEXT("--%s\r\nContent-Type: %s\r\nContent-Length: %d\r\n")
+		TEXT("X-Perception-Frame: %lld\r\nX-Perception-Timestamp: %.6f\r\n")
+		TEXT("X-Perception-Width: %d\r\nX-Perception-Height: %d\r\n"),
+		Boundary, bPNG ? TEXT("image/png") : TEXT("image/jpeg"), Packet.ImageData.Num(),
+		FrameNumber, Packet.Timestamp, Packet.Width, Packet.Height);
+	if (!Client.bMetadataPart)
+	{
+		// Capped as on /perception/frame.bin; metadata=part gets the rest
+		bool bTruncated = false;
+		const FString MetadataJson = FPerceptionEndpoint::MetadataToHeaderJson(Metadata, bTruncated);
+		if (bTruncated)
+		{
+			PartHeader += TEXT("X-Perception-Metadata-Truncated: 1\r\n");
+		}
+		PartHeader += FString::Printf(TEXT("X-Perception-Metadata: %s\r\n"), *MetadataJson);
+	}
+	PartHeader += TEXT("\r\n");
+
+	AppendUtf8(Client.Outgoing, PartHeader);
+	Client.Outgoing.Append(Packet.ImageData);
+	AppendUtf8(Client.Outgoing, TEXT("\r\n"));
+
+	// Packets seen while busy and superseded by this one never went out
+	const int32 Dropped = Client.BusyFramesSeen - (Client.LastBusyFrame == FrameNumber ? 1 : 0);
+	Client.BusyFramesSeen = 0;
+	Client.LastSentFrame = FrameNumber;
+	Client.NextSendTime = Now + Client.MinInterval;
+	Client.LastProgressTime = Now;
+
+	FScopeLock Lock(&StatsLock);
+	++Stats.FramesSent;
+	Stats.FramesDropped += Dropped;
+}
+
+bool FPerceptionStream::Flush(FClient& Client, double Now)
+{
+	int64 Sent = 0;
+
+	while (Client.OutgoingOffset < Client.Outgoing.Num())
+	{
+		int32 BytesSent = 0;
+		const bool bSent = Client.Socket->Send(Client.Outgoing.GetData() + Client.OutgoingOffset,
+		                                      Client.Outgoing.Num() - Client.OutgoingOffset, BytesSent);
+		if (!bSent)
+		{
+			const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+			if (Error != SE_EWOULDBLOCK && Error != SE_NO_ERROR)
+			{
+				return false;  // Client went away
+			}
+			break;
+		}
+
+		if (BytesSent <= 0)
+		{
+			break;
+		}
+
+		Client.OutgoingOffset += BytesSent;
+		Client.LastProgressTime = Now;
+		Sent += BytesSent;
+	}
+
+	if (Sent > 0)
+	{
+		FScopeLock Lock(&StatsLock);
+		Stats.BytesSent += Sent;
+	}
+
+	if (Client.OutgoingOffset >= Client.Outgoing.Num())
+	{
+		Client.Outgoing.Reset();
+		Client.OutgoingOffset = 0;
+		return true;
+	}
+
+	return (Now - Client.LastProgressTime) < StallTimeout;
+}
+
+void FPerceptionStream::CloseClient(FClient& Client)
+{
+	if (Client.Socket)
+	{
+		if (Client.bStreaming)
+		{
+			UE_LOG(LogViewportPerception, Log, TEXT("Stream client %s disconnected"), *Client.Address.ToString());
+		}
+
+		Client.Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Client.Socket);
+		Client.Socket = nullptr;
+	}
+}
+
+void FPerceptionStream::AppendUtf8(TArray<uint8>& Out, const FString& Text)
+{
+	const FTCHARToUTF8 Converted(*Text);
+	Out.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+}
@@ -0,0 +1,131 @@
+// PerceptionStream.h
+// Continuous perception over one long-lived HTTP response on port 30012.
+//   GET /perception/stream?fps=N&metadata=part
+// replies with multipart/x-mixed-replace and pushes every packet the encoder
+// publishes exactly once, as an image part carrying X-Perception-* headers
+// (plus a JSON metadata part before it with metadata=part). Each client is
+// paced to its own fps; a client that can't keep up gets the newest packet
+// once it has drained the previous one, and the packets in between are dropped.
+// While a recording is replayed, clients get the packets under the replay's
+// playhead instead of the live ones, as every other route does.
+// UE's HTTP server only sends complete responses, so the stream is served by its
+// own listener (loopback only); FPerceptionEndpoint redirects /perception/stream here.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+
+class FPerceptionEncoder;
+class FPerceptionReplay;
+class FPixelBus;
+class FRunnableThread;
+class FEvent;
+class FSocket;
+
+/** Connection and throughput counters since startup. */
+struct FPerceptionStreamStats
+{
+	int32 Clients = 0;
+	int64 FramesSent = 0;
+
+	/** Packets a client skipped because it was still receiving an older one */
+	int64 FramesDropped = 0;
+
+	int64 BytesSent = 0;
+};
+
+class FPerceptionStream : public FRunnable
+{
+public:
+	static constexpr int32 STREAM_PORT = 30012;
+
+	FPerceptionStream(FPerceptionEncoder* InEncoder, FPixelBus* InPixelBus);
+	virtual ~FPerceptionStream() override;
+
+	/** Open the listener and spawn the sender thread. */
+	void Start();
+
+	/** Close every client and the listener, and join the sender thread. */
+	void Shutdown();
+
+	bool IsRunning() const { return Thread != nullptr; }
+
+	FPerceptionStreamStats GetStats() const;
+
+	/** Stream Replay's playhead instead of the encoder's packets; null goes back to live.
+	 *  Clients carry on over the switch, counting frames afresh. Thread-safe. */
+	void SetReplay(TSharedPtr<FPerceptionReplay, ESPMode::ThreadSafe> InReplay);
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FClient
+	{
+		FSocket* Socket = nullptr;
+		FIPv4Endpoint Address;
+		double ConnectTime = 0.0;
+
+		// Request line and headers until the blank line
+		TArray<uint8> Request;
+		bool bStreaming = false;
+
+		// Pacing
+		double MinInterval = 0.0;
+		double NextSendTime = 0.0;
+		bool bMetadataPart = false;
+
+		// Bytes queued for the socket; nothing new is queued until they are out
+		TArray<uint8> Outgoing;
+		int32 OutgoingOffset = 0;
+		double LastProgressTime = 0.0;
+
+		int64 LastSentFrame = 0;
+
+		/** SourceVersion LastSentFrame counts in */
+		int32 SourceVersion = 0;
+
+		// Newer packets seen while the previous one was still going out
+		int64 LastBusyFrame = 0;
+		int32 BusyFramesSeen = 0;
+	};
+
+	/** Take every connection waiting on the listening socket. Sender thread. */
+	void AcceptPending(double Now);
+
+	/** Read the request. Returns false to drop the client. */
+	bool ReadRequest(FClient& Client, double Now);
+
+	/** Queue the latest packet for the client if it is due. */
+	void QueuePacket(FClient& Client, double Now);
+
+	/** Push queued bytes without blocking. Returns false to drop the client. */
+	bool Flush(FClient& Client, double Now);
+
+	void CloseClient(FClient& Client);
+
+	static void AppendUtf8(TArray<uint8>& Out, const FString& Text);
+
+	FPerceptionEncoder* Encoder = nullptr;
+	FPixelBus* PixelBus = nullptr;
+
+	/** Bound to loopback; accepted from by the sender thread */
+	FSocket* ListenSocket = nullptr;
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	TAtomic<bool> bStopRequested;
+
+	// Sender thread only
+	TArray<FClient> Clients;
+
+	mutable FCriticalSection StatsLock;
+	FPerceptionStreamStats Stats;
+
+	/** Replay streamed in place of the encoder; bumping SourceVersion resets every client's frame count */
+	mutable FCriticalSection ReplayLock;
+	TSharedPtr<FPerceptionReplay, ESPMode::ThreadSafe> Replay;
+	int32 SourceVersion = 0;
+};
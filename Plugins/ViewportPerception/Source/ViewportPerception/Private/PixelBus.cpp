@@ -1,63 +1,171 @@
 // PixelBus.cpp
 
 #include "PixelBus.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
 
 FPixelBus::FPixelBus()
-	: WriteIndex(0)
+	: LatestSlot(INDEX_NONE)
 	, LatestFrame(0)
+	, PublishCount(0)
+	, FrameEvent(nullptr)
+	, FramePool(FPerceptionFramePool::Create())
 {
 }
 
-void FPixelBus::WriteFrame(TArray<FColor>&& Pixels, FIntPoint Size,
-                           int64 FrameNumber, double Timestamp)
+FPerceptionFrameRef FPixelBus::AcquireFrame(FIntPoint Size)
 {
-	// Advance write index (wraps around NUM_SLOTS)
-	const int32 SlotIndex = WriteIndex.Load() % NUM_SLOTS;
+	return FramePool->Acquire(Size);
+}
 
-	FFrameSlot& Slot = Slots[SlotIndex];
-	Slot.bReady = false;  // Mark slot as being written
+int32 FPixelBus::BeginWrite()
+{
+	// With three slots there are always two non-latest candidates. Pins last only
+	// as long as a handle and metadata copy, so a pinned candidate frees up quickly.
+	for (;;)
+	{
+		const int32 Latest = LatestSlot.Load();
 
-	Slot.Pixels = MoveTemp(Pixels);
-	Slot.Size = Size;
-	Slot.FrameNumber = FrameNumber;
-	Slot.Timestamp = Timestamp;
+		for (int32 i = 0; i < NUM_SLOTS; ++i)
+		{
+			if (i == Latest)
+			{
+				continue;
+			}
+
+			FFrameSlot& Slot = Slots[i];
+			const uint64 Sequence = Slot.Sequence.Load();
+
+			// Mark odd first, then check pins. A reader pins first, then checks the
+			// sequence, so (sequentially consistent) one of the two always sees the other.
+			Slot.Sequence.Store(Sequence + 1);
+			if (Slot.Pins.Load() == 0)
+			{
+				return i;
+			}
+
+			// A late reader is copying from it; nothing was touched, restore and try the next
+			Slot.Sequence.Store(Sequence);
+		}
 
-	Slot.bReady = true;  // Mark slot as readable
+		FPlatformProcess::Yield();
+	}
+}
 
-	// Update latest frame counter and advance write index
+void FPixelBus::EndWrite(int32 SlotIndex, int64 FrameNumber)
+{
+	FFrameSlot& Slot = Slots[SlotIndex];
+	Slot.Sequence.Store(Slot.Sequence.Load() + 1);
+
+	LatestSlot.Store(SlotIndex);
 	LatestFrame.Store(FrameNumber);
-	WriteIndex.Store(SlotIndex + 1);
+	PublishCount.IncrementExchange();
 }
 
-bool FPixelBus::ReadLatest(TArray<FColor>& OutPixels, FIntPoint& OutSize,
-                           int64& OutFrameNumber, double& OutTimestamp) const
+void FPixelBus::WriteFrame(FPerceptionFrameRef&& Frame)
 {
-	// Find the slot with the highest frame number that is ready
-	int64 BestFrame = 0;
-	int32 BestSlot = -1;
+	if (!Frame.IsValid())
+	{
+		return;
+	}
+
+	const int64 FrameNumber = Frame->FrameNumber;
 
-	for (int32 i = 0; i < NUM_SLOTS; ++i)
 	{
-		if (Slots[i].bReady && Slots[i].FrameNumber > BestFrame)
+		FScopeLock Lock(&ExportLock);
+		if (SharedMemory)
 		{
-			BestFrame = Slots[i].FrameNumber;
-			BestSlot = i;
+			SharedMemory->Submit(Frame);
 		}
 	}
 
-	if (BestSlot < 0)
+	// The displaced frame is released outside the lock; it only returns to the
+	// pool once every reader still holding it lets go
+	FPerceptionFrameRef Displaced;
 	{
-		return false;
+		FScopeLock Lock(&WriterLock);
+		const int32 SlotIndex = BeginWrite();
+		FFrameSlot& Slot = Slots[SlotIndex];
+		Displaced = MoveTemp(Slot.Frame);
+		Slot.Frame = MoveTemp(Frame);
+		Slot.Metadata = FPerceptionMetadata();
+		EndWrite(SlotIndex, FrameNumber);
+	}
+
+	if (FEvent* Event = FrameEvent.Load())
+	{
+		Event->Trigger();
 	}
+}
+
+bool FPixelBus::AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber)
+{
+	FPerceptionFrameRef Displaced;
+	{
+		FScopeLock Lock(&WriterLock);
 
-	const FFrameSlot& Slot = Slots[BestSlot];
-	OutPixels = Slot.Pixels;  // Copy
-	OutSize = Slot.Size;
-	OutFrameNumber = Slot.FrameNumber;
-	OutTimestamp = Slot.Timestamp;
+		// Only writers move LatestSlot, and we hold the writer lock, so it is stable here
+		const int32 Latest = LatestSlot.Load();
+		if (Latest == INDEX_NONE || Slots[Latest].Frame->FrameNumber != FrameNumber)
+		{
+			return false;
+		}
+
+		// Republish the same frame with its metadata rather than editing a slot readers may be copying
+		const int32 SlotIndex = BeginWrite();
+		FFrameSlot& Slot = Slots[SlotIndex];
+		Displaced = MoveTemp(Slot.Frame);
+		Slot.Frame = Slots[Latest].Frame;
+		Slot.Metadata = Metadata;
+		EndWrite(SlotIndex, FrameNumber);
+	}
 	return true;
 }
 
+bool FPixelBus::ReadSlot(FPerceptionFrameRef* OutFrame, FPerceptionMetadata* OutMetadata, int64* OutFrameNumber) const
+{
+	for (;;)
+	{
+		const int32 SlotIndex = LatestSlot.Load();
+		if (SlotIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FFrameSlot& Slot = Slots[SlotIndex];
+		Slot.Pins.IncrementExchange();
+
+		const uint64 Sequence = Slot.Sequence.Load();
+		if ((Sequence & 1) == 0 && LatestSlot.Load() == SlotIndex)
+		{
+			// Pinned and even: no writer can claim this slot until we unpin
+			if (OutFrame)
+			{
+				*OutFrame = Slot.Frame;
+			}
+			if (OutMetadata)
+			{
+				*OutMetadata = Slot.Metadata;
+			}
+			if (OutFrameNumber)
+			{
+				*OutFrameNumber = Slot.Frame->FrameNumber;
+			}
+
+			Slot.Pins.DecrementExchange();
+			return true;
+		}
+
+		// A writer claimed it between our latest-slot load and the pin; the new latest is already published
+		Slot.Pins.DecrementExchange();
+	}
+}
+
+bool FPixelBus::ReadLatest(FPerceptionFrameRef& OutFrame) const
+{
+	return ReadSlot(&OutFrame, nullptr, nullptr);
+}
+
 bool FPixelBus::HasNewFrame(int64 LastSeenFrame) const
 {
 	return LatestFrame.Load() > LastSeenFrame;
@@ -68,57 +176,70 @@ int64 FPixelBus::GetLatestFrameNumber() const
 	return LatestFrame.Load();
 }
 
-void FPixelBus::AttachMetadata(const FPerceptionMetadata& Metadata)
+void FPixelBus::SetFrameEvent(FEvent* InEvent)
 {
-	FScopeLock Lock(&MetadataLock);
+	FrameEvent.Store(InEvent);
+}
 
-	// Attach to the most recently written slot
-	int64 BestFrame = 0;
-	int32 BestSlot = -1;
+bool FPixelBus::ReadLatestMetadata(FPerceptionMetadata& OutMetadata, int64& OutFrameNumber) const
+{
+	return ReadSlot(nullptr, &OutMetadata, &OutFrameNumber);
+}
 
-	for (int32 i = 0; i < NUM_SLOTS; ++i)
-	{
-		if (Slots[i].bReady && Slots[i].FrameNumber > BestFrame)
-		{
-			BestFrame = Slots[i].FrameNumber;
-			BestSlot = i;
-		}
-	}
+bool FPixelBus::ReadLatestWithMetadata(FPerceptionFrameRef& OutFrame, FPerceptionMetadata& OutMetadata) const
+{
+	return ReadSlot(&OutFrame, &OutMetadata, nullptr);
+}
 
-	if (BestSlot >= 0)
-	{
-		Slots[BestSlot].Metadata = Metadata;
-	}
+void FPixelBus::SetPoolLimits(int32 MaxFrames, int64 BudgetBytes)
+{
+	// The bus pins up to NUM_SLOTS frames and the producer needs one more to write into
+	FramePool->SetLimits(FMath::Max(MaxFrames, NUM_SLOTS + 1), BudgetBytes);
 }
 
-bool FPixelBus::ReadLatestWithMetadata(TArray<FColor>& OutPixels, FIntPoint& OutSize,
-                                       FPerceptionMetadata& OutMetadata,
-                                       int64& OutFrameNumber, double& OutTimestamp) const
+FPerceptionFramePoolStats FPixelBus::GetPoolStats() const
 {
-	FScopeLock Lock(&MetadataLock);
+	return FramePool->GetStats();
+}
 
-	int64 BestFrame = 0;
-	int32 BestSlot = -1;
+bool FPixelBus::SetSharedMemoryExport(int32 SlotCount, FIntPoint MaxSize)
+{
+	FScopeLock ConfigLock(&ExportConfigLock);
 
-	for (int32 i = 0; i < NUM_SLOTS; ++i)
+	// Detach under the lock, destroy outside it: the destructor waits for the exporter's
+	// drain, and the render thread would be stuck behind it in WriteFrame
+	TUniquePtr<FPerceptionSharedMemory> Previous;
 	{
-		if (Slots[i].bReady && Slots[i].FrameNumber > BestFrame)
-		{
-			BestFrame = Slots[i].FrameNumber;
-			BestSlot = i;
-		}
+		FScopeLock Lock(&ExportLock);
+		Previous = MoveTemp(SharedMemory);
+	}
+
+	// Unmap first: the new mapping reuses the name
+	Previous.Reset();
+
+	if (SlotCount <= 0)
+	{
+		return true;
+	}
+
+	TUniquePtr<FPerceptionSharedMemory> Created = FPerceptionSharedMemory::Create(FPerceptionSharedMemory::GetDefaultName(), SlotCount, MaxSize);
+	const bool bCreated = Created.IsValid();
+	{
+		FScopeLock Lock(&ExportLock);
+		SharedMemory = MoveTemp(Created);
 	}
+	return bCreated;
+}
+
+bool FPixelBus::GetSharedMemoryInfo(FPerceptionSharedMemoryInfo& OutInfo) const
+{
+	FScopeLock Lock(&ExportLock);
 
-	if (BestSlot < 0)
+	if (!SharedMemory)
 	{
 		return false;
 	}
 
-	const FFrameSlot& Slot = Slots[BestSlot];
-	OutPixels = Slot.Pixels;
-	OutSize = Slot.Size;
-	OutMetadata = Slot.Metadata;
-	OutFrameNumber = Slot.FrameNumber;
-	OutTimestamp = Slot.Timestamp;
+	OutInfo = SharedMemory->GetInfo();
 	return true;
 }
@@ -1,24 +1,49 @@
 // PixelBus.h
-// Lock-free ring buffer with latest-frame latch semantics.
-// Producer (render thread) writes frames, consumer (HTTP handler) reads the latest.
+// Sequence-locked triple buffer with latest-frame latch semantics.
+// Producer (render thread) writes frames, consumers (encoder, HTTP handlers) read the latest.
+// Frames live in pooled, ref-counted buffers (PerceptionFrame.h): readers get a
+// shared handle to the frame instead of a copy of its pixels.
+//
+// Readers never lock. A reader pins the latest slot, checks its sequence counter
+// is even (not being written), copies the frame handle and metadata, then unpins.
+// Writers publish into a slot that is neither the latest nor pinned: they mark it
+// odd, back off if a reader pinned it in the meantime, fill it, mark it even and
+// swap it in as the latest with a single atomic store. Writers (frame producer and
+// metadata attachment) are serialized among themselves.
+//
+// Published frames can also be mirrored into a named shared-memory ring for
+// consumers on the same host (PerceptionSharedMemory.h).
+//
+// The bus also owns the tile-hash change tracker (PerceptionChanges.h). Readers
+// hash the frames they pick up through it, so a frame is hashed once however
+// many stages read it. The block-motion estimator (PerceptionMotion.h) lives
+// here for the same reason: it keeps the previous frame's luma plane.
 
 #pragma once
 
 #include "CoreMinimal.h"
 #include "PerceptionTypes.h"
+#include "PerceptionFrame.h"
+#include "PerceptionSharedMemory.h"
+#include "PerceptionChanges.h"
+#include "PerceptionMotion.h"
+
+class FEvent;
 
 class FPixelBus
 {
 public:
 	FPixelBus();
 
-	/** Producer: write a completed frame into the next slot. Thread-safe. */
-	void WriteFrame(TArray<FColor>&& Pixels, FIntPoint Size,
-	                int64 FrameNumber, double Timestamp);
+	/** Producer: take an empty frame from the pool, sized for Size pixels.
+	 *  Invalid if the pool is at its frame or memory limit (drop the capture). */
+	FPerceptionFrameRef AcquireFrame(FIntPoint Size);
+
+	/** Producer: publish a filled frame as the latest. The frame must not be edited afterwards. Thread-safe. */
+	void WriteFrame(FPerceptionFrameRef&& Frame);
 
 	/** Consumer: read the latest completed frame. Returns false if no frame available. */
-	bool ReadLatest(TArray<FColor>& OutPixels, FIntPoint& OutSize,
-	                int64& OutFrameNumber, double& OutTimestamp) const;
+	bool ReadLatest(FPerceptionFrameRef& OutFrame) const;
 
 	/** Check if a new frame has arrived since the given frame number. */
 	bool HasNewFrame(int64 LastSeenFrame) const;
@@ -26,31 +51,82 @@ public:
 	/** Get the latest frame number (0 if no frames written). */
 	int64 GetLatestFrameNumber() const;
 
-	/** Attach metadata to the most recently written frame. Call from game thread. */
-	void AttachMetadata(const FPerceptionMetadata& Metadata);
+	/** Number of publishes (frames and metadata attachments) since startup. */
+	uint64 GetPublishCount() const { return PublishCount.Load(); }
+
+	/** Event triggered after every WriteFrame (e.g. to wake the encoder). Pass null to clear. */
+	void SetFrameEvent(FEvent* InEvent);
+
+	/** Attach metadata to frame FrameNumber, republishing it with the metadata.
+	 *  Returns false if a newer frame has been published since (the metadata would be stale). */
+	bool AttachMetadata(const FPerceptionMetadata& Metadata, int64 FrameNumber);
+
+	/** Read only the metadata of the latest frame (no pixel copy). Returns false if no frame available. */
+	bool ReadLatestMetadata(FPerceptionMetadata& OutMetadata, int64& OutFrameNumber) const;
+
+	/** Read the latest frame and the metadata attached to it. Returns false if no frame available. */
+	bool ReadLatestWithMetadata(FPerceptionFrameRef& OutFrame, FPerceptionMetadata& OutMetadata) const;
+
+	/** Limit the number of pooled frames and the memory they may hold. */
+	void SetPoolLimits(int32 MaxFrames, int64 BudgetBytes);
+
+	FPerceptionFramePoolStats GetPoolStats() const;
+
+	/** Mirror every published frame into a shared-memory ring of SlotCount slots, each up to
+	 *  MaxSize pixels. SlotCount 0 turns the export off. False if the mapping can't be created. */
+	bool SetSharedMemoryExport(int32 SlotCount, FIntPoint MaxSize);
+
+	/** Mapping name and layout. False if the export is off. */
+	bool GetSharedMemoryInfo(FPerceptionSharedMemoryInfo& OutInfo) const;
 
-	/** Read the latest frame as a full perception packet (before encode). */
-	bool ReadLatestWithMetadata(TArray<FColor>& OutPixels, FIntPoint& OutSize,
-	                            FPerceptionMetadata& OutMetadata,
-	                            int64& OutFrameNumber, double& OutTimestamp) const;
+	/** Changed tiles between the frames read off this bus. Thread-safe. */
+	FPerceptionChangeTracker& GetChangeTracker() { return ChangeTracker; }
+
+	/** Block-motion estimator shared by every stage that reads frames. */
+	FPerceptionMotionEstimator& GetMotionEstimator() { return MotionEstimator; }
 
 private:
 	struct FFrameSlot
 	{
-		TArray<FColor> Pixels;
-		FIntPoint Size = FIntPoint::ZeroValue;
+		/** Odd while a writer is filling the slot */
+		TAtomic<uint64> Sequence { 0 };
+
+		/** Readers currently copying out of the slot */
+		mutable TAtomic<int32> Pins { 0 };
+
+		FPerceptionFrameRef Frame;
 		FPerceptionMetadata Metadata;
-		int64 FrameNumber = 0;
-		double Timestamp = 0.0;
-		FThreadSafeBool bReady;
 	};
 
+	/** Claim a slot that is neither the latest nor pinned and mark it odd. Writer lock must be held. */
+	int32 BeginWrite();
+
+	/** Mark the slot even again and make it the latest. Writer lock must be held. */
+	void EndWrite(int32 SlotIndex, int64 FrameNumber);
+
+	/** Pin the latest slot and copy out of it. Frame and/or metadata may be null. */
+	bool ReadSlot(FPerceptionFrameRef* OutFrame, FPerceptionMetadata* OutMetadata, int64* OutFrameNumber) const;
+
 	static constexpr int32 NUM_SLOTS = 3;
 	FFrameSlot Slots[NUM_SLOTS];
 
-	TAtomic<int32> WriteIndex;
+	TAtomic<int32> LatestSlot;
 	TAtomic<int64> LatestFrame;
+	TAtomic<uint64> PublishCount;
+	TAtomic<FEvent*> FrameEvent;
+
+	TSharedRef<FPerceptionFramePool, ESPMode::ThreadSafe> FramePool;
+
+	// Serializes writers only; readers never take it
+	FCriticalSection WriterLock;
+
+	// Guards SharedMemory for WriteFrame; never held while an exporter is created or destroyed
+	mutable FCriticalSection ExportLock;
+	TUniquePtr<FPerceptionSharedMemory> SharedMemory;
+
+	/** Serializes SetSharedMemoryExport, which swaps the exporter in steps */
+	FCriticalSection ExportConfigLock;
 
-	// Critical section for metadata attachment (game thread only)
-	mutable FCriticalSection MetadataLock;
+	FPerceptionChangeTracker ChangeTracker;
+	FPerceptionMotionEstimator MotionEstimator;
 };
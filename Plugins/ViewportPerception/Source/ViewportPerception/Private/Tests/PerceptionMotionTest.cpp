@@ -0,0 +1,132 @@
+// PerceptionMotionTest.cpp
+// FPerceptionMotionEstimator: the compiled BlockSAD kernel against a plain
+// scalar sum, and a textured frame panned by a known number of pixels reading
+// back as that camera translation.
+// Run with: Automation RunTests ViewportPerception.Motion
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PerceptionMotion.h"
+
+namespace PerceptionMotionTest
+{
+	/** Gray value noise over every integer position, so a shifted window is an exact shift. */
+	static uint8 Noise(int32 X, int32 Y)
+	{
+		uint32 Hash = static_cast<uint32>(X) * 0x9E3779B1u ^ static_cast<uint32>(Y) * 0x85EBCA77u;
+		Hash ^= Hash >> 15;
+		Hash *= 0x2C1B3C6Du;
+		Hash ^= Hash >> 12;
+		return static_cast<uint8>(Hash & 0xFF);
+	}
+
+	/** Size pixels of the noise field, read OffsetX pixels to the left: content moves right by OffsetX. */
+	static void FillFrame(FPerceptionFrame& Frame, FIntPoint Size, int32 OffsetX, int64 FrameNumber)
+	{
+		Frame.Size = Size;
+		Frame.FrameNumber = FrameNumber;
+		Frame.Pixels.SetNumUninitialized(Size.X * Size.Y);
+		for (int32 Y = 0; Y < Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < Size.X; ++X)
+			{
+				const uint8 Value = Noise(X - OffsetX, Y);
+				Frame.Pixels[Y * Size.X + X] = FColor(Value, Value, Value, 255);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerceptionMotionTest, "ViewportPerception.Motion.Estimator",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPerceptionMotionTest::RunTest(const FString& Parameters)
+{
+	using namespace PerceptionMotionTest;
+
+	constexpr int32 BlockSize = FPerceptionMotionEstimator::BlockSize;
+
+	AddInfo(FString::Printf(TEXT("Motion kernel: %s"), FPerceptionMotionEstimator::GetKernelName()));
+
+	// Strides wider than the block and unaligned starts, as the search reads them
+	{
+		constexpr int32 StrideA = 37;
+		constexpr int32 StrideB = 53;
+		TArray<uint8> A, B;
+		A.SetNumUninitialized(StrideA * (BlockSize + 1));
+		B.SetNumUninitialized(StrideB * (BlockSize + 1));
+		for (int32 i = 0; i < A.Num(); ++i)
+		{
+			A[i] = Noise(i, 1);
+		}
+		for (int32 i = 0; i < B.Num(); ++i)
+		{
+			B[i] = Noise(i, 2);
+		}
+
+		for (int32 Offset = 0; Offset < 4; ++Offset)
+		{
+			const uint8* BlockA = A.GetData() + Offset;
+			const uint8* BlockB = B.GetData() + 3 - Offset;
+
+			uint32 Expected = 0;
+			for (int32 Row = 0; Row < BlockSize; ++Row)
+			{
+				for (int32 X = 0; X < BlockSize; ++X)
+				{
+					Expected += static_cast<uint32>(FMath::Abs(BlockA[Row * StrideA + X] - BlockB[Row * StrideB + X]));
+				}
+			}
+
+			TestEqual(FString::Printf(TEXT("BlockSAD at offset %d"), Offset),
+				FPerceptionMotionEstimator::BlockSAD(BlockA, StrideA, BlockB, StrideB), Expected);
+		}
+
+		TestEqual(TEXT("BlockSAD of a block against itself"),
+			FPerceptionMotionEstimator::BlockSAD(A.GetData(), StrideA, A.GetData(), StrideA), 0u);
+	}
+
+	// 512 wide lands on a 2x downsample; even shifts keep the plane pixels aligned
+	{
+		const FIntPoint Size(512, 256);
+		const int32 Shifts[] = { 2, 6, 12 };
+
+		for (const int32 Shift : Shifts)
+		{
+			FPerceptionMotionEstimator Estimator;
+			FPerceptionFrame First, Second;
+			FillFrame(First, Size, 0, 1);
+			FillFrame(Second, Size, Shift, 2);
+
+			TestFalse(TEXT("First frame has nothing to compare with"), Estimator.Update(First).bValid);
+
+			const FPerceptionMotion Motion = Estimator.Update(Second, 4);
+			const FString Label = FString::Printf(TEXT("Pan of %d px"), Shift);
+			if (!TestTrue(FString::Printf(TEXT("%s: motion is valid"), *Label), Motion.bValid))
+			{
+				continue;
+			}
+
+			AddInfo(FString::Printf(TEXT("%s: translation (%.2f, %.2f), zoom %.4f, local %.3f"),
+				*Label, Motion.CameraTranslation.X, Motion.CameraTranslation.Y, Motion.CameraZoom, Motion.LocalMotion));
+
+			TestEqual(FString::Printf(TEXT("%s: base frame"), *Label), Motion.BaseFrame, static_cast<int64>(1));
+			TestTrue(FString::Printf(TEXT("%s: horizontal translation"), *Label),
+				FMath::IsNearlyEqual(Motion.CameraTranslation.X, static_cast<double>(Shift), 0.5));
+			TestTrue(FString::Printf(TEXT("%s: no vertical translation"), *Label),
+				FMath::IsNearlyZero(Motion.CameraTranslation.Y, 0.5));
+			TestTrue(FString::Printf(TEXT("%s: read as camera motion"), *Label), Motion.Kind == EPerceptionMotionKind::Camera);
+
+			// A repeat request for the frame gets the kept result
+			const FPerceptionMotion Repeat = Estimator.Update(Second);
+			TestTrue(FString::Printf(TEXT("%s: repeat request matches"), *Label),
+				Repeat.bValid && Repeat.CameraTranslation == Motion.CameraTranslation);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,116 @@
+// PerceptionRecorderTest.cpp
+// Round trip through FPerceptionRecorder and FPerceptionReplay: packets written
+// across several segments come back byte for byte, by frame number and by
+// recorded time, with metadata attached after the packet was queued.
+// Run with: Automation RunTests ViewportPerception.Recorder
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PerceptionRecorder.h"
+#include "PerceptionReplay.h"
+#include "PerceptionEncoder.h"
+#include "HAL/FileManager.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+namespace PerceptionRecorderTest
+{
+	constexpr int32 ImageBytes = 300 * 1024;
+
+	TSharedRef<FPerceptionEncodedFrame, ESPMode::ThreadSafe> MakeFrame(int64 FrameNumber)
+	{
+		TSharedRef<FPerceptionEncodedFrame, ESPMode::ThreadSafe> Frame = MakeShared<FPerceptionEncodedFrame, ESPMode::ThreadSafe>();
+		FPerceptionPacket& Packet = Frame->Packet;
+		Packet.ImageData.SetNumUninitialized(ImageBytes);
+		for (int32 i = 0; i < ImageBytes; ++i)
+		{
+			Packet.ImageData[i] = static_cast<uint8>((i * 31 + FrameNumber * 7) & 0xFF);
+		}
+		Packet.Width = 64;
+		Packet.Height = 48;
+		Packet.FrameNumber = FrameNumber;
+		Packet.Timestamp = 1000.0 + FrameNumber * 0.1;
+		Packet.PerceptualHash = FrameNumber * 0x0101010101ll;
+		Packet.bValid = true;
+		return Frame;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerceptionRecorderTest, "ViewportPerception.Recorder.RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPerceptionRecorderTest::RunTest(const FString& Parameters)
+{
+	using namespace PerceptionRecorderTest;
+
+	constexpr int64 NumFrames = 10;
+	const FString Directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("PerceptionRecording"), FGuid::NewGuid().ToString());
+
+	FPerceptionRecorder Recorder;
+	if (!TestTrue(TEXT("Recording started"), Recorder.Start(Directory, 1024 * 1024)))
+	{
+		return false;
+	}
+	TestFalse(TEXT("A second recording into the same directory is refused"), FPerceptionRecorder().Start(Directory));
+
+	for (int64 FrameNumber = 1; FrameNumber <= NumFrames; ++FrameNumber)
+	{
+		Recorder.Enqueue(MakeFrame(FrameNumber));
+	}
+
+	// The last packet waits for its metadata, as it would for the game tick
+	FPerceptionMetadata Metadata;
+	Metadata.MapName = TEXT("RecordedMap");
+	Recorder.AttachMetadata(Metadata, NumFrames);
+	Recorder.Shutdown();
+
+	const FPerceptionRecorderStats Stats = Recorder.GetStats();
+	TestEqual(TEXT("Frames written"), Stats.FramesWritten, NumFrames);
+	TestEqual(TEXT("Frames dropped"), Stats.FramesDropped, 0ll);
+	TestTrue(TEXT("Segments rotated"), Stats.Segments > 1);
+
+	FPerceptionReplay Replay;
+	if (!TestTrue(TEXT("Recording opened"), Replay.Open(Directory)))
+	{
+		return false;
+	}
+
+	const FPerceptionReplayStats ReplayStats = Replay.GetStats();
+	TestEqual(TEXT("Frames in the index"), ReplayStats.Frames, static_cast<int32>(NumFrames));
+	TestEqual(TEXT("First frame"), ReplayStats.FirstFrame, 1ll);
+	TestEqual(TEXT("Last frame"), ReplayStats.LastFrame, NumFrames);
+
+	for (int64 FrameNumber = 1; FrameNumber <= NumFrames; ++FrameNumber)
+	{
+		const FPerceptionPacket Expected = MakeFrame(FrameNumber)->Packet;
+		FPerceptionPacket Packet;
+		if (!TestTrue(FString::Printf(TEXT("Frame %lld read back"), FrameNumber), Replay.GetPacketByFrame(FrameNumber, Packet)))
+		{
+			continue;
+		}
+
+		TestEqual(TEXT("Frame number"), Packet.FrameNumber, FrameNumber);
+		TestEqual(TEXT("Timestamp"), Packet.Timestamp, Expected.Timestamp);
+		TestEqual(TEXT("Perceptual hash"), Packet.PerceptualHash, Expected.PerceptualHash);
+		TestTrue(TEXT("Image bytes"), Packet.ImageData == Expected.ImageData);
+	}
+
+	FPerceptionPacket Packet;
+	TestTrue(TEXT("Lookup between frames"), Replay.GetPacketAt(1000.35, Packet));
+	TestEqual(TEXT("Lookup between frames lands on the earlier one"), Packet.FrameNumber, 3ll);
+	TestFalse(TEXT("Lookup before the recording"), Replay.GetPacketAt(999.0, Packet));
+
+	TestTrue(TEXT("Last frame read back"), Replay.GetPacketByFrame(NumFrames, Packet));
+	TestEqual(TEXT("Metadata attached after queueing"), Packet.Metadata.MapName, FString(TEXT("RecordedMap")));
+
+	Replay.Play(0.0f);
+	TestEqual(TEXT("Paused replay holds the first frame"), Replay.GetCurrentFrameNumber(), 1ll);
+
+	Replay.Close();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
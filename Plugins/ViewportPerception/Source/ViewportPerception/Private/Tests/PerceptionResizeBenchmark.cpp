@@ -0,0 +1,199 @@
+// PerceptionResizeBenchmark.cpp
+// Compares FPerceptionAdapter::Resize (box halving + fixed-point vector resampler)
+// with the original float implementation for speed and quality.
+// Run with: Automation RunTests ViewportPerception.Adapter.ResizeBenchmark
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PerceptionAdapter.h"
+#include "PerceptionResampler.h"
+#include "ViewportPerceptionModule.h"
+#include "HAL/PlatformTime.h"
+#include "Async/TaskGraphInterfaces.h"
+
+namespace PerceptionResizeBenchmark
+{
+	/** Gradients plus a zone plate whose frequency reaches Nyquist at the edges, so aliasing shows up. */
+	static TArray<FColor> MakeTestImage(FIntPoint Size)
+	{
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(Size.X * Size.Y);
+		const double CenterX = Size.X * 0.5;
+		const double CenterY = Size.Y * 0.5;
+		for (int32 Y = 0; Y < Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < Size.X; ++X)
+			{
+				const double RadiusSq = FMath::Square(X - CenterX) + FMath::Square(Y - CenterY);
+				const uint8 Zone = static_cast<uint8>(128.0 + 127.0 * FMath::Cos(UE_DOUBLE_PI * RadiusSq / Size.X));
+				Pixels[Y * Size.X + X] = FColor(
+					static_cast<uint8>(X * 255 / FMath::Max(Size.X - 1, 1)),
+					static_cast<uint8>(Y * 255 / FMath::Max(Size.Y - 1, 1)),
+					Zone, 255);
+			}
+		}
+		return Pixels;
+	}
+
+	/** Exact area average (fractional pixel coverage), as RGB doubles. Ground truth for downscales. */
+	static TArray<double> MakeAreaReference(const TArray<FColor>& Source, FIntPoint SourceSize, FIntPoint TargetSize)
+	{
+		TArray<double> Result;
+		Result.SetNumZeroed(TargetSize.X * TargetSize.Y * 3);
+		const double ScaleX = static_cast<double>(SourceSize.X) / TargetSize.X;
+		const double ScaleY = static_cast<double>(SourceSize.Y) / TargetSize.Y;
+
+		for (int32 Y = 0; Y < TargetSize.Y; ++Y)
+		{
+			const double Y0 = Y * ScaleY;
+			const double Y1 = Y0 + ScaleY;
+			for (int32 X = 0; X < TargetSize.X; ++X)
+			{
+				const double X0 = X * ScaleX;
+				const double X1 = X0 + ScaleX;
+				double Sum[3] = { 0.0, 0.0, 0.0 };
+				double Coverage = 0.0;
+
+				for (int32 SY = FMath::FloorToInt32(Y0); SY < FMath::Min(FMath::CeilToInt32(Y1), SourceSize.Y); ++SY)
+				{
+					const double WY = FMath::Min(Y1, SY + 1.0) - FMath::Max(Y0, static_cast<double>(SY));
+					for (int32 SX = FMath::FloorToInt32(X0); SX < FMath::Min(FMath::CeilToInt32(X1), SourceSize.X); ++SX)
+					{
+						const double W = WY * (FMath::Min(X1, SX + 1.0) - FMath::Max(X0, static_cast<double>(SX)));
+						const FColor& C = Source[SY * SourceSize.X + SX];
+						Sum[0] += C.R * W;
+						Sum[1] += C.G * W;
+						Sum[2] += C.B * W;
+						Coverage += W;
+					}
+				}
+
+				for (int32 Channel = 0; Channel < 3; ++Channel)
+				{
+					Result[(Y * TargetSize.X + X) * 3 + Channel] = Sum[Channel] / FMath::Max(Coverage, UE_DOUBLE_SMALL_NUMBER);
+				}
+			}
+		}
+		return Result;
+	}
+
+	static double PSNRFromSquaredError(double SumSq, int32 Samples)
+	{
+		const double MSE = SumSq / FMath::Max(Samples, 1);
+		return MSE > 0.0 ? 10.0 * FMath::LogX(10.0, 255.0 * 255.0 / MSE) : 99.0;
+	}
+
+	/** Peak signal-to-noise ratio over RGB, in dB. */
+	static double ComputePSNR(const TArray<FColor>& A, const TArray<FColor>& B)
+	{
+		double SumSq = 0.0;
+		for (int32 i = 0; i < A.Num(); ++i)
+		{
+			SumSq += FMath::Square(static_cast<double>(A[i].R) - B[i].R);
+			SumSq += FMath::Square(static_cast<double>(A[i].G) - B[i].G);
+			SumSq += FMath::Square(static_cast<double>(A[i].B) - B[i].B);
+		}
+		return PSNRFromSquaredError(SumSq, A.Num() * 3);
+	}
+
+	/** PSNR against the exact area average, in dB. */
+	static double ComputePSNR(const TArray<FColor>& A, const TArray<double>& Area)
+	{
+		double SumSq = 0.0;
+		for (int32 i = 0; i < A.Num(); ++i)
+		{
+			SumSq += FMath::Square(A[i].R - Area[i * 3]);
+			SumSq += FMath::Square(A[i].G - Area[i * 3 + 1]);
+			SumSq += FMath::Square(A[i].B - Area[i * 3 + 2]);
+		}
+		return PSNRFromSquaredError(SumSq, A.Num() * 3);
+	}
+
+	template <typename ResizeFn>
+	static double TimeMs(ResizeFn&& Fn, int32 Iterations)
+	{
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Fn();
+		}
+		return (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerceptionResizeBenchmarkTest, "ViewportPerception.Adapter.ResizeBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPerceptionResizeBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace PerceptionResizeBenchmark;
+
+	struct FCase { FIntPoint Source; FIntPoint Target; };
+	const FCase Cases[] =
+	{
+		{ FIntPoint(1920, 1080), FIntPoint(1280, 720) },
+		{ FIntPoint(2560, 1440), FIntPoint(1280, 720) },
+		{ FIntPoint(1280, 720),  FIntPoint(1920, 1080) },
+		{ FIntPoint(2560, 1440), FIntPoint(800, 450) },
+		{ FIntPoint(3840, 2160), FIntPoint(640, 360) },
+	};
+	constexpr int32 Iterations = 10;
+	const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+	AddInfo(FString::Printf(TEXT("Resampler kernel: %s, %d workers"), FPerceptionResampler::GetKernelName(), Workers));
+
+	for (const FCase& Case : Cases)
+	{
+		const TArray<FColor> Source = MakeTestImage(Case.Source);
+
+		TArray<FColor> Fast;
+		TArray<FColor> Reference;
+		const double FastMs = TimeMs([&]() { Fast = FPerceptionAdapter::Resize(Source, Case.Source, Case.Target); }, Iterations);
+		const double ReferenceMs = TimeMs([&]() { Reference = FPerceptionAdapter::ResizeReference(Source, Case.Source, Case.Target); }, Iterations);
+
+		TArray<FColor> Parallel;
+		const double ParallelMs = TimeMs([&]() { Parallel = FPerceptionAdapter::Resize(Source, Case.Source, Case.Target, Workers); }, Iterations);
+
+		if (!TestEqual(TEXT("Output size"), Fast.Num(), Reference.Num()))
+		{
+			continue;
+		}
+
+		const FString Label = FString::Printf(TEXT("%dx%d -> %dx%d"),
+			Case.Source.X, Case.Source.Y, Case.Target.X, Case.Target.Y);
+
+		// Bands are independent, so splitting must not change a single byte
+		AddInfo(FString::Printf(TEXT("%s: %d row bands %.2f ms (%.1fx over one thread)"),
+			*Label, Workers, ParallelMs, FastMs / FMath::Max(ParallelMs, 0.001)));
+		TestTrue(FString::Printf(TEXT("%s row-band output matches single-threaded"), *Label), Parallel == Fast);
+
+		const int32 HalvingSteps = FPerceptionResampler::GetHalvingSteps(Case.Source, Case.Target);
+
+		if (HalvingSteps == 0)
+		{
+			const double PSNR = ComputePSNR(Fast, Reference);
+			AddInfo(FString::Printf(TEXT("%s: resampler %.2f ms, reference %.2f ms (%.1fx), PSNR %.1f dB"),
+				*Label, FastMs, ReferenceMs, ReferenceMs / FMath::Max(FastMs, 0.001), PSNR));
+
+			// 8.8 weights round where the float path truncates; anything under ~40 dB is a kernel bug
+			TestTrue(FString::Printf(TEXT("%s matches reference (PSNR %.1f dB)"), *Label, PSNR), PSNR > 40.0);
+		}
+		else
+		{
+			// Bilinear skips most source pixels at these ratios, so judge both against a true area average
+			const TArray<double> Area = MakeAreaReference(Source, Case.Source, Case.Target);
+			const double FastPSNR = ComputePSNR(Fast, Area);
+			const double ReferencePSNR = ComputePSNR(Reference, Area);
+			AddInfo(FString::Printf(TEXT("%s: %d halving(s) + resampler %.2f ms, reference %.2f ms, PSNR vs area average %.1f dB (reference %.1f dB)"),
+				*Label, HalvingSteps, FastMs, ReferenceMs, FastPSNR, ReferencePSNR));
+
+			TestTrue(FString::Printf(TEXT("%s is closer to the area average than bilinear"), *Label), FastPSNR >= ReferencePSNR);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,246 @@
+// PerceptionSharedMemoryTest.cpp
+// Reference reader for the shared-memory frame export, exercised against a live
+// FPixelBus. FSharedFrameReader is deliberately written against the documented
+// layout only (PerceptionSharedMemory.h), the way an out-of-process consumer
+// would, so it doubles as the example to port to other languages.
+// Run with: Automation RunTests ViewportPerception.SharedMemory
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PixelBus.h"
+#include "PerceptionSharedMemory.h"
+#include "Async/Async.h"
+
+namespace PerceptionSharedMemoryTest
+{
+	/** One frame copied out of the ring. */
+	struct FSharedFrame
+	{
+		int64 FrameNumber = 0;
+		double Timestamp = 0.0;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		FIntPoint SourceSize = FIntPoint::ZeroValue;
+		TArray<FColor> Pixels;
+	};
+
+	class FSharedFrameReader
+	{
+	public:
+		~FSharedFrameReader()
+		{
+			if (Region)
+			{
+				FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+			}
+		}
+
+		/** Map an existing export read-only and validate its header. */
+		bool Open(const FString& Name, int64 Bytes)
+		{
+			Region = FPlatformMemory::MapNamedSharedMemoryRegion(Name, false,
+				static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Read), Bytes);
+			if (!Region)
+			{
+				return false;
+			}
+
+			Base = static_cast<const uint8*>(Region->GetAddress());
+			Header = reinterpret_cast<const FPerceptionSharedHeader*>(Base);
+			return Header->Magic == FPerceptionSharedHeader::MagicValue
+				&& Header->Version == FPerceptionSharedHeader::CurrentVersion
+				&& Header->PixelFormat == 0;
+		}
+
+		int64 GetLatestFrameNumber() const
+		{
+			return FPlatformAtomics::AtomicRead(&Header->LatestFrame);
+		}
+
+		/** Copy the newest frame. False if there is none yet or the writer kept lapping us. */
+		bool ReadLatest(FSharedFrame& Out, int32& OutRetries) const
+		{
+			const int32 SlotIndex = FPlatformAtomics::AtomicRead(&Header->LatestSlot);
+			if (SlotIndex < 0 || SlotIndex >= static_cast<int32>(Header->SlotCount))
+			{
+				return false;
+			}
+
+			const uint8* SlotBase = Base + Header->HeaderSize + static_cast<int64>(SlotIndex) * Header->SlotStride;
+			const FPerceptionSharedSlot* Slot = reinterpret_cast<const FPerceptionSharedSlot*>(SlotBase);
+
+			for (int32 Attempt = 0; Attempt < 16; ++Attempt)
+			{
+				// Odd: the writer is in this slot right now
+				const int64 Before = FPlatformAtomics::AtomicRead(&Slot->Sequence);
+				if (Before & 1)
+				{
+					++OutRetries;
+					FPlatformProcess::Yield();
+					continue;
+				}
+				FPlatformMisc::MemoryBarrier();
+
+				Out.FrameNumber = Slot->FrameNumber;
+				Out.Timestamp = Slot->Timestamp;
+				Out.Size = FIntPoint(Slot->Width, Slot->Height);
+				Out.SourceSize = FIntPoint(Slot->SourceWidth, Slot->SourceHeight);
+
+				const int64 NumPixels = static_cast<int64>(Out.Size.X) * Out.Size.Y;
+				const int64 MaxPixels = static_cast<int64>(Header->MaxWidth) * Header->MaxHeight;
+				if (NumPixels > MaxPixels || Slot->RowPitch != Out.Size.X * sizeof(FColor))
+				{
+					// Fields read mid-write; the sequence check below would reject them anyway
+					++OutRetries;
+					continue;
+				}
+
+				Out.Pixels.SetNumUninitialized(NumPixels);
+				FMemory::Memcpy(Out.Pixels.GetData(), SlotBase + sizeof(FPerceptionSharedSlot), NumPixels * sizeof(FColor));
+
+				// Unchanged sequence: nothing was overwritten while we copied
+				FPlatformMisc::MemoryBarrier();
+				if (FPlatformAtomics::AtomicRead(&Slot->Sequence) == Before)
+				{
+					return true;
+				}
+				++OutRetries;
+			}
+			return false;
+		}
+
+	private:
+		FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+		const uint8* Base = nullptr;
+		const FPerceptionSharedHeader* Header = nullptr;
+	};
+
+	/** Every pixel of frame N encodes N, so a torn copy shows up as a mismatch. */
+	static FColor PatternFor(int64 FrameNumber)
+	{
+		return FColor(
+			static_cast<uint8>(FrameNumber & 0xFF),
+			static_cast<uint8>((FrameNumber >> 8) & 0xFF),
+			static_cast<uint8>((FrameNumber >> 16) & 0xFF),
+			255);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerceptionSharedMemoryTest, "ViewportPerception.SharedMemory.ReferenceReader",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPerceptionSharedMemoryTest::RunTest(const FString& Parameters)
+{
+	using namespace PerceptionSharedMemoryTest;
+
+	constexpr int64 NumFrames = 5000;
+	const FIntPoint CaptureSize(64, 48);
+	const FIntPoint MaxSize(32, 32);
+	const FIntPoint StoredSize = FPerceptionSharedMemory::FitSize(CaptureSize, MaxSize);
+
+	FPixelBus Bus;
+	if (!TestTrue(TEXT("Export created"), Bus.SetSharedMemoryExport(3, MaxSize)))
+	{
+		return false;
+	}
+
+	FPerceptionSharedMemoryInfo Info;
+	Bus.GetSharedMemoryInfo(Info);
+
+	FSharedFrameReader Reader;
+	if (!TestTrue(TEXT("Reader mapped the export by name"), Reader.Open(Info.Name, Info.TotalBytes)))
+	{
+		return false;
+	}
+
+	TAtomic<bool> bDone(false);
+	TFuture<void> Writer = Async(EAsyncExecution::Thread, [&]()
+	{
+		for (int64 FrameNumber = 1; FrameNumber <= NumFrames; ++FrameNumber)
+		{
+			FPerceptionFrameRef Frame = Bus.AcquireFrame(CaptureSize);
+			if (!Frame.IsValid())
+			{
+				FPlatformProcess::Yield();
+				--FrameNumber;  // Retry: the last frame must be published for the final check
+				continue;
+			}
+
+			FPerceptionFrame& Target = Frame.Edit();
+			const FColor Pattern = PatternFor(FrameNumber);
+			for (FColor& Pixel : Target.Pixels)
+			{
+				Pixel = Pattern;
+			}
+			Target.FrameNumber = FrameNumber;
+			Target.Timestamp = FPlatformTime::Seconds();
+			Bus.WriteFrame(MoveTemp(Frame));
+		}
+		bDone = true;
+	});
+
+	int64 Reads = 0, Retries = 0, Failed = 0, Torn = 0, WrongSize = 0, WentBackwards = 0;
+	int64 LastFrame = 0;
+	FSharedFrame Copy;
+
+	auto ReadOnce = [&]()
+	{
+		int32 SlotRetries = 0;
+		const bool bRead = Reader.ReadLatest(Copy, SlotRetries);
+		Retries += SlotRetries;
+		if (!bRead)
+		{
+			Failed += (Reader.GetLatestFrameNumber() > 0) ? 1 : 0;
+			return;
+		}
+
+		++Reads;
+		WentBackwards += (Copy.FrameNumber < LastFrame) ? 1 : 0;
+		LastFrame = Copy.FrameNumber;
+		WrongSize += (Copy.Size != StoredSize || Copy.SourceSize != CaptureSize) ? 1 : 0;
+
+		const FColor Expected = PatternFor(Copy.FrameNumber);
+		for (const FColor& Pixel : Copy.Pixels)
+		{
+			if (Pixel != Expected)
+			{
+				++Torn;
+				break;
+			}
+		}
+	};
+
+	while (!bDone)
+	{
+		ReadOnce();
+	}
+	Writer.Wait();
+
+	// The newest frame is never skipped, only the ones it replaced while a copy ran
+	const double Deadline = FPlatformTime::Seconds() + 5.0;
+	while (Reader.GetLatestFrameNumber() != NumFrames && FPlatformTime::Seconds() < Deadline)
+	{
+		FPlatformProcess::Sleep(0.001f);
+	}
+	ReadOnce();
+
+	Bus.GetSharedMemoryInfo(Info);
+	AddInfo(FString::Printf(TEXT("%lld reads, %lld retries, %lld frames written, %lld skipped"),
+		Reads, Retries, Info.FramesWritten, Info.FramesSkipped));
+
+	TestTrue(TEXT("Frames were read"), Reads > 0);
+	TestEqual(TEXT("Reads with torn pixels"), Torn, 0ll);
+	TestEqual(TEXT("Reads with the wrong size"), WrongSize, 0ll);
+	TestEqual(TEXT("Reads that went back in time"), WentBackwards, 0ll);
+	TestEqual(TEXT("Last frame in the ring"), Reader.GetLatestFrameNumber(), NumFrames);
+	TestEqual(TEXT("Last frame read"), LastFrame, NumFrames);
+	TestEqual(TEXT("Every frame written or skipped"), Info.FramesWritten + Info.FramesSkipped, NumFrames);
+	AddInfo(FString::Printf(TEXT("%lld reads gave up after repeated laps"), Failed));
+
+	// Turning the export off waits for the copy worker and unmaps the writer side
+	TestTrue(TEXT("Export disabled"), Bus.SetSharedMemoryExport(0, MaxSize));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
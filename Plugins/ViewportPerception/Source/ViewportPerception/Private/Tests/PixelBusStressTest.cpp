@@ -0,0 +1,173 @@
+// PixelBusStressTest.cpp
+// Hammers FPixelBus with one frame writer, one metadata writer and several
+// readers, and checks that every read is self-consistent: pixels match the
+// frame number, metadata belongs to the frame it came with, frame numbers never
+// go backwards, and a held frame never changes underneath its reader.
+// Run with: Automation RunTests ViewportPerception.PixelBus.Stress
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PixelBus.h"
+#include "Async/Async.h"
+
+namespace PixelBusStress
+{
+	/** Every pixel of frame N encodes N, so a torn or recycled buffer shows up as a mismatch. */
+	static FColor PatternFor(int64 FrameNumber)
+	{
+		return FColor(
+			static_cast<uint8>(FrameNumber & 0xFF),
+			static_cast<uint8>((FrameNumber >> 8) & 0xFF),
+			static_cast<uint8>((FrameNumber >> 16) & 0xFF),
+			255);
+	}
+
+	static bool FrameMatches(const FPerceptionFrame& Frame)
+	{
+		const FColor Expected = PatternFor(Frame.FrameNumber);
+		for (const FColor& Pixel : Frame.Pixels)
+		{
+			if (Pixel != Expected)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPixelBusStressTest, "ViewportPerception.PixelBus.Stress",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter)
+
+bool FPixelBusStressTest::RunTest(const FString& Parameters)
+{
+	using namespace PixelBusStress;
+
+	constexpr int64 NumFrames = 50000;
+	constexpr int32 NumReaders = 4;
+	const FIntPoint Size(64, 64);
+
+	FPixelBus Bus;
+	TAtomic<bool> bDone(false);
+	TAtomic<int64> Written(0);
+	TAtomic<int64> Reads(0);
+	TAtomic<int64> TornPixels(0);
+	TAtomic<int64> WrongMetadata(0);
+	TAtomic<int64> WentBackwards(0);
+	TAtomic<int64> ChangedWhileHeld(0);
+
+	TArray<TFuture<void>> Threads;
+
+	// Frame writer, as fast as the pool allows
+	Threads.Add(Async(EAsyncExecution::Thread, [&]()
+	{
+		for (int64 FrameNumber = 1; FrameNumber <= NumFrames; ++FrameNumber)
+		{
+			FPerceptionFrameRef Frame = Bus.AcquireFrame(Size);
+			if (!Frame.IsValid())
+			{
+				continue;  // Readers hold every buffer; a real producer drops the capture too
+			}
+
+			FPerceptionFrame& Target = Frame.Edit();
+			const FColor Pattern = PatternFor(FrameNumber);
+			for (FColor& Pixel : Target.Pixels)
+			{
+				Pixel = Pattern;
+			}
+			Target.Size = Size;
+			Target.FrameNumber = FrameNumber;
+			Target.Timestamp = FPlatformTime::Seconds();
+
+			Bus.WriteFrame(MoveTemp(Frame));
+			Written.IncrementExchange();
+		}
+		bDone = true;
+	}));
+
+	// Metadata writer, tagging each frame with its own number
+	Threads.Add(Async(EAsyncExecution::Thread, [&]()
+	{
+		while (!bDone)
+		{
+			const int64 FrameNumber = Bus.GetLatestFrameNumber();
+			if (FrameNumber > 0)
+			{
+				FPerceptionMetadata Meta;
+				Meta.ActorCount = static_cast<int32>(FrameNumber);
+				Meta.MapName = FString::Printf(TEXT("Frame_%lld"), FrameNumber);
+				Bus.AttachMetadata(Meta, FrameNumber);
+			}
+		}
+	}));
+
+	for (int32 Reader = 0; Reader < NumReaders; ++Reader)
+	{
+		Threads.Add(Async(EAsyncExecution::Thread, [&]()
+		{
+			int64 LastFrame = 0;
+			while (!bDone)
+			{
+				FPerceptionFrameRef Frame;
+				FPerceptionMetadata Meta;
+				if (!Bus.ReadLatestWithMetadata(Frame, Meta))
+				{
+					continue;
+				}
+
+				Reads.IncrementExchange();
+				const int64 FrameNumber = Frame->FrameNumber;
+
+				if (FrameNumber < LastFrame)
+				{
+					WentBackwards.IncrementExchange();
+				}
+				LastFrame = FrameNumber;
+
+				if (!FrameMatches(*Frame))
+				{
+					TornPixels.IncrementExchange();
+				}
+
+				// Metadata is either not attached yet or belongs to this exact frame
+				if (Meta.ActorCount != 0 &&
+				    (Meta.ActorCount != static_cast<int32>(FrameNumber) ||
+				     Meta.MapName != FString::Printf(TEXT("Frame_%lld"), FrameNumber)))
+				{
+					WrongMetadata.IncrementExchange();
+				}
+
+				// Give the writer time to cycle through the slots, then check the held frame again
+				FPlatformProcess::Yield();
+				if (Frame->FrameNumber != FrameNumber || !FrameMatches(*Frame))
+				{
+					ChangedWhileHeld.IncrementExchange();
+				}
+			}
+		}));
+	}
+
+	for (TFuture<void>& Thread : Threads)
+	{
+		Thread.Wait();
+	}
+
+	const FPerceptionFramePoolStats PoolStats = Bus.GetPoolStats();
+	AddInfo(FString::Printf(TEXT("%lld frames written, %lld reads, %llu publishes, %lld pool exhaustions, %d pooled frames"),
+		Written.Load(), Reads.Load(), Bus.GetPublishCount(), PoolStats.Exhausted, PoolStats.Frames));
+
+	TestTrue(TEXT("Frames were written"), Written.Load() > 0);
+	TestTrue(TEXT("Frames were read"), Reads.Load() > 0);
+	TestEqual(TEXT("Reads with torn pixels"), TornPixels.Load(), 0ll);
+	TestEqual(TEXT("Reads with another frame's metadata"), WrongMetadata.Load(), 0ll);
+	TestEqual(TEXT("Reads that went back in time"), WentBackwards.Load(), 0ll);
+	TestEqual(TEXT("Held frames modified by the writer"), ChangedWhileHeld.Load(), 0ll);
+	TestTrue(TEXT("Latest frame was published"), Bus.GetLatestFrameNumber() > 0);
+	TestTrue(TEXT("Pool stays within its frame limit"), PoolStats.Frames <= PoolStats.MaxFrames);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -7,7 +7,11 @@
 #include "MetadataCollector.h"
 #include "PerceptionAdapter.h"
 #include "PerceptionEndpoint.h"
+#include "PerceptionEncoder.h"
+#include "PerceptionStream.h"
 #include "Editor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Async/Async.h"
 
 void UViewportPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
@@ -17,6 +21,31 @@ void UViewportPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collecti
 	Bus = MakeUnique<FPixelBus>();
 	Collector = MakeUnique<FMetadataCollector>();
 	Endpoint = MakeUnique<FPerceptionEndpoint>(this);
+	Encoder = MakeUnique<FPerceptionEncoder>(Bus.Get());
+	Stream = MakeUnique<FPerceptionStream>(Encoder.Get(), Bus.Get());
+	Pyramid = MakeUnique<FPerceptionPyramid>();
+
+	// Default to half the cores, leaving the rest to the editor
+	SetMaxPixelWorkers(FMath::Max(1, FPlatformMisc::NumberOfCores() / 2));
+
+	SyncEncoderSettings();
+
+	// Parked long polls are answered as packets come out, not polled for
+	TWeakObjectPtr<UViewportPerceptionSubsystem> WeakThis(this);
+	Encoder->SetPublishCallback([WeakThis](int64)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+		{
+			UViewportPerceptionSubsystem* Subsystem = WeakThis.Get();
+			if (Subsystem && Subsystem->Endpoint)
+			{
+				Subsystem->Endpoint->WakeWaiters();
+			}
+		});
+	});
+
+	Encoder->Start();
+	Stream->Start();
 
 	// Register tick for metadata collection (~20Hz)
 	TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(
@@ -36,6 +65,8 @@ void UViewportPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collecti
 void UViewportPerceptionSubsystem::Deinitialize()
 {
 	StopCapture();
+	StopRecording();
+	StopReplay();
 
 	if (Endpoint)
 	{
@@ -44,10 +75,25 @@ void UViewportPerceptionSubsystem::Deinitialize()
 
 	FTSTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
 
+	if (Stream)
+	{
+		Stream->Shutdown();
+	}
+
+	if (Encoder)
+	{
+		Encoder->SetPublishCallback(nullptr);
+		Encoder->Shutdown();
+	}
+
+	// Producer first: it may still be hooked for one-shot tickets and writes to the bus
+	Producer.Reset();
+	Stream.Reset();
+	Encoder.Reset();
 	Endpoint.Reset();
 	Collector.Reset();
+	Pyramid.Reset();
 	Bus.Reset();
-	Producer.Reset();
 
 	UE_LOG(LogViewportPerception, Log, TEXT("Subsystem deinitialized"));
 
@@ -57,6 +103,7 @@ void UViewportPerceptionSubsystem::Deinitialize()
 void UViewportPerceptionSubsystem::StartCapture(float MaxFPS, int32 Width, int32 Height)
 {
 	CaptureResolution = FIntPoint(FMath::Max(Width, 64), FMath::Max(Height, 64));
+	SyncEncoderSettings();
 
 	if (Producer && Bus)
 	{
@@ -75,22 +122,85 @@ void UViewportPerceptionSubsystem::StopCapture()
 		Producer->Stop();
 	}
 	bCapturing = false;
-	bSingleFrameRequested = false;
 }
 
 void UViewportPerceptionSubsystem::RequestSingleFrame()
 {
-	if (!bCapturing)
+	// Nobody waits on this one: file the ticket and let the frame reach the encoder like any
+	// other, instead of encoding a packet no caller will read
+	if (IsReplaying() || !Producer || !Bus)
 	{
-		// Temporarily start capture
-		StartCapture(30.0f, CaptureResolution.X, CaptureResolution.Y);
-		bSingleFrameRequested = true;
+		return;
 	}
+
+	TWeakObjectPtr<UViewportPerceptionSubsystem> WeakThis(this);
+	Producer->RequestCapture(Bus.Get()).Next([WeakThis](int64)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+		{
+			UViewportPerceptionSubsystem* Subsystem = WeakThis.Get();
+			if (Subsystem && Subsystem->Producer)
+			{
+				Subsystem->Producer->ReleaseIdleHook();
+			}
+		});
+	});
+}
+
+TFuture<FPerceptionPacket> UViewportPerceptionSubsystem::CaptureSingleFrame()
+{
+	TSharedRef<TPromise<FPerceptionPacket>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FPerceptionPacket>, ESPMode::ThreadSafe>();
+	TFuture<FPerceptionPacket> Result = Promise->GetFuture();
+
+	// A replay has nothing to capture; the frame under the playhead is what is "on screen"
+	if (IsReplaying())
+	{
+		Promise->SetValue(GetLatestPacket());
+		return Result;
+	}
+
+	if (!Producer || !Bus)
+	{
+		Promise->SetValue(FPerceptionPacket());
+		return Result;
+	}
+
+	SyncEncoderSettings();
+
+	TWeakObjectPtr<UViewportPerceptionSubsystem> WeakThis(this);
+	Producer->RequestCapture(Bus.Get()).Next([WeakThis, Promise](int64 CapturedFrame)
+	{
+		// Resolved on the render thread; read and encode on the game thread
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Promise, CapturedFrame]()
+		{
+			FPerceptionPacket Packet;
+			if (UViewportPerceptionSubsystem* Subsystem = WeakThis.Get())
+			{
+				if (CapturedFrame > 0)
+				{
+					// The latest frame is the captured one or newer; concurrent requests hit the packet cache.
+					// It was asked for, so MinSceneChange must not swap it for an older published packet.
+					Subsystem->AttachMetadataToLatest();
+					Packet = Subsystem->ReadLatestPacket(Subsystem->CaptureResolution, Subsystem->ImageFormat,
+					                                     Subsystem->JPEGQuality, FIntRect(), false, false);
+				}
+
+				if (Subsystem->Producer)
+				{
+					Subsystem->Producer->ReleaseIdleHook();
+				}
+			}
+			Promise->SetValue(MoveTemp(Packet));
+		});
+	});
+
+	return Result;
 }
 
 void UViewportPerceptionSubsystem::SetCaptureResolution(int32 Width, int32 Height)
 {
 	CaptureResolution = FIntPoint(FMath::Max(Width, 64), FMath::Max(Height, 64));
+	SyncEncoderSettings();
 }
 
 void UViewportPerceptionSubsystem::SetMaxCaptureRate(float FPS)
@@ -104,42 +214,435 @@ void UViewportPerceptionSubsystem::SetMaxCaptureRate(float FPS)
 void UViewportPerceptionSubsystem::SetImageFormat(EPerceptionImageFormat Format)
 {
 	ImageFormat = Format;
+	SyncEncoderSettings();
 }
 
 void UViewportPerceptionSubsystem::SetJPEGQuality(int32 Quality)
 {
 	JPEGQuality = FMath::Clamp(Quality, 1, 100);
+	SyncEncoderSettings();
+}
+
+void UViewportPerceptionSubsystem::SetMaxPixelWorkers(int32 Workers)
+{
+	// Task-graph workers plus the calling thread
+	const int32 Available = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	MaxPixelWorkers = FMath::Clamp(Workers, 1, Available);
+	SyncEncoderSettings();
+}
+
+void UViewportPerceptionSubsystem::SetFramePoolLimits(int32 MaxFrames, int32 BudgetMB)
+{
+	if (Bus)
+	{
+		Bus->SetPoolLimits(MaxFrames, static_cast<int64>(FMath::Max(BudgetMB, 1)) * 1024 * 1024);
+	}
+}
+
+void UViewportPerceptionSubsystem::SetImageStatsEnabled(bool bEnable)
+{
+	bImageStats = bEnable;
+	SyncEncoderSettings();
+}
+
+void UViewportPerceptionSubsystem::SetMotionEnabled(bool bEnable)
+{
+	bMotion = bEnable;
+	SyncEncoderSettings();
+}
+
+void UViewportPerceptionSubsystem::SetMinSceneChange(float Threshold)
+{
+	MinSceneChange = FMath::Clamp(Threshold, 0.0f, 1.0f);
+	SyncEncoderSettings();
+}
+
+void UViewportPerceptionSubsystem::SetHistoryLimits(float Seconds, int32 BudgetMB)
+{
+	if (Encoder)
+	{
+		Encoder->GetHistory().Configure(static_cast<int64>(FMath::Max(BudgetMB, 0)) * 1024 * 1024,
+		                                FMath::Max(Seconds, 0.0f));
+	}
+}
+
+void UViewportPerceptionSubsystem::SetPyramidLevels(int32 Levels, int32 ThumbnailWidth)
+{
+	if (Pyramid)
+	{
+		Pyramid->Configure(Levels, ThumbnailWidth);
+	}
+}
+
+bool UViewportPerceptionSubsystem::SetSharedMemoryExport(bool bEnable, int32 MaxWidth, int32 MaxHeight, int32 Slots)
+{
+	if (!Bus)
+	{
+		return false;
+	}
+
+	return Bus->SetSharedMemoryExport(bEnable ? Slots : 0, FIntPoint(MaxWidth, MaxHeight));
+}
+
+bool UViewportPerceptionSubsystem::StartRecording(const FString& Directory, int32 SegmentMB)
+{
+	return Encoder && Encoder->GetRecorder().Start(Directory, static_cast<int64>(FMath::Max(SegmentMB, 1)) * 1024 * 1024);
+}
+
+void UViewportPerceptionSubsystem::StopRecording()
+{
+	if (Encoder)
+	{
+		Encoder->GetRecorder().Shutdown();
+	}
+}
+
+bool UViewportPerceptionSubsystem::IsRecording() const
+{
+	return Encoder && Encoder->GetRecorder().IsRecording();
+}
+
+bool UViewportPerceptionSubsystem::StartReplay(const FString& Directory, float Speed)
+{
+	TSharedPtr<FPerceptionReplay, ESPMode::ThreadSafe> NewReplay = MakeShared<FPerceptionReplay, ESPMode::ThreadSafe>();
+	if (!NewReplay->Open(Directory))
+	{
+		return false;
+	}
+
+	NewReplay->Play(Speed);
+	Replay = MoveTemp(NewReplay);
+	if (Stream)
+	{
+		Stream->SetReplay(Replay);
+	}
+	LastSeenFrame = 0;
+	return true;
+}
+
+void UViewportPerceptionSubsystem::StopReplay()
+{
+	// The stream thread may still be reading it; the last reference closes it
+	if (Stream)
+	{
+		Stream->SetReplay(nullptr);
+	}
+	Replay.Reset();
+	LastSeenFrame = 0;
+}
+
+bool UViewportPerceptionSubsystem::IsReplaying() const
+{
+	return Replay.IsValid() && Replay->IsOpen();
+}
+
+bool UViewportPerceptionSubsystem::GetRecorderStats(FPerceptionRecorderStats& OutStats) const
+{
+	if (!Encoder)
+	{
+		return false;
+	}
+
+	OutStats = Encoder->GetRecorder().GetStats();
+	return true;
+}
+
+bool UViewportPerceptionSubsystem::GetReplayStats(FPerceptionReplayStats& OutStats) const
+{
+	if (!IsReplaying())
+	{
+		return false;
+	}
+
+	OutStats = Replay->GetStats();
+	return true;
+}
+
+void UViewportPerceptionSubsystem::SyncEncoderSettings()
+{
+	if (Encoder)
+	{
+		FPerceptionEncodeSettings Settings;
+		Settings.Resolution = CaptureResolution;
+		Settings.Format = ImageFormat;
+		Settings.Quality = JPEGQuality;
+		Settings.MaxWorkers = MaxPixelWorkers;
+		Settings.MinSceneChange = MinSceneChange;
+		Settings.bImageStats = bImageStats;
+		Settings.bMotion = bMotion;
+		Encoder->Configure(Settings);
+	}
+}
+
+void UViewportPerceptionSubsystem::RefreshMetadata(FPerceptionPacket& Packet) const
+{
+	// Metadata is attached on the game tick and may have arrived after the encode
+	FPerceptionMetadata Meta;
+	int64 MetaFrame = 0;
+	if (Bus && Bus->ReadLatestMetadata(Meta, MetaFrame) && MetaFrame == Packet.FrameNumber)
+	{
+		// Image stats and motion come from the encode, not the bus
+		Meta.CopyEncodeResults(Packet.Metadata);
+		Packet.Metadata = MoveTemp(Meta);
+	}
 }
 
 FPerceptionPacket UViewportPerceptionSubsystem::GetLatestPacket()
+{
+	return GetLatestPacket(CaptureResolution, ImageFormat, JPEGQuality);
+}
+
+FPerceptionPacket UViewportPerceptionSubsystem::GetLatestPacket(FIntPoint Resolution, EPerceptionImageFormat Format, int32 Quality,
+                                                               const FIntRect& Region)
+{
+	return ReadLatestPacket(Resolution, Format, Quality, Region, true, false);
+}
+
+FPerceptionPacket UViewportPerceptionSubsystem::ReadLatestPacket(FIntPoint Resolution, EPerceptionImageFormat Format, int32 Quality,
+                                                                const FIntRect& Region, bool bServeHeldBack, bool bFromPyramid)
 {
 	FPerceptionPacket Packet;
 
-	if (!Bus)
+	// Replayed packets are served as recorded
+	if (IsReplaying())
+	{
+		Replay->GetCurrentPacket(Packet);
+		LastSeenFrame = Packet.FrameNumber;
+		return Packet;
+	}
+
+	if (!Bus || Resolution.X <= 0 || Resolution.Y <= 0)
 	{
 		return Packet;
 	}
 
-	TArray<FColor> RawPixels;
-	FIntPoint RawSize;
+	FPacketCacheKey Key;
+	Key.FrameNumber = Bus->GetLatestFrameNumber();
+	Key.Resolution = Resolution;
+	Key.Format = Format;
+	Key.Quality = FPerceptionEncodeSettings::NormalizeQuality(Format, Quality);
+	Key.Region = Region;
+
+	if (Key.FrameNumber <= 0)
+	{
+		return Packet;
+	}
+
+	// Fast path: the encoder stage already published this frame with these settings, or
+	// held it back as too similar to the one it did publish
+	if (Encoder && Region.IsEmpty())
+	{
+		TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> Ready = Encoder->GetLatest();
+		if (Ready.IsValid()
+			&& (Ready->Packet.FrameNumber == Key.FrameNumber
+				|| (bServeHeldBack && Encoder->GetLastSuppressedFrame() == Key.FrameNumber))
+			&& Ready->Settings.Resolution == Key.Resolution
+			&& Ready->Settings.Format == Key.Format
+			&& Ready->Settings.Quality == Key.Quality)
+		{
+			Packet = Ready->Packet;
+			RefreshMetadata(Packet);
+			LastSeenFrame = Packet.FrameNumber;
+			return Packet;
+		}
+	}
+
+	// Otherwise encode on request (encoder still busy, or settings differ from the capture settings).
+	// The lock covers lookups and inserts only; concurrent pollers of the same rendition wait on
+	// the one encode in flight for it, and other renditions encode alongside.
+	TSharedPtr<TPromise<FPerceptionPacket>, ESPMode::ThreadSafe> Promise;
+	TSharedFuture<FPerceptionPacket> InFlight;
+	{
+		FScopeLock CacheLock(&PacketCacheLock);
+
+		const int32 HitIndex = PacketCache.IndexOfByPredicate([&Key](const FPacketCacheEntry& Entry)
+		{
+			return Entry.Key == Key;
+		});
+
+		if (HitIndex != INDEX_NONE)
+		{
+			FPacketCacheEntry Entry = MoveTemp(PacketCache[HitIndex]);
+			PacketCache.RemoveAt(HitIndex);
+			Packet = Entry.Packet;
+			PacketCache.Add(MoveTemp(Entry));
+			++PacketCacheHits;
+		}
+		else if (const TSharedFuture<FPerceptionPacket>* Pending = PacketsInFlight.Find(Key))
+		{
+			InFlight = *Pending;
+			++PacketCacheHits;
+		}
+		else
+		{
+			Promise = MakeShared<TPromise<FPerceptionPacket>, ESPMode::ThreadSafe>();
+			PacketsInFlight.Add(Key, Promise->GetFuture().Share());
+			++PacketCacheMisses;
+		}
+	}
+
+	if (InFlight.IsValid())
+	{
+		Packet = InFlight.Get();
+
+		// A capture must not take a held-back stand-in from a caller that accepts one
+		if (!bServeHeldBack && Packet.FrameNumber < Key.FrameNumber)
+		{
+			Packet = EncodeLatestPacket(Key, bServeHeldBack, bFromPyramid);
+			return Packet;
+		}
+	}
+
+	if (Packet.bValid)
+	{
+		RefreshMetadata(Packet);
+		LastSeenFrame = Packet.FrameNumber;
+		return Packet;
+	}
+
+	if (!Promise.IsValid())
+	{
+		return Packet;
+	}
+
+	Packet = EncodeLatestPacket(Key, bServeHeldBack, bFromPyramid);
+	{
+		FScopeLock CacheLock(&PacketCacheLock);
+		PacketsInFlight.Remove(Key);
+	}
+	Promise->SetValue(Packet);
+	return Packet;
+}
+
+FPerceptionPacket UViewportPerceptionSubsystem::EncodeLatestPacket(FPacketCacheKey Key, bool bServeHeldBack, bool bFromPyramid)
+{
+	FPerceptionPacket Packet;
+	const FIntPoint Resolution = Key.Resolution;
+	const EPerceptionImageFormat Format = Key.Format;
+	const FIntRect Region = Key.Region;
+
+	FPerceptionFrameRef Frame;
 	FPerceptionMetadata Meta;
-	int64 FrameNum;
-	double Timestamp;
 
-	if (!Bus->ReadLatestWithMetadata(RawPixels, RawSize, Meta, FrameNum, Timestamp))
+	if (!Bus->ReadLatestWithMetadata(Frame, Meta))
+	{
+		return Packet;
+	}
+
+	const int64 FrameNum = Frame->FrameNumber;
+	const double Timestamp = Frame->Timestamp;
+
+	TSharedPtr<const FPerceptionChanges, ESPMode::ThreadSafe> Changes = Bus->GetChangeTracker().Update(*Frame);
+	const uint64 PerceptualHash = FPerceptionAdapter::ComputePerceptualHash(Frame->Pixels, Frame->Size);
+
+	// Scored against what the encoder last published, as its own packets are
+	TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> Published = Encoder ? Encoder->GetLatest() : nullptr;
+	const float SceneChange = Published.IsValid()
+		? FPerceptionAdapter::CompareHashes(PerceptualHash, static_cast<uint64>(Published->Packet.PerceptualHash))
+		: 1.0f;
+
+	// MinSceneChange governs the capture-settings rendition whether or not the encoder got to the
+	// frame first, so a frame it would hold back is answered with the published packet here too.
+	// Other renditions and regions always show the latest frame, with SceneChange to filter on.
+	if (bServeHeldBack && MinSceneChange > 0.0f && Region.IsEmpty() && Published.IsValid()
+		&& SceneChange <= MinSceneChange
+		&& Published->Settings.Resolution == Key.Resolution
+		&& Published->Settings.Format == Key.Format
+		&& Published->Settings.Quality == Key.Quality)
 	{
+		Packet = Published->Packet;
+		RefreshMetadata(Packet);
+		LastSeenFrame = Packet.FrameNumber;
 		return Packet;
 	}
 
 	LastSeenFrame = FrameNum;
+	if (bMotion)
+	{
+		Meta.Motion = Bus->GetMotionEstimator().Update(*Frame, MaxPixelWorkers);
+	}
 
-	// Resize if needed
-	TArray<FColor> Pixels = (RawSize != CaptureResolution)
-		? FPerceptionAdapter::Resize(RawPixels, RawSize, CaptureResolution)
-		: MoveTemp(RawPixels);
+	// No tile changed since a frame we still hold an encode of: reuse its image
+	TArray<uint8> Encoded;
+	if (Changes.IsValid() && Changes->bUnchanged)
+	{
+		FScopeLock CacheLock(&PacketCacheLock);
+		const FPacketCacheEntry* Base = PacketCache.FindByPredicate([&Key, &Changes](const FPacketCacheEntry& Entry)
+		{
+			return Entry.Key.FrameNumber == Changes->BaseFrame && Entry.Key.IsSameRendition(Key);
+		});
+		if (Base)
+		{
+			Encoded = Base->Packet.ImageData;
+			Meta.ImageStats = Base->Packet.Metadata.ImageStats;
+		}
+	}
 
-	// Encode
-	TArray<uint8> Encoded = FPerceptionAdapter::Encode(Pixels, CaptureResolution, ImageFormat, JPEGQuality);
+	if (Encoded.Num() == 0)
+	{
+		// Pyramid requests start from the frame's pyramid, built once and shared by every level
+		// requested for it: a level is used as is, anything else is resized from the smallest level
+		// that covers it. Other sizes resize from the frame; its own size encodes straight from
+		// the shared frame.
+		const TArray<FColor>* Source = &Frame->Pixels;
+		FIntPoint SourceSize = Frame->Size;
+		TSharedPtr<const FPerceptionPyramidLevels, ESPMode::ThreadSafe> Levels;
+
+		// Regions are cut from the captured frame itself, so they keep its full detail
+		TArray<FColor> Cropped;
+		if (!Region.IsEmpty())
+		{
+			FIntRect Clipped = Region;
+			Clipped.Clip(FIntRect(FIntPoint::ZeroValue, Frame->Size));
+			Cropped = FPerceptionAdapter::Crop(Frame->Pixels, Frame->Size, Clipped);
+			if (Cropped.Num() == 0)
+			{
+				return Packet;
+			}
+			Source = &Cropped;
+			SourceSize = Clipped.Size();
+		}
+		else if (bFromPyramid && Pyramid && Frame->Size != Resolution
+			&& Resolution.X <= Frame->Size.X && Resolution.Y <= Frame->Size.Y)
+		{
+			// The encoder's resize of this frame saves level 1 a pass over the full frame
+			const bool bSeed = Published.IsValid() && Published->Packet.FrameNumber == FrameNum && Published->ResizedPixels.IsValid();
+			Levels = Pyramid->Build(*Frame, bSeed ? Published->ResizedPixels.Get() : nullptr,
+			                        bSeed ? Published->Settings.Resolution : FIntPoint::ZeroValue, MaxPixelWorkers);
+		}
+		if (Levels.IsValid())
+		{
+			// Level 0 holds no pixels of its own; the frame already stands for it
+			for (int32 Level = Levels->Num() - 1; Level > 0; --Level)
+			{
+				const FPerceptionPyramidLevel& Candidate = (*Levels)[Level];
+				if (Candidate.Size.X >= Resolution.X && Candidate.Size.Y >= Resolution.Y)
+				{
+					Source = &Candidate.Pixels;
+					SourceSize = Candidate.Size;
+					break;
+				}
+			}
+		}
+
+		TArray<FColor> Resized;
+		const bool bResize = (SourceSize != Resolution);
+		if (bResize)
+		{
+			Resized = FPerceptionAdapter::Resize(*Source, SourceSize, Resolution, MaxPixelWorkers);
+		}
+
+		if (bImageStats)
+		{
+			Meta.ImageStats = FPerceptionAdapter::ComputeImageStats(bResize ? Resized : *Source,
+			                                                        Resolution, MaxPixelWorkers);
+		}
+
+		// Encode
+		Encoded = FPerceptionAdapter::Encode(bResize ? Resized : *Source,
+		                                     Resolution, Format, Key.Quality, MaxPixelWorkers);
+	}
+	Frame.Reset();
 
 	if (Encoded.Num() == 0)
 	{
@@ -147,17 +650,270 @@ FPerceptionPacket UViewportPerceptionSubsystem::GetLatestPacket()
 	}
 
 	Packet.ImageData = MoveTemp(Encoded);
-	Packet.Width = CaptureResolution.X;
-	Packet.Height = CaptureResolution.Y;
-	Packet.Format = ImageFormat;
+	Packet.Width = Resolution.X;
+	Packet.Height = Resolution.Y;
+	Packet.Region = Region;
+	Packet.Format = Format;
 	Packet.FrameNumber = FrameNum;
 	Packet.Timestamp = Timestamp;
 	Packet.Metadata = Meta;
+	Packet.PerceptualHash = static_cast<int64>(PerceptualHash);
+	if (Changes.IsValid())
+	{
+		Packet.Changes = *Changes;
+	}
 	Packet.bValid = true;
+	if (Published.IsValid())
+	{
+		Packet.SceneChange = SceneChange;
+	}
+
+	// The bus may have advanced since the key was built; file the packet under the frame actually read
+	Key.FrameNumber = FrameNum;
+	{
+		FScopeLock CacheLock(&PacketCacheLock);
+
+		// Only the latest frame can hit; an encode that finished late doesn't evict newer entries
+		PacketCache.RemoveAll([FrameNum](const FPacketCacheEntry& Entry)
+		{
+			return Entry.Key.FrameNumber < FrameNum;
+		});
+		if (!PacketCache.ContainsByPredicate([FrameNum](const FPacketCacheEntry& Entry) { return Entry.Key.FrameNumber > FrameNum; }))
+		{
+			if (PacketCache.Num() >= PacketCacheCapacity)
+			{
+				PacketCache.RemoveAt(0);
+			}
+			PacketCache.Add({ Key, Packet });
+		}
+	}
 
 	return Packet;
 }
 
+FPerceptionPacket UViewportPerceptionSubsystem::GetPyramidPacket(int32 Level)
+{
+	const TArray<FIntPoint> Sizes = GetPyramidLevelSizes();
+	if (IsReplaying() || Sizes.Num() == 0)
+	{
+		return GetLatestPacket();
+	}
+
+	return ReadLatestPacket(Sizes[FMath::Clamp(Level, 0, Sizes.Num() - 1)], ImageFormat, JPEGQuality, FIntRect(), true, true);
+}
+
+FPerceptionPacket UViewportPerceptionSubsystem::GetRegionPacket(const FIntRect& Region, int32 OutputWidth)
+{
+	FPerceptionFrameRef Frame;
+	if (IsReplaying() || !Bus || !Bus->ReadLatest(Frame))
+	{
+		return FPerceptionPacket();
+	}
+
+	// Clipped here so the cache key and the packet both name the pixels actually served
+	FIntRect Clipped = Region;
+	Clipped.Clip(FIntRect(FIntPoint::ZeroValue, Frame->Size));
+	Frame.Reset();
+
+	if (Clipped.IsEmpty())
+	{
+		return FPerceptionPacket();
+	}
+
+	const int32 Width = (OutputWidth > 0) ? FMath::Min(OutputWidth, Clipped.Width()) : Clipped.Width();
+	const int32 Height = FMath::Max(1, FMath::RoundToInt32(static_cast<double>(Clipped.Height()) * Width / Clipped.Width()));
+	return GetLatestPacket(FIntPoint(Width, Height), ImageFormat, JPEGQuality, Clipped);
+}
+
+bool UViewportPerceptionSubsystem::GetSelectionRegion(FIntRect& OutRegion) const
+{
+	FBox2D Selection(ForceInit);
+	{
+		FScopeLock ScopeLock(&SelectionLock);
+		Selection = LastSelectionBounds;
+	}
+
+	FPerceptionFrameRef Frame;
+	if (!Selection.bIsValid || !Bus || !Bus->ReadLatest(Frame))
+	{
+		return false;
+	}
+
+	const FVector2D FrameSize(Frame->Size);
+	FBox2D Bounds(Selection.Min * FrameSize, Selection.Max * FrameSize);
+	Bounds = Bounds.ExpandBy(FMath::Max(Bounds.GetSize().GetMax() * SelectionPadding, static_cast<double>(MinSelectionPadding)));
+
+	OutRegion = FIntRect(
+		FIntPoint(FMath::FloorToInt32(Bounds.Min.X), FMath::FloorToInt32(Bounds.Min.Y)),
+		FIntPoint(FMath::CeilToInt32(Bounds.Max.X), FMath::CeilToInt32(Bounds.Max.Y)));
+	OutRegion.Clip(FIntRect(FIntPoint::ZeroValue, Frame->Size));
+	return !OutRegion.IsEmpty();
+}
+
+FIntPoint UViewportPerceptionSubsystem::GetLatestFrameSize() const
+{
+	FPerceptionFrameRef Frame;
+	return (Bus && Bus->ReadLatest(Frame)) ? Frame->Size : FIntPoint::ZeroValue;
+}
+
+TArray<FIntPoint> UViewportPerceptionSubsystem::GetPyramidLevelSizes() const
+{
+	return Pyramid ? Pyramid->GetLevelSizes(GetLatestFrameSize()) : TArray<FIntPoint>();
+}
+
+int32 UViewportPerceptionSubsystem::FindPyramidLevel(int32 Width) const
+{
+	return Pyramid ? Pyramid->FindLevelForWidth(GetLatestFrameSize(), Width) : 0;
+}
+
+bool UViewportPerceptionSubsystem::GetPyramidStats(FPerceptionPyramidStats& OutStats) const
+{
+	if (!Pyramid)
+	{
+		return false;
+	}
+
+	OutStats = Pyramid->GetStats();
+	return true;
+}
+
+int64 UViewportPerceptionSubsystem::GetLatestPacketFrameNumber() const
+{
+	if (IsReplaying())
+	{
+		return Replay->GetCurrentFrameNumber();
+	}
+
+	if (Encoder && Encoder->IsRunning())
+	{
+		TSharedPtr<const FPerceptionEncodedFrame, ESPMode::ThreadSafe> Ready = Encoder->GetLatest();
+		return Ready.IsValid() ? Ready->Packet.FrameNumber : 0;
+	}
+
+	return Bus ? Bus->GetLatestFrameNumber() : 0;
+}
+
+bool UViewportPerceptionSubsystem::GetChangesSince(int64 SinceFrame, FPerceptionChanges& OutChanges, int64& OutFrameNumber)
+{
+	// Recordings keep each packet's own changes only
+	if (IsReplaying())
+	{
+		FPerceptionPacket Packet;
+		if (!Replay->GetCurrentPacket(Packet))
+		{
+			return false;
+		}
+		OutChanges = Packet.Changes;
+		OutFrameNumber = Packet.FrameNumber;
+		return true;
+	}
+
+	if (!Bus)
+	{
+		return false;
+	}
+
+	FPerceptionFrameRef Frame;
+	if (Bus->ReadLatest(Frame))
+	{
+		Bus->GetChangeTracker().Update(*Frame);
+	}
+
+	return Bus->GetChangeTracker().GetChangesSince(SinceFrame, OutChanges, OutFrameNumber);
+}
+
+bool UViewportPerceptionSubsystem::GetHistoryPacket(int64 FrameNumber, FPerceptionPacket& OutPacket) const
+{
+	if (IsReplaying())
+	{
+		return Replay->GetPacketByFrame(FrameNumber, OutPacket);
+	}
+
+	return Encoder && Encoder->GetHistory().FindByFrame(FrameNumber, OutPacket);
+}
+
+bool UViewportPerceptionSubsystem::GetHistoryPacketAt(double Timestamp, FPerceptionPacket& OutPacket) const
+{
+	if (IsReplaying())
+	{
+		return Replay->GetPacketAt(Timestamp, OutPacket);
+	}
+
+	return Encoder && Encoder->GetHistory().FindByTime(Timestamp, OutPacket);
+}
+
+double UViewportPerceptionSubsystem::GetPacketClock() const
+{
+	return IsReplaying() ? Replay->GetCurrentTimestamp() : FPlatformTime::Seconds();
+}
+
+bool UViewportPerceptionSubsystem::GetHistoryEntries(TArray<FPerceptionHistoryEntryInfo>& OutEntries) const
+{
+	if (!Encoder)
+	{
+		return false;
+	}
+
+	Encoder->GetHistory().GetEntries(OutEntries);
+	return true;
+}
+
+bool UViewportPerceptionSubsystem::GetHistoryStats(FPerceptionHistoryStats& OutStats) const
+{
+	if (!Encoder)
+	{
+		return false;
+	}
+
+	OutStats = Encoder->GetHistory().GetStats();
+	return true;
+}
+
+bool UViewportPerceptionSubsystem::GetFramePoolStats(FPerceptionFramePoolStats& OutStats) const
+{
+	if (!Bus)
+	{
+		return false;
+	}
+
+	OutStats = Bus->GetPoolStats();
+	return true;
+}
+
+bool UViewportPerceptionSubsystem::GetEncoderStats(FPerceptionEncoderStats& OutStats) const
+{
+	if (!Encoder)
+	{
+		return false;
+	}
+
+	OutStats = Encoder->GetStats();
+	return true;
+}
+
+bool UViewportPerceptionSubsystem::GetSharedMemoryInfo(FPerceptionSharedMemoryInfo& OutInfo) const
+{
+	return Bus && Bus->GetSharedMemoryInfo(OutInfo);
+}
+
+bool UViewportPerceptionSubsystem::GetStreamStats(FPerceptionStreamStats& OutStats) const
+{
+	if (!IsStreamAvailable())
+	{
+		return false;
+	}
+
+	OutStats = Stream->GetStats();
+	return true;
+}
+
+void UViewportPerceptionSubsystem::GetPacketCacheStats(int64& OutHits, int64& OutMisses) const
+{
+	FScopeLock CacheLock(&PacketCacheLock);
+	OutHits = PacketCacheHits;
+	OutMisses = PacketCacheMisses;
+}
+
 bool UViewportPerceptionSubsystem::IsCapturing() const
 {
 	return bCapturing && Producer && Producer->IsActive();
@@ -165,29 +921,56 @@ bool UViewportPerceptionSubsystem::IsCapturing() const
 
 bool UViewportPerceptionSubsystem::HasNewFrame() const
 {
+	if (IsReplaying())
+	{
+		return Replay->GetCurrentFrameNumber() > LastSeenFrame;
+	}
+
+	// Frames held back by MinSceneChange aren't new: they are answered with the packet already seen
+	if (MinSceneChange > 0.0f && Encoder && Encoder->IsRunning())
+	{
+		return GetLatestPacketFrameNumber() > LastSeenFrame;
+	}
+
 	return Bus && Bus->HasNewFrame(LastSeenFrame);
 }
 
 void UViewportPerceptionSubsystem::OnTick(float DeltaTime)
 {
-	if (!bCapturing || !Bus || !Collector)
+	// Not gated on bCapturing: one-shot captures land on the bus too
+	AttachMetadataToLatest();
+
+	// A replay's playhead moves with time rather than through the encoder
+	if (IsReplaying() && Endpoint)
 	{
-		return;
+		Endpoint->WakeWaiters();
 	}
+}
 
-	// Attach metadata to the latest frame
-	if (Bus->HasNewFrame(LastSeenFrame))
+void UViewportPerceptionSubsystem::AttachMetadataToLatest()
+{
+	if (!Bus || !Collector)
 	{
-		FPerceptionMetadata Meta = Collector->Collect();
-		Bus->AttachMetadata(Meta);
+		return;
 	}
 
-	// Handle single-frame request
-	if (bSingleFrameRequested && Bus->GetLatestFrameNumber() > 0)
+	// Attach metadata to the latest frame, once per frame
+	const int64 LatestFrame = Bus->GetLatestFrameNumber();
+	if (LatestFrame > LastMetadataFrame)
 	{
-		// Frame captured, stop
-		bSingleFrameRequested = false;
-		// Don't stop here -- let the endpoint read it first
-		// StopCapture will be called by the endpoint after reading
+		FPerceptionMetadata Meta = Collector->Collect();
+		{
+			FScopeLock ScopeLock(&SelectionLock);
+			LastSelectionBounds = Meta.SelectionBounds;
+		}
+
+		if (Bus->AttachMetadata(Meta, LatestFrame))
+		{
+			LastMetadataFrame = LatestFrame;
+			if (Encoder)
+			{
+				Encoder->AttachMetadata(Meta, LatestFrame);
+			}
+		}
 	}
 }
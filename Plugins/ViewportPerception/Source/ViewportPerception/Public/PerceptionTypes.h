@@ -14,6 +14,20 @@ enum class EPerceptionImageFormat : uint8
 	PNG  UMETA(DisplayName = "PNG")
 };
 
+/** What kind of motion dominated between two frames. */
+UENUM(BlueprintType)
+enum class EPerceptionMotionKind : uint8
+{
+	/** Nothing moved */
+	Static UMETA(DisplayName = "Static"),
+	/** The whole view moved together: a camera pan, orbit or dolly */
+	Camera UMETA(DisplayName = "Camera"),
+	/** The view held still while parts of the scene changed */
+	Scene  UMETA(DisplayName = "Scene"),
+	/** Camera motion plus independent scene changes */
+	Mixed  UMETA(DisplayName = "Mixed")
+};
+
 /** Camera state at the moment of capture. */
 USTRUCT(BlueprintType)
 struct FPerceptionCamera
@@ -30,6 +44,89 @@ struct FPerceptionCamera
 	float FOV = 90.0f;
 };
 
+/** Pixel statistics of the served (downscaled) image, so clients can judge a frame without decoding it. */
+USTRUCT(BlueprintType)
+struct FPerceptionImageStats
+{
+	GENERATED_BODY()
+
+	/** False unless image statistics are enabled. */
+	UPROPERTY(BlueprintReadOnly)
+	bool bValid = false;
+
+	/** Mean per channel, 0-1 (X = red, Y = green, Z = blue). */
+	UPROPERTY(BlueprintReadOnly)
+	FVector Mean = FVector::ZeroVector;
+
+	/** Variance per channel, in the same 0-1 units. */
+	UPROPERTY(BlueprintReadOnly)
+	FVector Variance = FVector::ZeroVector;
+
+	/** Mean Rec. 601 luma, 0-1. */
+	UPROPERTY(BlueprintReadOnly)
+	float MeanLuma = 0.0f;
+
+	/** Fraction of pixels per luma bin; bin i covers 8-bit luma [8i, 8i + 8). */
+	UPROPERTY(BlueprintReadOnly)
+	TArray<float> LumaHistogram;
+
+	/** Fraction of pixels where |dx| + |dy| of luma is at least 24 (of 255). */
+	UPROPERTY(BlueprintReadOnly)
+	float EdgeDensity = 0.0f;
+
+	/** Fraction of pixels with luma of 250 or more. */
+	UPROPERTY(BlueprintReadOnly)
+	float Overexposed = 0.0f;
+
+	/** Fraction of pixels with luma of 5 or less. */
+	UPROPERTY(BlueprintReadOnly)
+	float Underexposed = 0.0f;
+};
+
+/** Block-motion summary between the previous analyzed frame and this one. */
+USTRUCT(BlueprintType)
+struct FPerceptionMotion
+{
+	GENERATED_BODY()
+
+	/** False unless motion estimation is enabled and the previous frame had the same size. */
+	UPROPERTY(BlueprintReadOnly)
+	bool bValid = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 BaseFrame = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	EPerceptionMotionKind Kind = EPerceptionMotionKind::Static;
+
+	/** Global translation of the view, in capture pixels (content moved by this much). */
+	UPROPERTY(BlueprintReadOnly)
+	FVector2D CameraTranslation = FVector2D::ZeroVector;
+
+	/** Global scale change around the frame centre: 0.02 means content grew by 2% (dolly in). */
+	UPROPERTY(BlueprintReadOnly)
+	float CameraZoom = 0.0f;
+
+	/** Fraction of textured blocks that follow the global motion. */
+	UPROPERTY(BlueprintReadOnly)
+	float Coherence = 0.0f;
+
+	/** Fraction of textured blocks that moved on their own or found no match (new content). */
+	UPROPERTY(BlueprintReadOnly)
+	float LocalMotion = 0.0f;
+
+	/** Block edge in capture pixels. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 BlockSize = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+
+	/** Per block, row-major, in capture pixels; zero for flat or unmatched blocks. */
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FIntPoint> Vectors;
+};
+
 /** Scene context at the moment of capture. */
 USTRUCT(BlueprintType)
 struct FPerceptionMetadata
@@ -51,6 +148,11 @@ struct FPerceptionMetadata
 	UPROPERTY(BlueprintReadOnly)
 	TArray<FString> SelectedActors;
 
+	/** Screen bounds of the selected actors as fractions of the viewport (0 to 1), clipped to it.
+	 *  Invalid if nothing is selected or no part of the selection is in front of the camera. */
+	UPROPERTY(BlueprintReadOnly)
+	FBox2D SelectionBounds = FBox2D(ForceInit);
+
 	UPROPERTY(BlueprintReadOnly)
 	FString MapName;
 
@@ -63,6 +165,64 @@ struct FPerceptionMetadata
 
 	UPROPERTY(BlueprintReadOnly)
 	float FPS = 0.0f;
+
+	// Image, filled by the encode stage rather than the collector
+	UPROPERTY(BlueprintReadOnly)
+	FPerceptionImageStats ImageStats;
+
+	UPROPERTY(BlueprintReadOnly)
+	FPerceptionMotion Motion;
+
+	/** Take the encode-stage fields from Other, e.g. when refreshing collector fields from the bus. */
+	void CopyEncodeResults(const FPerceptionMetadata& Other)
+	{
+		ImageStats = Other.ImageStats;
+		Motion = Other.Motion;
+	}
+};
+
+/** Which parts of a frame changed since an earlier one, at tile granularity. */
+USTRUCT(BlueprintType)
+struct FPerceptionChanges
+{
+	GENERATED_BODY()
+
+	/** Frame compared against; 0 if there was none (every tile counts as changed). */
+	UPROPERTY(BlueprintReadOnly)
+	int64 BaseFrame = 0;
+
+	/** Tile edge in capture pixels; 0 if changes weren't computed for this frame. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 TileSize = 0;
+
+	/** Tiles per row and column; the last ones may be clipped by the frame edge. */
+	UPROPERTY(BlueprintReadOnly)
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+
+	/** Captured frame size the tiles and regions refer to. */
+	UPROPERTY(BlueprintReadOnly)
+	FIntPoint FrameSize = FIntPoint::ZeroValue;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ChangedTiles = 0;
+
+	/** One bit per tile, row-major, least significant bit first. */
+	UPROPERTY()
+	TArray<uint8> Bitmap;
+
+	/** Bounding rectangles of connected changed tiles, in capture pixels. */
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FIntRect> Regions;
+
+	/** True if computed and no tile changed. */
+	UPROPERTY(BlueprintReadOnly)
+	bool bUnchanged = false;
+
+	bool IsTileChanged(int32 X, int32 Y) const
+	{
+		const int32 Index = Y * GridSize.X + X;
+		return (Bitmap[Index >> 3] >> (Index & 7)) & 1;
+	}
 };
 
 /** A complete perception packet: pixels + metadata. */
@@ -82,6 +242,10 @@ struct FPerceptionPacket
 	UPROPERTY(BlueprintReadOnly)
 	int32 Height = 0;
 
+	/** Part of the captured frame the image shows, in capture pixels; empty for the whole frame. */
+	UPROPERTY(BlueprintReadOnly)
+	FIntRect Region;
+
 	/** Format used for encoding. */
 	UPROPERTY(BlueprintReadOnly)
 	EPerceptionImageFormat Format = EPerceptionImageFormat::JPEG;
@@ -98,6 +262,20 @@ struct FPerceptionPacket
 	UPROPERTY(BlueprintReadOnly)
 	FPerceptionMetadata Metadata;
 
+	/** 64-bit difference hash of the captured frame (FPerceptionAdapter::ComputePerceptualHash),
+	 *  bit-cast to int64 for Blueprint. */
+	UPROPERTY(BlueprintReadOnly)
+	int64 PerceptualHash = 0;
+
+	/** Fraction of perceptual-hash bits that differ from the previously published frame:
+	 *  0 is the same picture, 1 if there was no previous frame. */
+	UPROPERTY(BlueprintReadOnly)
+	float SceneChange = 1.0f;
+
+	/** Tiles changed since the previous frame that was compared. */
+	UPROPERTY(BlueprintReadOnly)
+	FPerceptionChanges Changes;
+
 	/** True if this packet contains valid data. */
 	UPROPERTY(BlueprintReadOnly)
 	bool bValid = false;
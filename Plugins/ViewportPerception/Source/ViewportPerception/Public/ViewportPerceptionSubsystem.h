@@ -1,6 +1,8 @@
 // ViewportPerceptionSubsystem.h
 // UEditorSubsystem that orchestrates the viewport perception pipeline:
-// FrameProducer -> PixelBus -> MetadataCollector -> PerceptionAdapter -> PerceptionEndpoint
+// FrameProducer -> PixelBus -> MetadataCollector -> PerceptionEncoder (PerceptionAdapter) -> PerceptionEndpoint / PerceptionStream
+// Published packets can be recorded to disk (PerceptionRecorder) and a recording replayed
+// through the endpoint in place of the live viewport (PerceptionReplay).
 
 #pragma once
 
@@ -14,6 +16,10 @@
 #include "PixelBus.h"
 #include "MetadataCollector.h"
 #include "PerceptionEndpoint.h"
+#include "PerceptionEncoder.h"
+#include "PerceptionStream.h"
+#include "PerceptionReplay.h"
+#include "PerceptionPyramid.h"
 
 #include "ViewportPerceptionSubsystem.generated.h"
 
@@ -36,9 +42,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
 	void StopCapture();
 
+	/** Capture one frame onto the bus without starting continuous capture. Nothing is encoded
+	 *  for it beyond what the encoder stage does with every frame; use CaptureSingleFrame to
+	 *  wait for its packet. */
 	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
 	void RequestSingleFrame();
 
+	/** Capture one frame that starts rendering after this call and resolve with its packet,
+	 *  encoded with the current settings. Works whether or not capture is running; concurrent
+	 *  requests share the capture. Resolves on the game thread; the packet is invalid if the
+	 *  capture could not be taken. */
+	TFuture<FPerceptionPacket> CaptureSingleFrame();
+
 	// --- Configuration ---
 
 	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
@@ -53,10 +68,182 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
 	void SetJPEGQuality(int32 Quality);
 
+	/** Cap on task-graph workers used for resize and pixel conversion (1 = calling thread only).
+	 *  Keep it below the core count so the editor has cores left for itself. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetMaxPixelWorkers(int32 Workers);
+
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	int32 GetMaxPixelWorkers() const { return MaxPixelWorkers; }
+
+	/** Limit the pooled capture buffers: frame count (at least 4) and total memory in MB.
+	 *  Captures are dropped while every buffer is held by readers or the budget is spent. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetFramePoolLimits(int32 MaxFrames, int32 BudgetMB);
+
+	/** Compute image statistics (channel mean/variance, luma histogram, edge density, exposure)
+	 *  over each served image before it is encoded; reported in FPerceptionMetadata::ImageStats.
+	 *  Costs roughly one extra pass over the resized pixels. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetImageStatsEnabled(bool bEnable);
+
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool IsImageStatsEnabled() const { return bImageStats; }
+
+	/** Estimate block motion between consecutive analyzed frames: a coarse motion-vector field
+	 *  and the dominant camera translation/zoom, reported in FPerceptionMetadata::Motion.
+	 *  Works on a ~256 px wide luma plane, so cost is small and flat with resolution. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetMotionEnabled(bool bEnable);
+
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool IsMotionEnabled() const { return bMotion; }
+
+	/** Only publish frames whose scene-change score (perceptual-hash distance to the last
+	 *  published frame, 0 to 1) exceeds Threshold. Held-back frames are answered with the last
+	 *  published packet at the capture settings; other sizes, formats and regions always encode
+	 *  the latest frame, and frames taken by CaptureSingleFrame are never held back.
+	 *  0 publishes every frame; ~0.1 ignores TAA jitter and blinking cursors. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetMinSceneChange(float Threshold);
+
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	float GetMinSceneChange() const { return MinSceneChange; }
+
+	/** Mirror captured frames into a named shared-memory ring for readers on this host.
+	 *  Frames larger than MaxWidth x MaxHeight are downscaled into it. The mapping name and
+	 *  layout are reported by GetSharedMemoryInfo and /perception/status. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool SetSharedMemoryExport(bool bEnable, int32 MaxWidth = 1920, int32 MaxHeight = 1080, int32 Slots = 3);
+
+	/** Keep recently published packets for lookups by frame or time: up to Seconds of
+	 *  capture within BudgetMB of compressed images. Either 0 turns history off. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetHistoryLimits(float Seconds = 10.0f, int32 BudgetMB = 64);
+
+	/** Renditions served by level: level 0 is the captured frame at its own size, then Levels - 1
+	 *  successive halvings, then a thumbnail ThumbnailWidth wide (0 for none). All levels of a
+	 *  frame come from one cascaded pass, run only for level requests; each is encoded only when
+	 *  asked for (GetPyramidPacket). */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void SetPyramidLevels(int32 Levels = 3, int32 ThumbnailWidth = 160);
+
+	// --- Recording ---
+
+	/** Write every published packet, with its metadata, to a recording in Directory: size-rotated
+	 *  segment files plus a frame index (PerceptionRecorder.h). Writes happen on a worker thread.
+	 *  False if already recording or the directory can't be written or already holds a recording. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool StartRecording(const FString& Directory, int32 SegmentMB = 256);
+
+	/** Write out queued packets and close the recording. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void StopRecording();
+
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool IsRecording() const;
+
+	/** Serve the recording in Directory instead of the live viewport: the latest packet and the
+	 *  stream follow the recorded timing at Speed (0 holds the first frame), and history lookups
+	 *  by frame or time read from the recording. Live capture and encoding carry on underneath. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool StartReplay(const FString& Directory, float Speed = 1.0f);
+
+	/** Go back to serving the live viewport. */
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	void StopReplay();
+
+	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
+	bool IsReplaying() const;
+
 	// --- Reading ---
 
+	/** Latest frame resized and encoded with the current capture settings. */
 	FPerceptionPacket GetLatestPacket();
 
+	/** Latest frame resized and encoded with explicit settings. Quality is ignored for PNG.
+	 *  A non-empty Region (capture pixels) is cropped from the captured frame before the resize.
+	 *  Encoded packets are cached per (frame, resolution, format, quality, region), so repeat
+	 *  polls of the same frame are served without re-encoding. */
+	FPerceptionPacket GetLatestPacket(FIntPoint Resolution, EPerceptionImageFormat Format, int32 Quality,
+	                                  const FIntRect& Region = FIntRect());
+
+	/** Latest frame at pyramid level Level (clamped to the last one), encoded with the current
+	 *  format and quality. Level 0 is the frame at its own size. Replayed packets are served as
+	 *  recorded. */
+	FPerceptionPacket GetPyramidPacket(int32 Level);
+
+	/** Region of the latest frame at full capture detail: cropped from the captured frame, clipped
+	 *  to it, then scaled to OutputWidth keeping its aspect (0 or wider than the region: native
+	 *  size). Encoded with the current format and quality. Invalid while replaying, as recordings
+	 *  only hold the published image. */
+	FPerceptionPacket GetRegionPacket(const FIntRect& Region, int32 OutputWidth = 0);
+
+	/** Region of the latest frame around the selected actors' projected bounds as last collected
+	 *  (at most one metadata tick old), padded on every side. False if no selected actor is on screen. */
+	bool GetSelectionRegion(FIntRect& OutRegion) const;
+
+	/** Sizes of the pyramid levels of the latest frame, level 0 first. Empty if none was captured. */
+	TArray<FIntPoint> GetPyramidLevelSizes() const;
+
+	/** The smallest pyramid level at least Width wide, or 0 if none is. */
+	int32 FindPyramidLevel(int32 Width) const;
+
+	/** Pyramid layout and build counters. False if the pyramid doesn't exist. */
+	bool GetPyramidStats(FPerceptionPyramidStats& OutStats) const;
+
+	/** Frame number GetLatestPacket would return without encoding on the caller's thread:
+	 *  the encoder's latest packet, or the bus's latest frame if the encoder isn't running. */
+	int64 GetLatestPacketFrameNumber() const;
+
+	/** Tiles changed between SinceFrame and the latest frame, which is hashed first if it
+	 *  hasn't been yet (negative SinceFrame: since the frame before it). OutFrameNumber is the frame the changes run up to. False if no frame
+	 *  has been captured. */
+	bool GetChangesSince(int64 SinceFrame, FPerceptionChanges& OutChanges, int64& OutFrameNumber);
+
+	/** Published packet that was on screen at frame FrameNumber (the newest one at or before it).
+	 *  False if history is off or doesn't reach back that far. Reads the recording while replaying. */
+	bool GetHistoryPacket(int64 FrameNumber, FPerceptionPacket& OutPacket) const;
+
+	/** Published packet that was on screen at platform time Timestamp (FPlatformTime::Seconds,
+	 *  as in FPerceptionPacket::Timestamp). False if history is off or doesn't reach back that far.
+	 *  Reads the recording while replaying, by recorded time. */
+	bool GetHistoryPacketAt(double Timestamp, FPerceptionPacket& OutPacket) const;
+
+	/** The clock packet timestamps are on: platform seconds, or the recorded time under the
+	 *  playhead while replaying. */
+	double GetPacketClock() const;
+
+	/** History entries, oldest first, without their images. False if the encoder doesn't exist. */
+	bool GetHistoryEntries(TArray<FPerceptionHistoryEntryInfo>& OutEntries) const;
+
+	/** History occupancy and limits. False if the encoder doesn't exist. */
+	bool GetHistoryStats(FPerceptionHistoryStats& OutStats) const;
+
+	/** Packet cache hits and misses since startup. */
+	void GetPacketCacheStats(int64& OutHits, int64& OutMisses) const;
+
+	/** Capture buffer pool usage. False if the bus doesn't exist. */
+	bool GetFramePoolStats(FPerceptionFramePoolStats& OutStats) const;
+
+	/** Encoder stage counters and per-stage timing. False if the encoder isn't running. */
+	bool GetEncoderStats(FPerceptionEncoderStats& OutStats) const;
+
+	/** Recording progress. False if the encoder doesn't exist. */
+	bool GetRecorderStats(FPerceptionRecorderStats& OutStats) const;
+
+	/** Replay position. False if not replaying. */
+	bool GetReplayStats(FPerceptionReplayStats& OutStats) const;
+
+	/** Shared-memory mapping name and layout. False if the export is off. */
+	bool GetSharedMemoryInfo(FPerceptionSharedMemoryInfo& OutInfo) const;
+
+	/** True if the multipart stream listener is up. */
+	bool IsStreamAvailable() const { return Stream && Stream->IsRunning(); }
+
+	/** Stream client and throughput counters. False if streaming isn't available. */
+	bool GetStreamStats(FPerceptionStreamStats& OutStats) const;
+
 	UFUNCTION(BlueprintCallable, Category = "ViewportPerception")
 	bool IsCapturing() const;
 
@@ -68,19 +255,108 @@ public:
 private:
 	void OnTick(float DeltaTime);
 
+	/** Collect metadata for the bus's latest frame if it doesn't have any yet. */
+	void AttachMetadataToLatest();
+
+	/** Push the current capture settings to the encoder stage. */
+	void SyncEncoderSettings();
+
+	/** Replace a packet's metadata with the bus's, if it is still the latest frame. */
+	void RefreshMetadata(FPerceptionPacket& Packet) const;
+
+	/** GetLatestPacket. Without bServeHeldBack the latest frame is served even if MinSceneChange
+	 *  held it back, for callers that asked for that frame to be captured. bFromPyramid resizes
+	 *  from the frame's pyramid, building it if this is the first level request for the frame. */
+	FPerceptionPacket ReadLatestPacket(FIntPoint Resolution, EPerceptionImageFormat Format, int32 Quality,
+	                                   const FIntRect& Region, bool bServeHeldBack, bool bFromPyramid);
+
+	/** Size of the bus's latest frame, zero if none was captured. */
+	FIntPoint GetLatestFrameSize() const;
+
+	/** Identifies one encoded rendition of a frame */
+	struct FPacketCacheKey
+	{
+		int64 FrameNumber = 0;
+		FIntPoint Resolution = FIntPoint::ZeroValue;
+		EPerceptionImageFormat Format = EPerceptionImageFormat::JPEG;
+		int32 Quality = 0;
+
+		/** Crop in capture pixels; empty for the whole frame */
+		FIntRect Region;
+
+		bool operator==(const FPacketCacheKey& Other) const
+		{
+			return FrameNumber == Other.FrameNumber && IsSameRendition(Other);
+		}
+
+		bool IsSameRendition(const FPacketCacheKey& Other) const
+		{
+			return Resolution == Other.Resolution && Format == Other.Format && Quality == Other.Quality
+				&& Region == Other.Region;
+		}
+
+		friend uint32 GetTypeHash(const FPacketCacheKey& Key)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Key.FrameNumber), GetTypeHash(Key.Resolution));
+			Hash = HashCombine(Hash, HashCombine(GetTypeHash(static_cast<uint8>(Key.Format)), GetTypeHash(Key.Quality)));
+			return HashCombine(Hash, HashCombine(GetTypeHash(Key.Region.Min), GetTypeHash(Key.Region.Max)));
+		}
+	};
+
+	struct FPacketCacheEntry
+	{
+		FPacketCacheKey Key;
+		FPerceptionPacket Packet;
+	};
+
+	/** Cache miss: read, resize and encode the bus's latest frame as Key asks, outside the cache lock. */
+	FPerceptionPacket EncodeLatestPacket(FPacketCacheKey Key, bool bServeHeldBack, bool bFromPyramid);
+
 	TUniquePtr<FFrameProducer> Producer;
 	TUniquePtr<FPixelBus> Bus;
 	TUniquePtr<FMetadataCollector> Collector;
 	TUniquePtr<FPerceptionEndpoint> Endpoint;
+	TUniquePtr<FPerceptionEncoder> Encoder;
+	TUniquePtr<FPerceptionStream> Stream;
+	TSharedPtr<FPerceptionReplay, ESPMode::ThreadSafe> Replay;
+	TUniquePtr<FPerceptionPyramid> Pyramid;
 
 	// Config
 	FIntPoint CaptureResolution = FIntPoint(1280, 720);
 	EPerceptionImageFormat ImageFormat = EPerceptionImageFormat::JPEG;
 	int32 JPEGQuality = 85;
+	int32 MaxPixelWorkers = 4;
+	float MinSceneChange = 0.0f;
+	bool bImageStats = false;
+	bool bMotion = false;
+
+	/** Selection regions are widened by this fraction of their larger side, and at least
+	 *  MinSelectionPadding pixels, so the actor is seen with some surroundings. */
+	static constexpr float SelectionPadding = 0.15f;
+	static constexpr int32 MinSelectionPadding = 16;
+
+	/** Selection bounds from the last metadata collected, whether or not it reached a frame */
+	FBox2D LastSelectionBounds = FBox2D(ForceInit);
+	mutable FCriticalSection SelectionLock;
+
+	// Packet cache: most recently used entry last. Only the latest frame can hit,
+	// so entries for older frames are dropped once a newer frame is read (an
+	// unchanged newer frame first takes its image from them). Room for every
+	// pyramid level of a frame, plus a couple of explicit sizes.
+	static constexpr int32 PacketCacheCapacity = FPerceptionPyramid::MaxLevels + 3;
+	TArray<FPacketCacheEntry> PacketCache;
+
+	/** Encodes running outside the lock, by the key they were requested with; pollers of the
+	 *  same rendition wait on these instead of encoding it again */
+	TMap<FPacketCacheKey, TSharedFuture<FPerceptionPacket>> PacketsInFlight;
+
+	int64 PacketCacheHits = 0;
+	int64 PacketCacheMisses = 0;
+	mutable FCriticalSection PacketCacheLock;
 
 	// State
 	int64 LastSeenFrame = 0;
-	bool bSingleFrameRequested = false;
+	int64 LastMetadataFrame = 0;
 	bool bCapturing = false;
 
 	FTSTicker::FDelegateHandle TickDelegateHandle;
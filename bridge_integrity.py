@@ -0,0 +1,102 @@
+"""
+bridge_integrity.py
+
+Integrity footer for bridge USDA files, shared by usd_bridge.py and
+bridge_orchestrator.py. Pure Python with no pxr dependency, so files are
+sealed in JSON mode too; the xxhash package is used when installed.
+"""
+
+# Every USDA the bridge writes ends with one comment line the UE reader verifies:
+#   #bridge_integrity xxh64=<16 hex digits> size=<payload bytes>
+# The payload is every UTF-8 byte before that line. A missing or mismatched
+# footer tells UE it caught a partial write. Must match BridgeIntegrity.cpp.
+
+INTEGRITY_FOOTER_PREFIX = "#bridge_integrity "
+
+_XXH_P1 = 0x9E3779B185EBCA87
+_XXH_P2 = 0xC2B2AE3D27D4EB4F
+_XXH_P3 = 0x165667B19E3779F9
+_XXH_P4 = 0x85EBCA77C2B2AE63
+_XXH_P5 = 0x27D4EB2F165667C5
+_U64 = 0xFFFFFFFFFFFFFFFF
+
+try:
+    import xxhash as _xxhash_lib
+except ImportError:
+    _xxhash_lib = None
+
+
+def _rotl64(x: int, r: int) -> int:
+    return ((x << r) | (x >> (64 - r))) & _U64
+
+
+def _xxh64_round(acc: int, lane: int) -> int:
+    acc = (acc + lane * _XXH_P2) & _U64
+    return (_rotl64(acc, 31) * _XXH_P1) & _U64
+
+
+def _xxh64(data: bytes, seed: int = 0) -> int:
+    """XXH64 of data. Uses the xxhash package when installed, else pure Python."""
+    if _xxhash_lib is not None:
+        return _xxhash_lib.xxh64_intdigest(data, seed)
+
+    length = len(data)
+    pos = 0
+    if length >= 32:
+        v1 = (seed + _XXH_P1 + _XXH_P2) & _U64
+        v2 = (seed + _XXH_P2) & _U64
+        v3 = seed & _U64
+        v4 = (seed - _XXH_P1) & _U64
+        limit = length - 32
+        while pos <= limit:
+            v1 = _xxh64_round(v1, int.from_bytes(data[pos:pos + 8], "little"))
+            v2 = _xxh64_round(v2, int.from_bytes(data[pos + 8:pos + 16], "little"))
+            v3 = _xxh64_round(v3, int.from_bytes(data[pos + 16:pos + 24], "little"))
+            v4 = _xxh64_round(v4, int.from_bytes(data[pos + 24:pos + 32], "little"))
+            pos += 32
+        h = (_rotl64(v1, 1) + _rotl64(v2, 7) + _rotl64(v3, 12) + _rotl64(v4, 18)) & _U64
+        for v in (v1, v2, v3, v4):
+            h ^= _xxh64_round(0, v)
+            h = (h * _XXH_P1 + _XXH_P4) & _U64
+    else:
+        h = (seed + _XXH_P5) & _U64
+
+    h = (h + length) & _U64
+
+    while pos + 8 <= length:
+        h ^= _xxh64_round(0, int.from_bytes(data[pos:pos + 8], "little"))
+        h = (_rotl64(h, 27) * _XXH_P1 + _XXH_P4) & _U64
+        pos += 8
+    if pos + 4 <= length:
+        h ^= (int.from_bytes(data[pos:pos + 4], "little") * _XXH_P1) & _U64
+        h = (_rotl64(h, 23) * _XXH_P2 + _XXH_P3) & _U64
+        pos += 4
+    while pos < length:
+        h ^= (data[pos] * _XXH_P5) & _U64
+        h = (_rotl64(h, 11) * _XXH_P1) & _U64
+        pos += 1
+
+    h ^= h >> 33
+    h = (h * _XXH_P2) & _U64
+    h ^= h >> 29
+    h = (h * _XXH_P3) & _U64
+    h ^= h >> 32
+    return h
+
+
+def strip_integrity_footer(content: str) -> str:
+    """Return content without a trailing integrity footer line (if present)."""
+    body = content.rstrip("\r\n")
+    line_start = body.rfind("\n") + 1
+    if body.startswith(INTEGRITY_FOOTER_PREFIX, line_start):
+        return content[:line_start]
+    return content
+
+
+def add_integrity_footer(content: str) -> str:
+    """Replace any existing footer with one matching the current payload."""
+    payload = strip_integrity_footer(content)
+    if payload and not payload.endswith("\n"):
+        payload += "\n"
+    data = payload.encode("utf-8")
+    return f"{payload}{INTEGRITY_FOOTER_PREFIX}xxh64={_xxh64(data):016x} size={len(data)}\n"
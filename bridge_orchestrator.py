@@ -51,6 +51,9 @@ except ImportError:
     HAS_USD_BRIDGE = False
     print("[Bridge] USD bridge module not available, using JSON mode")
 
+# The integrity footer has no dependencies, so the profile is sealed in JSON mode too
+from bridge_integrity import add_integrity_footer
+
 # ============================================
 #  Configuration
 # ============================================
@@ -613,10 +616,13 @@ def Xform "CognitiveSubstrate" (
 }}
 '''
 
-    # Write file atomically
+    # Seal with the integrity footer UE verifies (see bridge_integrity.py)
+    usda_content = add_integrity_footer(usda_content)
+
+    # Write file atomically; newline="" keeps on-disk bytes identical to the hashed payload
     fd, tmp = tempfile.mkstemp(dir=str(PROFILE_FILE.parent), suffix=".tmp")
     try:
-        with os.fdopen(fd, "w", encoding="utf-8") as f:
+        with os.fdopen(fd, "w", encoding="utf-8", newline="") as f:
             f.write(usda_content)
         os.replace(tmp, str(PROFILE_FILE))
     except BaseException:
@@ -103,13 +103,27 @@ def _file_lock(file_path: Path, timeout: float = 5.0):
                 pass
 
 
+# ═══════════════════════════════════════════════════════════════════════════════
+# INTEGRITY FOOTER
+# ═══════════════════════════════════════════════════════════════════════════════
+# Every USDA written here is sealed with the footer UE verifies (bridge_integrity.py)
+
+from bridge_integrity import INTEGRITY_FOOTER_PREFIX, strip_integrity_footer, add_integrity_footer  # noqa: E402,F401
+
+
 def _atomic_write(file_path: Path, content: str) -> None:
-    """Write content to file atomically via tmp + os.replace (NTFS-safe), with file locking."""
+    """Write content to file atomically via tmp + os.replace (NTFS-safe), with file locking.
+
+    USDA content is sealed with an integrity footer; newline="" keeps the bytes
+    on disk identical to the hashed payload on Windows too.
+    """
+    if file_path.suffix == ".usda":
+        content = add_integrity_footer(content)
     parent = file_path.parent
     with _file_lock(file_path):
         fd, tmp_path = tempfile.mkstemp(dir=str(parent), suffix=".tmp", prefix=".bridge_")
         try:
-            with os.fdopen(fd, "w", encoding="utf-8") as f:
+            with os.fdopen(fd, "w", encoding="utf-8", newline="") as f:
                 f.write(content)
             os.replace(tmp_path, str(file_path))
         except BaseException:
@@ -121,6 +135,13 @@ def _atomic_write(file_path: Path, content: str) -> None:
             raise
 
 
+def _seal_file(file_path: Path) -> None:
+    """Re-seal a file written by another writer (pxr's stage.Save() drops the footer)."""
+    content = _safe_read(file_path)
+    if content is not None:
+        _atomic_write(file_path, content)
+
+
 def _safe_read(file_path: Path, retries: int = 3, delay: float = 0.05) -> Optional[str]:
     """Read file with retry on Windows file-lock errors."""
     import time
@@ -278,6 +299,7 @@ def _write_question_pxr(
             opt_prim.GetAttribute("semantic_tag").Set(opt.get("semantic_tag", ""))
 
     stage.Save()
+    _seal_file(file_path)
     return file_path
 
 
@@ -668,6 +690,7 @@ def _set_variant_pxr(file_path: Path, variant_set: str, variant: str) -> bool:
         if vsets.HasVariantSet(variant_set):
             vsets.GetVariantSet(variant_set).SetVariantSelection(variant)
             stage.Save()
+            _seal_file(file_path)
             return True
         return False
 
@@ -762,6 +785,7 @@ def _write_transition_pxr(
             trans_prim.GetAttribute("from_question_id").Set(from_question_id)
 
         stage.Save()
+        _seal_file(file_path)
         return True
 
     except Exception as e:
@@ -910,6 +934,7 @@ def _write_finale_pxr(
             finale_prim.GetAttribute("questions_answered").Set(questions_answered)
 
         stage.Save()
+        _seal_file(file_path)
         return True
 
     except Exception as e: